@@ -0,0 +1,84 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef QUERY_DEADLINE_H
+#define QUERY_DEADLINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Time budget per service in milliseconds, 0 for none
+typedef std::unordered_map<std::string, unsigned> QueryBudgets;
+
+// A request may only lower the budget of its service, a service without one takes the budget
+// of the request. Both are in milliseconds, 0 for none.
+inline unsigned GetQueryBudget(const QueryBudgets &query_budgets,
+                               const std::string &service,
+                               const unsigned requested_budget)
+{
+    const auto budget_iter = query_budgets.find(service);
+    if (query_budgets.end() == budget_iter || 0 == budget_iter->second)
+    {
+        return requested_budget;
+    }
+    return (0 == requested_budget) ? budget_iter->second
+                                   : std::min(requested_budget, budget_iter->second);
+}
+
+// Deadline and cancellation token of a single query. Copies share the cancellation flag, so
+// a query can be cancelled from another thread. Searches poll it every few settled nodes.
+class QueryDeadline
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    QueryDeadline()
+        : expiry(Clock::time_point::max()), cancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    // the budget starts now
+    void SetBudget(const std::chrono::milliseconds budget) { expiry = Clock::now() + budget; }
+
+    void Cancel() { cancelled->store(true); }
+
+    bool IsExpired() const
+    {
+        return cancelled->load(std::memory_order_relaxed) ||
+               (Clock::time_point::max() != expiry && Clock::now() >= expiry);
+    }
+
+  private:
+    Clock::time_point expiry;
+    std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+#endif // QUERY_DEADLINE_H
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ROUTE_PARAMETERS_H
 
 #include <osrm/Coordinate.h>
+#include <osrm/QueryDeadline.h>
 
 #include <boost/fusion/container/vector/vector_fwd.hpp>
 
@@ -43,8 +44,16 @@ struct RouteParameters
     
     void setNumberOfResults(const short number);
 
+    void setMaxTime(const unsigned time);
+
     void setAlternateRouteFlag(const bool flag);
 
+    void setAlternateRouteBudget(const unsigned milliseconds);
+
+    void setTimeBudget(const unsigned milliseconds);
+
+    void setDebugFlag(const bool flag);
+
     void setUTurn(const bool flag);
 
     void setAllUTurns(const bool flag);
@@ -71,6 +80,10 @@ struct RouteParameters
 
     void addCoordinate(const boost::fusion::vector<double, double> &coordinates);
 
+    void addSource(const boost::fusion::vector<double, double> &coordinates);
+
+    void addDestination(const boost::fusion::vector<double, double> &coordinates);
+
     short zoom_level;
     bool print_instructions;
     bool alternate_route;
@@ -78,8 +91,12 @@ struct RouteParameters
     bool compression;
     bool deprecatedAPI;
     bool uturn_default;
+    bool debug;
     unsigned check_sum;
     short num_results;
+    unsigned max_time;
+    unsigned alternate_route_budget;
+    unsigned time_budget;
     std::string service;
     std::string output_format;
     std::string jsonp_parameter;
@@ -87,6 +104,9 @@ struct RouteParameters
     std::vector<std::string> hints;
     std::vector<bool> uturns;
     std::vector<FixedPointCoordinate> coordinates;
+    std::vector<bool> is_source;
+    std::vector<bool> is_destination;
+    QueryDeadline deadline;
 };
 
 #endif // ROUTE_PARAMETERS_H
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef OSRM_H
 #define OSRM_H
 
+#include <osrm/QueryDeadline.h>
 #include <osrm/ServerPaths.h>
 
 #include <memory>
@@ -46,7 +47,9 @@ class OSRM
     std::unique_ptr<OSRM_impl> OSRM_pimpl_;
 
   public:
-    explicit OSRM(ServerPaths paths, const bool use_shared_memory = false);
+    explicit OSRM(ServerPaths paths,
+                  const bool use_shared_memory = false,
+                  const QueryBudgets &query_budgets = QueryBudgets());
     ~OSRM();
     void RunQuery(RouteParameters &route_parameters, http::Reply &reply);
 };
@@ -36,8 +36,10 @@ namespace boost { namespace interprocess { class named_mutex; } }
 
 #include "../plugins/distance_table.hpp"
 #include "../plugins/hello_world.hpp"
+#include "../plugins/isochrone.hpp"
 #include "../plugins/locate.hpp"
 #include "../plugins/nearest.hpp"
+#include "../plugins/statistics.hpp"
 #include "../plugins/timestamp.hpp"
 #include "../plugins/viaroute.hpp"
 #include "../Server/DataStructures/BaseDataFacade.h"
@@ -45,6 +47,7 @@ namespace boost { namespace interprocess { class named_mutex; } }
 #include "../Server/DataStructures/SharedBarriers.h"
 #include "../Server/DataStructures/SharedDataFacade.h"
 #include "../Util/make_unique.hpp"
+#include "../Util/osrm_exception.hpp"
 #include "../Util/ProgramOptions.h"
 #include "../Util/simple_logger.hpp"
 
@@ -53,31 +56,46 @@ namespace boost { namespace interprocess { class named_mutex; } }
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <utility>
 #include <vector>
 
-OSRM_impl::OSRM_impl(ServerPaths server_paths, const bool use_shared_memory)
+OSRM_impl::OSRM_impl(ServerPaths server_paths,
+                     const bool use_shared_memory,
+                     const QueryBudgets &query_budgets)
+    : query_budgets(query_budgets)
 {
     if (use_shared_memory)
     {
         barrier = osrm::make_unique<SharedBarriers>();
-        query_data_facade = new SharedDataFacade<QueryEdge::EdgeData>();
+        auto shared_data_facade = new SharedDataFacade<QueryEdge::EdgeData>();
+        query_data_facade = shared_data_facade;
+        RegisterPlugins(shared_data_facade);
     }
     else
     {
         // populate base path
         populate_base_path(server_paths);
-        query_data_facade = new InternalDataFacade<QueryEdge::EdgeData>(server_paths);
+        auto internal_data_facade = new InternalDataFacade<QueryEdge::EdgeData>(server_paths);
+        query_data_facade = internal_data_facade;
+        RegisterPlugins(internal_data_facade);
     }
+}
 
+// The plugins are instantiated on the concrete facade type. All facade methods are final,
+// so the graph accesses in the routing inner loops are not dispatched virtually.
+template <class DataFacadeT> void OSRM_impl::RegisterPlugins(DataFacadeT *facade)
+{
     // The following plugins handle all requests.
-    RegisterPlugin(new DistanceTablePlugin<BaseDataFacade<QueryEdge::EdgeData>>(query_data_facade));
+    RegisterPlugin(new DistanceTablePlugin<DataFacadeT>(facade, &shortcut_cache));
     RegisterPlugin(new HelloWorldPlugin());
-    RegisterPlugin(new LocatePlugin<BaseDataFacade<QueryEdge::EdgeData>>(query_data_facade));
-    RegisterPlugin(new NearestPlugin<BaseDataFacade<QueryEdge::EdgeData>>(query_data_facade));
-    RegisterPlugin(new TimestampPlugin<BaseDataFacade<QueryEdge::EdgeData>>(query_data_facade));
-    RegisterPlugin(new ViaRoutePlugin<BaseDataFacade<QueryEdge::EdgeData>>(query_data_facade));
+    RegisterPlugin(new IsochronePlugin<DataFacadeT>(facade, &shortcut_cache));
+    RegisterPlugin(new LocatePlugin<DataFacadeT>(facade));
+    RegisterPlugin(new NearestPlugin<DataFacadeT>(facade));
+    RegisterPlugin(new StatisticsPlugin(&query_histograms, &shortcut_cache));
+    RegisterPlugin(new TimestampPlugin<DataFacadeT>(facade));
+    RegisterPlugin(new ViaRoutePlugin<DataFacadeT>(facade, &shortcut_cache));
 }
 
 OSRM_impl::~OSRM_impl()
@@ -97,14 +115,34 @@ void OSRM_impl::RegisterPlugin(BasePlugin *plugin)
         delete plugin_map.find(plugin->GetDescriptor())->second;
     }
     plugin_map.emplace(plugin->GetDescriptor(), plugin);
+    query_histograms.AddService(plugin->GetDescriptor());
 }
 
 void OSRM_impl::RunQuery(RouteParameters &route_parameters, http::Reply &reply)
 {
     const PluginMap::const_iterator &iter = plugin_map.find(route_parameters.service);
 
-    if (plugin_map.end() != iter)
+    // every other service would take sources and destinations for plain locations
+    const bool has_sources_or_destinations =
+        std::find(route_parameters.is_source.begin(), route_parameters.is_source.end(), false) !=
+            route_parameters.is_source.end() ||
+        std::find(route_parameters.is_destination.begin(), route_parameters.is_destination.end(),
+                  false) != route_parameters.is_destination.end();
+
+    if (plugin_map.end() != iter && has_sources_or_destinations &&
+        !iter->second->SupportsSourcesAndDestinations())
     {
+        reply = http::Reply::StockReply(http::Reply::badRequest);
+    }
+    else if (plugin_map.end() != iter)
+    {
+        const unsigned time_budget =
+            GetQueryBudget(query_budgets, route_parameters.service, route_parameters.time_budget);
+        if (0 != time_budget)
+        {
+            route_parameters.deadline.SetBudget(std::chrono::milliseconds(time_budget));
+        }
+
         reply.status = http::Reply::ok;
         if (barrier)
         {
@@ -126,7 +164,17 @@ void OSRM_impl::RunQuery(RouteParameters &route_parameters, http::Reply &reply)
                 ->CheckAndReloadFacade();
         }
 
-        iter->second->HandleRequest(route_parameters, reply);
+        QueryStatistics::ThreadLocal() = QueryStatistics();
+        try
+        {
+            iter->second->HandleRequest(route_parameters, reply);
+        }
+        catch (const osrm::query_timeout &)
+        {
+            reply = http::Reply::StockReply(http::Reply::serviceUnavailable);
+        }
+        // timed out queries are counted as well, they are the ones worth looking into
+        query_histograms.Add(route_parameters.service, QueryStatistics::ThreadLocal());
         if (barrier)
         {
             // lock query
@@ -152,8 +200,8 @@ void OSRM_impl::RunQuery(RouteParameters &route_parameters, http::Reply &reply)
 
 // proxy code for compilation firewall
 
-OSRM::OSRM(ServerPaths paths, const bool use_shared_memory)
-    : OSRM_pimpl_(osrm::make_unique<OSRM_impl>(paths, use_shared_memory))
+OSRM::OSRM(ServerPaths paths, const bool use_shared_memory, const QueryBudgets &query_budgets)
+    : OSRM_pimpl_(osrm::make_unique<OSRM_impl>(paths, use_shared_memory, query_budgets))
 {
 }
 
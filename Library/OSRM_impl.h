@@ -32,9 +32,12 @@ class BasePlugin;
 namespace http { class Reply; }
 struct RouteParameters;
 
+#include <osrm/QueryDeadline.h>
 #include <osrm/ServerPaths.h>
 
 #include "../data_structures/query_edge.hpp"
+#include "../data_structures/query_histograms.hpp"
+#include "../data_structures/shortcut_cache.hpp"
 
 #include <memory>
 #include <unordered_map>
@@ -49,14 +52,19 @@ class OSRM_impl
     using PluginMap = std::unordered_map<std::string, BasePlugin *>;
 
   public:
-    OSRM_impl(ServerPaths paths, const bool use_shared_memory);
+    OSRM_impl(ServerPaths paths, const bool use_shared_memory, const QueryBudgets &query_budgets);
     OSRM_impl(const OSRM_impl &) = delete;
     virtual ~OSRM_impl();
     void RunQuery(RouteParameters &route_parameters, http::Reply &reply);
 
   private:
+    template <class DataFacadeT> void RegisterPlugins(DataFacadeT *facade);
     void RegisterPlugin(BasePlugin *plugin);
     PluginMap plugin_map;
+    QueryBudgets query_budgets;
+    QueryHistograms query_histograms;
+    // shared by the search engines of all plugins
+    ShortcutCache shortcut_cache;
     // will only be initialized if shared memory is used
     std::unique_ptr<SharedBarriers> barrier;
     // base class pointer to the objects
@@ -0,0 +1,653 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "APIParser.h"
+
+#include <osrm/RouteParameters.h>
+
+#include <boost/fusion/container/vector.hpp>
+
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+// Walks a URI and yields its characters with percent escapes decoded. The position counts
+// decoded characters.
+class Cursor
+{
+  public:
+    Cursor(const char *begin, const char *end) : current(begin), end(end), position(0) {}
+
+    bool AtEnd() const { return current == end; }
+
+    // must not be called at the end of the URI
+    char Peek() const
+    {
+        if (IsEscape())
+        {
+            return static_cast<char>(16 * DecodeHexDigit(current[1]) + DecodeHexDigit(current[2]));
+        }
+        return *current;
+    }
+
+    void Advance()
+    {
+        current += IsEscape() ? 3 : 1;
+        ++position;
+    }
+
+    bool Match(const char character)
+    {
+        if (AtEnd() || character != Peek())
+        {
+            return false;
+        }
+        Advance();
+        return true;
+    }
+
+    bool Match(const char *word)
+    {
+        Cursor lookahead = *this;
+        for (; '\0' != *word; ++word)
+        {
+            if (!lookahead.Match(*word))
+            {
+                return false;
+            }
+        }
+        *this = lookahead;
+        return true;
+    }
+
+    std::size_t GetPosition() const { return position; }
+
+  private:
+    bool IsEscape() const
+    {
+        return '%' == *current && end - current > 2 &&
+               std::isxdigit(static_cast<unsigned char>(current[1])) &&
+               std::isxdigit(static_cast<unsigned char>(current[2]));
+    }
+
+    static int DecodeHexDigit(const char digit)
+    {
+        return digit < 58 ? digit - 48 : digit < 71 ? digit - 55 : digit - 87;
+    }
+
+    const char *current;
+    const char *end;
+    std::size_t position;
+};
+
+enum class Parameter
+{
+    Zoom,
+    Output,
+    JSONp,
+    Checksum,
+    Location,
+    Source,
+    Destination,
+    Hint,
+    UTurn,
+    Compression,
+    Language,
+    Instructions,
+    Geometry,
+    AlternativeRoute,
+    AlternativeRouteBudget,
+    DeprecatedAPI,
+    NumberOfResults,
+    MaxTime,
+    TimeBudget,
+    Debug,
+    Unknown
+};
+
+struct ParameterName
+{
+    const char *name;
+    Parameter parameter;
+};
+
+const ParameterName PARAMETER_NAMES[] = {{"z", Parameter::Zoom},
+                                         {"output", Parameter::Output},
+                                         {"jsonp", Parameter::JSONp},
+                                         {"checksum", Parameter::Checksum},
+                                         {"loc", Parameter::Location},
+                                         {"src", Parameter::Source},
+                                         {"dst", Parameter::Destination},
+                                         {"hint", Parameter::Hint},
+                                         {"u", Parameter::UTurn},
+                                         {"compression", Parameter::Compression},
+                                         {"hl", Parameter::Language},
+                                         {"instructions", Parameter::Instructions},
+                                         {"geometry", Parameter::Geometry},
+                                         {"alt", Parameter::AlternativeRoute},
+                                         {"alt_budget", Parameter::AlternativeRouteBudget},
+                                         {"geomformat", Parameter::DeprecatedAPI},
+                                         {"num_results", Parameter::NumberOfResults},
+                                         {"max_time", Parameter::MaxTime},
+                                         {"budget", Parameter::TimeBudget},
+                                         {"debug", Parameter::Debug}};
+
+// no parameter name is longer
+constexpr std::size_t MAX_PARAMETER_NAME_LENGTH = 16;
+// no number that is parsed as a double is longer
+constexpr std::size_t MAX_NUMBER_LENGTH = 64;
+// all integers of up to 15 digits are exact doubles
+constexpr std::size_t MAX_SHORT_DECIMAL_DIGITS = 15;
+
+bool IsLetter(const char character)
+{
+    return ('a' <= character && character <= 'z') || ('A' <= character && character <= 'Z');
+}
+
+bool IsDigit(const char character) { return '0' <= character && character <= '9'; }
+
+bool IsHintCharacter(const char character)
+{
+    return IsLetter(character) || IsDigit(character) || '_' == character || '.' == character ||
+           '-' == character;
+}
+
+bool IsNumberCharacter(const char character)
+{
+    return IsDigit(character) || '.' == character || '-' == character || '+' == character ||
+           'e' == character || 'E' == character;
+}
+
+bool IsEscapeCharacter(const char character)
+{
+    return IsDigit(character) || ('A' <= character && character <= 'Z');
+}
+
+Parameter ParseParameterName(Cursor &cursor)
+{
+    char name[MAX_PARAMETER_NAME_LENGTH];
+    std::size_t length = 0;
+    while (!cursor.AtEnd() && '=' != cursor.Peek())
+    {
+        if (MAX_PARAMETER_NAME_LENGTH == length)
+        {
+            return Parameter::Unknown;
+        }
+        name[length++] = cursor.Peek();
+        cursor.Advance();
+    }
+    if (!cursor.Match('='))
+    {
+        return Parameter::Unknown;
+    }
+    for (const ParameterName &parameter_name : PARAMETER_NAMES)
+    {
+        if (length == std::strlen(parameter_name.name) &&
+            0 == std::memcmp(name, parameter_name.name, length))
+        {
+            return parameter_name.parameter;
+        }
+    }
+    return Parameter::Unknown;
+}
+
+// parses a non-empty string of valid characters into output, or skips it if output is null
+template <typename PredicateT>
+bool ParseString(Cursor &cursor, std::string *output, PredicateT &&is_valid)
+{
+    if (nullptr != output)
+    {
+        output->clear();
+    }
+    const auto begin = cursor.GetPosition();
+    while (!cursor.AtEnd() && is_valid(cursor.Peek()))
+    {
+        if (nullptr != output)
+        {
+            output->push_back(cursor.Peek());
+        }
+        cursor.Advance();
+    }
+    return begin != cursor.GetPosition();
+}
+
+// like a hint, but percent escapes that are left after decoding are taken over as they are
+bool ParseJSONpString(Cursor &cursor, std::string &output)
+{
+    output.clear();
+    while (!cursor.AtEnd())
+    {
+        const char character = cursor.Peek();
+        if (IsHintCharacter(character) || '[' == character || ']' == character)
+        {
+            output.push_back(character);
+            cursor.Advance();
+            continue;
+        }
+        if ('%' != character)
+        {
+            break;
+        }
+        Cursor lookahead = cursor;
+        lookahead.Advance();
+        if (lookahead.AtEnd() || !IsEscapeCharacter(lookahead.Peek()))
+        {
+            break;
+        }
+        const char first_digit = lookahead.Peek();
+        lookahead.Advance();
+        if (lookahead.AtEnd() || !IsEscapeCharacter(lookahead.Peek()))
+        {
+            break;
+        }
+        const char second_digit = lookahead.Peek();
+        lookahead.Advance();
+        output.push_back('%');
+        output.push_back(first_digit);
+        output.push_back(second_digit);
+        cursor = lookahead;
+    }
+    return !output.empty();
+}
+
+bool ParseBool(Cursor &cursor, bool &value)
+{
+    if (cursor.Match("true"))
+    {
+        value = true;
+        return true;
+    }
+    if (cursor.Match("false"))
+    {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool ParseUnsigned(Cursor &cursor, unsigned &value)
+{
+    std::uint64_t number = 0;
+    const auto begin = cursor.GetPosition();
+    while (!cursor.AtEnd() && IsDigit(cursor.Peek()))
+    {
+        number = 10 * number + (cursor.Peek() - '0');
+        if (number > std::numeric_limits<unsigned>::max())
+        {
+            return false;
+        }
+        cursor.Advance();
+    }
+    value = static_cast<unsigned>(number);
+    return begin != cursor.GetPosition();
+}
+
+bool ParseShort(Cursor &cursor, short &value)
+{
+    const bool is_negative = cursor.Match('-');
+    if (!is_negative)
+    {
+        cursor.Match('+');
+    }
+    const int max_number = is_negative ? -static_cast<int>(std::numeric_limits<short>::min())
+                                       : std::numeric_limits<short>::max();
+    int number = 0;
+    const auto begin = cursor.GetPosition();
+    while (!cursor.AtEnd() && IsDigit(cursor.Peek()))
+    {
+        number = 10 * number + (cursor.Peek() - '0');
+        if (number > max_number)
+        {
+            return false;
+        }
+        cursor.Advance();
+    }
+    value = static_cast<short>(is_negative ? -number : number);
+    return begin != cursor.GetPosition();
+}
+
+// Parses decimals of up to 15 digits without an exponent, like coordinates. Their digits and
+// the power of ten they are divided by are exact doubles, so the division rounds correctly.
+bool ParseShortDecimal(const char *number, const char *&number_end, double &value)
+{
+    static const double POWERS_OF_TEN[] = {1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                           1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char *current = number;
+    const bool is_negative = ('-' == *current);
+    if (is_negative || '+' == *current)
+    {
+        ++current;
+    }
+    std::uint64_t digits = 0;
+    std::size_t number_of_digits = 0, number_of_fraction_digits = 0;
+    for (; IsDigit(*current); ++current, ++number_of_digits)
+    {
+        digits = 10 * digits + (*current - '0');
+    }
+    if ('.' == *current)
+    {
+        for (++current; IsDigit(*current); ++current, ++number_of_fraction_digits)
+        {
+            digits = 10 * digits + (*current - '0');
+        }
+    }
+    number_of_digits += number_of_fraction_digits;
+    if (0 == number_of_digits || number_of_digits > MAX_SHORT_DECIMAL_DIGITS || 'e' == *current ||
+        'E' == *current)
+    {
+        return false;
+    }
+    value = static_cast<double>(digits) / POWERS_OF_TEN[number_of_fraction_digits];
+    value = is_negative ? -value : value;
+    number_end = current;
+    return true;
+}
+
+// The number is copied to the stack, where all numbers that are no short decimals are parsed by
+// strtod. Like any other value, the number ends where the longest valid prefix ends.
+bool ParseDouble(Cursor &cursor, double &value)
+{
+    char number[MAX_NUMBER_LENGTH + 1];
+    std::size_t length = 0;
+    Cursor lookahead = cursor;
+    while (!lookahead.AtEnd() && IsNumberCharacter(lookahead.Peek()))
+    {
+        if (MAX_NUMBER_LENGTH == length)
+        {
+            return false;
+        }
+        number[length++] = lookahead.Peek();
+        lookahead.Advance();
+    }
+    number[length] = '\0';
+    const char *number_end = nullptr;
+    if (!ParseShortDecimal(number, number_end, value))
+    {
+        char *strtod_end = nullptr;
+        value = std::strtod(number, &strtod_end);
+        number_end = strtod_end;
+    }
+    if (number == number_end || !std::isfinite(value))
+    {
+        return false;
+    }
+    for (const char *parsed = number; parsed != number_end; ++parsed)
+    {
+        cursor.Advance();
+    }
+    return true;
+}
+
+bool ParseCoordinate(Cursor &cursor, boost::fusion::vector<double, double> &coordinate)
+{
+    double latitude, longitude;
+    if (!ParseDouble(cursor, latitude) || !cursor.Match(',') || !ParseDouble(cursor, longitude))
+    {
+        return false;
+    }
+    coordinate = boost::fusion::vector<double, double>(latitude, longitude);
+    return true;
+}
+
+// String values are written to the route parameters directly and not through their setters,
+// so that they need no temporary string.
+bool ParseParameter(Cursor &cursor, RouteParameters &route_parameters)
+{
+    cursor.Match('&');
+    bool flag;
+    short short_number;
+    unsigned number;
+    boost::fusion::vector<double, double> coordinate;
+    switch (ParseParameterName(cursor))
+    {
+    case Parameter::Zoom:
+        if (!ParseShort(cursor, short_number))
+        {
+            return false;
+        }
+        route_parameters.setZoomLevel(short_number);
+        return true;
+    case Parameter::Output:
+        return ParseString(cursor, &route_parameters.output_format, IsLetter);
+    case Parameter::JSONp:
+        return ParseJSONpString(cursor, route_parameters.jsonp_parameter);
+    case Parameter::Checksum:
+        if (!ParseUnsigned(cursor, number))
+        {
+            return false;
+        }
+        route_parameters.setChecksum(number);
+        return true;
+    case Parameter::Location:
+        if (!ParseCoordinate(cursor, coordinate))
+        {
+            return false;
+        }
+        route_parameters.addCoordinate(coordinate);
+        return true;
+    case Parameter::Source:
+        if (!ParseCoordinate(cursor, coordinate))
+        {
+            return false;
+        }
+        route_parameters.addSource(coordinate);
+        return true;
+    case Parameter::Destination:
+        if (!ParseCoordinate(cursor, coordinate))
+        {
+            return false;
+        }
+        route_parameters.addDestination(coordinate);
+        return true;
+    case Parameter::Hint:
+        // a hint belongs to the last coordinate, hints before the first coordinate are dropped
+        route_parameters.hints.resize(route_parameters.coordinates.size());
+        return ParseString(cursor,
+                           route_parameters.hints.empty() ? nullptr
+                                                          : &route_parameters.hints.back(),
+                           IsHintCharacter);
+    case Parameter::UTurn:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setUTurn(flag);
+        return true;
+    case Parameter::Compression:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setCompressionFlag(flag);
+        return true;
+    case Parameter::Language:
+        return ParseString(cursor, &route_parameters.language, IsLetter);
+    case Parameter::Instructions:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setInstructionFlag(flag);
+        return true;
+    case Parameter::Geometry:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setGeometryFlag(flag);
+        return true;
+    case Parameter::AlternativeRoute:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setAlternateRouteFlag(flag);
+        return true;
+    case Parameter::AlternativeRouteBudget:
+        if (!ParseUnsigned(cursor, number))
+        {
+            return false;
+        }
+        route_parameters.setAlternateRouteBudget(number);
+        return true;
+    case Parameter::DeprecatedAPI:
+        // the value only has to be well-formed, any value selects the deprecated API
+        if (!ParseString(cursor, nullptr, IsLetter))
+        {
+            return false;
+        }
+        route_parameters.deprecatedAPI = true;
+        return true;
+    case Parameter::NumberOfResults:
+        if (!ParseShort(cursor, short_number))
+        {
+            return false;
+        }
+        route_parameters.setNumberOfResults(short_number);
+        return true;
+    case Parameter::MaxTime:
+        if (!ParseUnsigned(cursor, number))
+        {
+            return false;
+        }
+        route_parameters.setMaxTime(number);
+        return true;
+    case Parameter::TimeBudget:
+        if (!ParseUnsigned(cursor, number))
+        {
+            return false;
+        }
+        route_parameters.setTimeBudget(number);
+        return true;
+    case Parameter::Debug:
+        if (!ParseBool(cursor, flag))
+        {
+            return false;
+        }
+        route_parameters.setDebugFlag(flag);
+        return true;
+    case Parameter::Unknown:
+        break;
+    }
+    return false;
+}
+
+// uturns applies to all coordinates, so it may only be given once they are all known
+bool ParseAllUTurns(Cursor &cursor, RouteParameters &route_parameters)
+{
+    cursor.Match('&');
+    bool flag;
+    if (!cursor.Match("uturns=") || !ParseBool(cursor, flag))
+    {
+        return false;
+    }
+    route_parameters.setAllUTurns(flag);
+    return true;
+}
+}
+
+APIParser::APIParser(RouteParameters &route_parameters) : route_parameters(route_parameters) {}
+
+bool APIParser::Parse(const std::string &uri, std::size_t &position)
+{
+    ReserveParameters(uri);
+
+    Cursor cursor(uri.data(), uri.data() + uri.size());
+    if (!cursor.Match('/') || !ParseString(cursor, &route_parameters.service, IsLetter))
+    {
+        position = 0;
+        return false;
+    }
+
+    // the service is followed by queries that each start with '?' and hold one or more
+    // parameters, which may be separated by '&', and an optional uturns parameter at the end
+    Cursor last_valid_cursor = cursor;
+    bool is_in_query = false;
+    while (!cursor.AtEnd())
+    {
+        if (cursor.Match('?'))
+        {
+            is_in_query = true;
+        }
+        else if (!is_in_query)
+        {
+            break;
+        }
+        if (!ParseParameter(cursor, route_parameters))
+        {
+            break;
+        }
+        last_valid_cursor = cursor;
+    }
+    cursor = last_valid_cursor;
+    if (ParseAllUTurns(cursor, route_parameters))
+    {
+        last_valid_cursor = cursor;
+    }
+    position = last_valid_cursor.GetPosition();
+    return last_valid_cursor.AtEnd();
+}
+
+// Reserves room for the coordinates and hints of a request up front. Escaped parameter names
+// are not counted, but still parsed.
+void APIParser::ReserveParameters(const std::string &uri)
+{
+    const auto is_named = [&uri](const std::size_t name_end, const char *name)
+    {
+        const std::size_t length = std::strlen(name);
+        return name_end >= length && 0 == uri.compare(name_end - length, length, name);
+    };
+
+    std::size_t number_of_coordinates = 0, number_of_hints = 0;
+    for (auto position = uri.find('='); std::string::npos != position;
+         position = uri.find('=', position + 1))
+    {
+        if (is_named(position, "loc") || is_named(position, "src") || is_named(position, "dst"))
+        {
+            ++number_of_coordinates;
+        }
+        else if (is_named(position, "hint"))
+        {
+            ++number_of_hints;
+        }
+    }
+    route_parameters.coordinates.reserve(number_of_coordinates);
+    route_parameters.is_source.reserve(number_of_coordinates);
+    route_parameters.is_destination.reserve(number_of_coordinates);
+    if (0 < number_of_hints)
+    {
+        route_parameters.hints.reserve(number_of_coordinates);
+    }
+}
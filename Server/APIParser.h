@@ -0,0 +1,54 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef API_PARSER_H
+#define API_PARSER_H
+
+#include <string>
+
+struct RouteParameters;
+
+// Parses request URIs like /viaroute?loc=52.5,13.4&loc=52.6,13.5&z=14 into route parameters.
+// Percent escapes are decoded while the URI is read, so no decoded copy of it is made.
+class APIParser
+{
+  public:
+    explicit APIParser(RouteParameters &route_parameters);
+    APIParser(const APIParser &) = delete;
+
+    // Returns whether the whole URI could be parsed. If not, position is set to the offset into
+    // the decoded URI that parsing stopped at.
+    bool Parse(const std::string &uri, std::size_t &position);
+
+  private:
+    void ReserveParameters(const std::string &uri);
+
+    RouteParameters &route_parameters;
+};
+
+#endif // API_PARSER_H
@@ -0,0 +1,281 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "AccessLog.h"
+
+#include "../Util/make_unique.hpp"
+#include "../Util/simple_logger.hpp"
+#include "../Util/string_util.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+// bytes of log lines a thread can be ahead of the writer before it drops lines
+constexpr std::size_t RING_BUFFER_CAPACITY = 1 << 20;
+// longer lines are cut off, so that every line fits into a ring buffer many times over
+constexpr std::size_t MAX_LINE_LENGTH = 1 << 14;
+// how long the writer sleeps when it found nothing to write
+constexpr std::chrono::milliseconds WRITER_IDLE_INTERVAL(10);
+
+struct RecordHeader
+{
+    std::int64_t time;
+    std::uint32_t length;
+};
+}
+
+// A single producer, single consumer queue of length prefixed records. The producer only ever
+// advances the write position and the consumer only ever advances the read position, so
+// neither side needs a lock.
+class AccessLog::RingBuffer
+{
+  public:
+    RingBuffer()
+        : requests_since_last_line(0), buffer(RING_BUFFER_CAPACITY), write_position(0),
+          read_position(0), dropped_lines(0)
+    {
+        line.reserve(MAX_LINE_LENGTH);
+    }
+
+    // called by the owning thread only, drops the line if the writer fell behind
+    void Push(const std::time_t time)
+    {
+        const std::size_t length = std::min(line.size(), MAX_LINE_LENGTH);
+        const std::uint64_t head = write_position.load(std::memory_order_relaxed);
+        const std::uint64_t tail = read_position.load(std::memory_order_acquire);
+        if (RING_BUFFER_CAPACITY - (head - tail) < sizeof(RecordHeader) + length)
+        {
+            dropped_lines.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const RecordHeader header{static_cast<std::int64_t>(time),
+                                  static_cast<std::uint32_t>(length)};
+        CopyIn(head, reinterpret_cast<const char *>(&header), sizeof(RecordHeader));
+        CopyIn(head + sizeof(RecordHeader), line.data(), length);
+        write_position.store(head + sizeof(RecordHeader) + length, std::memory_order_release);
+    }
+
+    // called by the writer thread only, hands every pending line to output(time, begin, end)
+    template <typename OutputT> std::size_t Drain(OutputT &&output)
+    {
+        const std::uint64_t head = write_position.load(std::memory_order_acquire);
+        std::uint64_t tail = read_position.load(std::memory_order_relaxed);
+        std::size_t number_of_lines = 0;
+        while (tail != head)
+        {
+            RecordHeader header;
+            CopyOut(tail, reinterpret_cast<char *>(&header), sizeof(RecordHeader));
+            record.resize(header.length);
+            CopyOut(tail + sizeof(RecordHeader), record.data(), header.length);
+            output(static_cast<std::time_t>(header.time), record.data(),
+                   record.data() + header.length);
+            tail += sizeof(RecordHeader) + header.length;
+            ++number_of_lines;
+        }
+        read_position.store(tail, std::memory_order_release);
+        return number_of_lines;
+    }
+
+    std::uint64_t TakeDroppedLines() { return dropped_lines.exchange(0); }
+
+    // only touched by the owning thread
+    unsigned requests_since_last_line;
+    std::string line;
+    std::string decoded_request;
+
+  private:
+    void CopyIn(const std::uint64_t position, const char *data, const std::size_t length)
+    {
+        const std::size_t offset = position % RING_BUFFER_CAPACITY;
+        const std::size_t first_part = std::min(length, RING_BUFFER_CAPACITY - offset);
+        std::memcpy(buffer.data() + offset, data, first_part);
+        std::memcpy(buffer.data(), data + first_part, length - first_part);
+    }
+
+    void CopyOut(const std::uint64_t position, char *data, const std::size_t length) const
+    {
+        const std::size_t offset = position % RING_BUFFER_CAPACITY;
+        const std::size_t first_part = std::min(length, RING_BUFFER_CAPACITY - offset);
+        std::memcpy(data, buffer.data() + offset, first_part);
+        std::memcpy(data + first_part, buffer.data(), length - first_part);
+    }
+
+    std::vector<char> buffer;
+    // only touched by the writer thread
+    std::vector<char> record;
+    std::atomic<std::uint64_t> write_position;
+    // keeps the positions of producer and consumer on different cache lines
+    char padding[64];
+    std::atomic<std::uint64_t> read_position;
+    std::atomic<std::uint64_t> dropped_lines;
+};
+
+AccessLog::AccessLog(const unsigned sampling_interval)
+    : sampling_interval(sampling_interval), running(0 < sampling_interval),
+      local_ring_buffer(&AccessLog::KeepRingBuffer),
+      time_stamp_time(-1)
+{
+    if (running)
+    {
+        writer_thread = std::thread(&AccessLog::Run, this);
+    }
+}
+
+AccessLog::~AccessLog()
+{
+    running = false;
+    if (writer_thread.joinable())
+    {
+        writer_thread.join();
+    }
+}
+
+void AccessLog::Write(const boost::asio::ip::address &endpoint,
+                      const std::string &referrer,
+                      const std::string &agent,
+                      const std::string &request)
+{
+    if (0 == sampling_interval)
+    {
+        return;
+    }
+    RingBuffer &ring_buffer = GetLocalRingBuffer();
+    if (++ring_buffer.requests_since_last_line < sampling_interval)
+    {
+        return;
+    }
+    ring_buffer.requests_since_last_line = 0;
+
+    std::string &line = ring_buffer.line;
+    line = endpoint.to_string();
+    line += ' ';
+    line += referrer.empty() ? "-" : referrer;
+    line += ' ';
+    line += agent.empty() ? "-" : agent;
+    line += ' ';
+    // the log has always shown requests with their percent escapes decoded
+    URIDecode(request, ring_buffer.decoded_request);
+    line += ring_buffer.decoded_request;
+    ring_buffer.Push(std::time(nullptr));
+}
+
+AccessLog::RingBuffer &AccessLog::GetLocalRingBuffer()
+{
+    RingBuffer *ring_buffer = local_ring_buffer.get();
+    if (nullptr == ring_buffer)
+    {
+        std::lock_guard<std::mutex> lock(ring_buffers_mutex);
+        ring_buffers.emplace_back(osrm::make_unique<RingBuffer>());
+        ring_buffer = ring_buffers.back().get();
+        local_ring_buffer.reset(ring_buffer);
+    }
+    return *ring_buffer;
+}
+
+// the ring buffers are owned by the access log, not by the threads writing to them
+void AccessLog::KeepRingBuffer(RingBuffer *) {}
+
+void AccessLog::Run()
+{
+    while (running)
+    {
+        if (0 == DrainRingBuffers())
+        {
+            std::this_thread::sleep_for(WRITER_IDLE_INTERVAL);
+        }
+    }
+    DrainRingBuffers();
+}
+
+std::size_t AccessLog::DrainRingBuffers()
+{
+    batch.clear();
+    std::size_t number_of_lines = 0;
+    std::uint64_t dropped_lines = 0;
+    {
+        std::lock_guard<std::mutex> lock(ring_buffers_mutex);
+        for (const auto &ring_buffer : ring_buffers)
+        {
+            number_of_lines += ring_buffer->Drain(
+                [this](const std::time_t time, const char *begin, const char *end)
+                {
+                    batch += "[info] ";
+                    batch += GetTimeStamp(time);
+                    batch += ' ';
+                    batch.append(begin, end);
+                    batch += '\n';
+                });
+            dropped_lines += ring_buffer->TakeDroppedLines();
+        }
+    }
+
+    if (LogPolicy::GetInstance().IsMute())
+    {
+        return number_of_lines;
+    }
+    if (!batch.empty())
+    {
+        // other log lines go to stdout as well and must not end up inside the batch
+        std::lock_guard<std::mutex> lock(SimpleLogger::get_mutex());
+        std::cout.write(batch.data(), batch.size());
+        std::cout.flush();
+    }
+    if (0 < dropped_lines)
+    {
+        SimpleLogger().Write(logWARNING) << "access log fell behind, dropped " << dropped_lines
+                                         << " lines";
+    }
+    return number_of_lines;
+}
+
+const std::string &AccessLog::GetTimeStamp(const std::time_t time)
+{
+    // consecutive lines mostly share their second, so this formats about once a second
+    if (time != time_stamp_time)
+    {
+        struct tm local_time;
+#ifdef _WIN32
+        localtime_s(&local_time, &time);
+#else
+        localtime_r(&time, &local_time);
+#endif
+        char buffer[32];
+        const std::size_t length =
+            std::strftime(buffer, sizeof(buffer), "%d-%m-%Y %H:%M:%S", &local_time);
+        time_stamp.assign(buffer, length);
+        time_stamp_time = time;
+    }
+    return time_stamp;
+}
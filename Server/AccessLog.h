@@ -0,0 +1,80 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef ACCESS_LOG_H
+#define ACCESS_LOG_H
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <atomic>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes the access log without blocking the threads that serve requests. Every thread appends
+// its lines to a ring buffer of its own, which a background thread drains to stdout. Only every
+// sampling_interval-th request of a thread is logged, 0 turns the access log off.
+class AccessLog
+{
+  public:
+    explicit AccessLog(const unsigned sampling_interval);
+    ~AccessLog();
+    AccessLog(const AccessLog &) = delete;
+
+    void Write(const boost::asio::ip::address &endpoint,
+               const std::string &referrer,
+               const std::string &agent,
+               const std::string &request);
+
+  private:
+    class RingBuffer;
+
+    static void KeepRingBuffer(RingBuffer *);
+    RingBuffer &GetLocalRingBuffer();
+    void Run();
+    std::size_t DrainRingBuffers();
+    const std::string &GetTimeStamp(const std::time_t time);
+
+    const unsigned sampling_interval;
+    std::atomic<bool> running;
+    // only taken when a thread writes its first line or the ring buffers are drained
+    std::mutex ring_buffers_mutex;
+    std::vector<std::unique_ptr<RingBuffer>> ring_buffers;
+    boost::thread_specific_ptr<RingBuffer> local_ring_buffer;
+    // only touched by the writer thread
+    std::string batch;
+    std::time_t time_stamp_time;
+    std::string time_stamp;
+    std::thread writer_thread;
+};
+
+#endif // ACCESS_LOG_H
@@ -29,60 +29,214 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RequestHandler.h"
 #include "RequestParser.h"
 
+#include "../Util/osrm_exception.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 
 namespace http
 {
 
-Connection::Connection(boost::asio::io_service &io_service, RequestHandler &handler)
-    : strand(io_service), TCP_socket(io_service), request_handler(handler)
+namespace
+{
+// amount of reply content that is compressed into one chunk of a chunked reply
+const std::size_t COMPRESSION_CHUNK_SIZE = 128 * 1024;
+
+const char last_chunk[] = {'0', '\r', '\n', '\r', '\n'};
+
+// Setting up a deflate stream allocates and initializes its window and hash tables, so
+// streams are handed back after a reply and reset for the next one.
+class DeflateStreamPool
+{
+  public:
+    z_stream *Acquire(const CompressionType compression_type)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<z_stream *> &streams = GetStreams(compression_type);
+            if (!streams.empty())
+            {
+                z_stream *stream = streams.back();
+                streams.pop_back();
+                deflateReset(stream);
+                return stream;
+            }
+        }
+
+        z_stream *stream = new z_stream();
+        // HTTP's deflate coding is the zlib format of RFC 1950, gzip adds a gzip header and
+        // trailer instead. there's a trade-off between speed and size. speed wins
+        const int window_bits = (gzipRFC1952 == compression_type ? 16 + MAX_WBITS : MAX_WBITS);
+        if (Z_OK != deflateInit2(stream, Z_BEST_SPEED, Z_DEFLATED, window_bits, 8,
+                                 Z_DEFAULT_STRATEGY))
+        {
+            delete stream;
+            throw osrm::exception("could not initialize zlib stream");
+        }
+        return stream;
+    }
+
+    void Release(const CompressionType compression_type, z_stream *stream)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        GetStreams(compression_type).push_back(stream);
+    }
+
+  private:
+    std::vector<z_stream *> &GetStreams(const CompressionType compression_type)
+    {
+        return gzipRFC1952 == compression_type ? gzip_streams : deflate_streams;
+    }
+
+    std::mutex mutex;
+    std::vector<z_stream *> gzip_streams;
+    std::vector<z_stream *> deflate_streams;
+};
+
+DeflateStreamPool &GetDeflateStreamPool()
+{
+    static DeflateStreamPool pool;
+    return pool;
+}
+
+// Deflates the pending input of the stream into output, which is sized to the bound of the
+// compressed size up front and only grown if that does not suffice.
+void Deflate(z_stream &stream, const int flush, std::vector<char> &output)
+{
+    output.resize(deflateBound(&stream, stream.avail_in));
+    std::size_t output_size = 0;
+    while (true)
+    {
+        stream.next_out = reinterpret_cast<Bytef *>(output.data() + output_size);
+        stream.avail_out = static_cast<uInt>(output.size() - output_size);
+        const int status = deflate(&stream, flush);
+        if (Z_STREAM_ERROR == status)
+        {
+            throw osrm::exception("zlib stream error");
+        }
+        output_size = output.size() - stream.avail_out;
+        const bool done = (Z_FINISH == flush ? Z_STREAM_END == status : 0 != stream.avail_out);
+        if (done)
+        {
+            break;
+        }
+        output.resize(2 * output.size());
+    }
+    output.resize(output_size);
+}
+}
+
+Connection::Connection(boost::asio::io_service &io_service,
+                       RequestHandler &handler,
+                       const unsigned keep_alive_timeout,
+                       const unsigned max_keep_alive_requests,
+                       const bool use_strand)
+    : strand(io_service), TCP_socket(io_service), idle_timer(io_service),
+      request_handler(handler), pending_data_begin(nullptr), pending_data_end(nullptr),
+      compression_type(noCompression), deflate_stream(nullptr), compressed_content_size(0),
+      writing_chunk(0), keep_alive_timeout(keep_alive_timeout),
+      max_keep_alive_requests(max_keep_alive_requests), use_strand(use_strand),
+      handled_requests(0), keep_alive(false), idle_timer_generation(0)
+{
+}
+
+Connection::~Connection()
 {
+    if (nullptr != deflate_stream)
+    {
+        GetDeflateStreamPool().Release(compression_type, deflate_stream);
+    }
 }
 
 boost::asio::ip::tcp::socket &Connection::socket() { return TCP_socket; }
 
 /// Start the first asynchronous operation for the connection.
-void Connection::start()
+void Connection::start() { read_more_data(); }
+
+void Connection::read_more_data()
 {
-    TCP_socket.async_read_some(
-        boost::asio::buffer(incoming_data_buffer),
-        strand.wrap(boost::bind(&Connection::handle_read,
-                                this->shared_from_this(),
-                                boost::asio::placeholders::error,
-                                boost::asio::placeholders::bytes_transferred)));
+    ++idle_timer_generation;
+    if (0 < keep_alive_timeout)
+    {
+        idle_timer.expires_from_now(boost::posix_time::seconds(keep_alive_timeout));
+        auto timeout_handler = boost::bind(&Connection::handle_idle_timeout,
+                                           this->shared_from_this(),
+                                           boost::asio::placeholders::error,
+                                           idle_timer_generation);
+        if (use_strand)
+        {
+            idle_timer.async_wait(strand.wrap(timeout_handler));
+        }
+        else
+        {
+            idle_timer.async_wait(timeout_handler);
+        }
+    }
+
+    auto read_handler = boost::bind(&Connection::handle_read,
+                                    this->shared_from_this(),
+                                    boost::asio::placeholders::error,
+                                    boost::asio::placeholders::bytes_transferred);
+    if (use_strand)
+    {
+        TCP_socket.async_read_some(boost::asio::buffer(incoming_data_buffer),
+                                   strand.wrap(read_handler));
+    }
+    else
+    {
+        TCP_socket.async_read_some(boost::asio::buffer(incoming_data_buffer), read_handler);
+    }
 }
 
 void Connection::handle_read(const boost::system::error_code &error, std::size_t bytes_transferred)
 {
+    // a timeout that has already been queued must not close the connection any more
+    ++idle_timer_generation;
+    idle_timer.cancel();
     if (error)
     {
         return;
     }
 
     // no error detected, let's parse the request
-    CompressionType compression_type(noCompression);
+    process_data(incoming_data_buffer.data(), incoming_data_buffer.data() + bytes_transferred);
+}
+
+void Connection::process_data(char *begin, char *end)
+{
     boost::tribool result;
-    boost::tie(result, boost::tuples::ignore) =
-        RequestParser().Parse(request,
-                              incoming_data_buffer.data(),
-                              incoming_data_buffer.data() + bytes_transferred,
-                              compression_type);
+    char *parsed_end;
+    boost::tie(result, parsed_end) =
+        request_parser.Parse(request, begin, end, compression_type);
 
     // the request has been parsed
     if (result)
     {
-        request.endpoint = TCP_socket.remote_endpoint().address();
+        pending_data_begin = parsed_end;
+        pending_data_end = end;
+
+        boost::system::error_code endpoint_error;
+        const auto endpoint = TCP_socket.remote_endpoint(endpoint_error);
+        if (endpoint_error)
+        {
+            // the connection has been closed in the meantime
+            return;
+        }
+        request.endpoint = endpoint.address();
         request_handler.handle_request(request, reply);
 
-        // Header compression_header;
-        std::vector<char> compressed_output;
-        std::vector<boost::asio::const_buffer> output_buffer;
+        ++handled_requests;
+        keep_alive = request.keep_alive && 0 < keep_alive_timeout &&
+                     handled_requests < max_keep_alive_requests;
+        reply.headers.emplace_back("Connection", keep_alive ? "keep-alive" : "close");
 
         // compress the result w/ gzip/deflate if requested
         switch (compression_type)
@@ -90,85 +244,202 @@ void Connection::handle_read(const boost::system::error_code &error, std::size_t
         case deflateRFC1951:
             // use deflate for compression
             reply.headers.insert(reply.headers.begin(), {"Content-Encoding", "deflate"});
-            CompressBufferCollection(reply.content, compression_type, compressed_output);
-            reply.SetSize(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = reply.HeaderstoBuffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
             break;
         case gzipRFC1952:
             // use gzip for compression
             reply.headers.insert(reply.headers.begin(), {"Content-Encoding", "gzip"});
-            CompressBufferCollection(reply.content, compression_type, compressed_output);
-            reply.SetSize(static_cast<unsigned>(compressed_output.size()));
-            output_buffer = reply.HeaderstoBuffers();
-            output_buffer.push_back(boost::asio::buffer(compressed_output));
             break;
         case noCompression:
             // don't use any compression
             reply.SetUncompressedSize();
-            output_buffer = reply.ToBuffers();
-            break;
+            write_reply(reply.ToBuffers());
+            return;
+        }
+
+        // chunked transfer encoding is part of HTTP/1.1
+        const bool chunks_supported =
+            request.http_version_major > 1 ||
+            (1 == request.http_version_major && 0 < request.http_version_minor);
+        if (chunks_supported && reply.content.size() > COMPRESSION_CHUNK_SIZE)
+        {
+            write_chunked_reply();
+            return;
         }
+
+        CompressBufferCollection(reply.content, compression_type, compressed_output);
+        reply.SetSize(static_cast<unsigned>(compressed_output.size()));
+        std::vector<boost::asio::const_buffer> output_buffer = reply.HeaderstoBuffers();
+        output_buffer.push_back(boost::asio::buffer(compressed_output));
+
         // write result to stream
-        boost::asio::async_write(TCP_socket,
-                                 output_buffer,
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
+        write_reply(output_buffer);
     }
     else if (!result)
     { // request is not parseable
+        keep_alive = false;
         reply = Reply::StockReply(Reply::badRequest);
+        reply.headers.emplace_back("Connection", "close");
 
-        boost::asio::async_write(TCP_socket,
-                                 reply.ToBuffers(),
-                                 strand.wrap(boost::bind(&Connection::handle_write,
-                                                         this->shared_from_this(),
-                                                         boost::asio::placeholders::error)));
+        write_reply(reply.ToBuffers());
     }
     else
     {
         // we don't have a result yet, so continue reading
-        TCP_socket.async_read_some(
-            boost::asio::buffer(incoming_data_buffer),
-            strand.wrap(boost::bind(&Connection::handle_read,
-                                    this->shared_from_this(),
-                                    boost::asio::placeholders::error,
-                                    boost::asio::placeholders::bytes_transferred)));
+        read_more_data();
+    }
+}
+
+void Connection::write_reply(const std::vector<boost::asio::const_buffer> &output_buffer)
+{
+    auto write_handler = boost::bind(&Connection::handle_write,
+                                     this->shared_from_this(),
+                                     boost::asio::placeholders::error);
+    if (use_strand)
+    {
+        boost::asio::async_write(TCP_socket, output_buffer, strand.wrap(write_handler));
+    }
+    else
+    {
+        boost::asio::async_write(TCP_socket, output_buffer, write_handler);
+    }
+}
+
+void Connection::write_chunked_reply()
+{
+    // the length of the compressed content is not known before its last chunk is compressed
+    reply.headers.erase(std::remove_if(reply.headers.begin(), reply.headers.end(),
+                                       [](const Header &header)
+                                       {
+                                           return "Content-Length" == header.name;
+                                       }),
+                        reply.headers.end());
+    reply.headers.emplace_back("Transfer-Encoding", "chunked");
+
+    deflate_stream = GetDeflateStreamPool().Acquire(compression_type);
+    compressed_content_size = 0;
+    compress_chunk(chunks[0]);
+    write_chunk(0, reply.HeaderstoBuffers());
+}
+
+void Connection::compress_chunk(CompressedChunk &chunk)
+{
+    const std::size_t input_size =
+        std::min(COMPRESSION_CHUNK_SIZE, reply.content.size() - compressed_content_size);
+    deflate_stream->next_in = reinterpret_cast<Bytef *>(&reply.content[compressed_content_size]);
+    deflate_stream->avail_in = static_cast<uInt>(input_size);
+    compressed_content_size += input_size;
+    chunk.is_last = (compressed_content_size == reply.content.size());
+
+    // flushing guarantees that every chunk has content, an empty chunk would end the reply
+    Deflate(*deflate_stream, chunk.is_last ? Z_FINISH : Z_SYNC_FLUSH, chunk.data);
+
+    std::ostringstream size_line;
+    size_line << std::hex << chunk.data.size() << "\r\n";
+    chunk.size_line = size_line.str();
+}
+
+void Connection::write_chunk(const unsigned chunk_index,
+                             std::vector<boost::asio::const_buffer> output_buffer)
+{
+    const CompressedChunk &chunk = chunks[chunk_index];
+    output_buffer.push_back(boost::asio::buffer(chunk.size_line));
+    output_buffer.push_back(boost::asio::buffer(chunk.data));
+    output_buffer.push_back(boost::asio::buffer(crlf));
+    if (chunk.is_last)
+    {
+        output_buffer.push_back(boost::asio::buffer(last_chunk));
+    }
+
+    writing_chunk = chunk_index;
+    auto chunk_handler = boost::bind(&Connection::handle_chunk_write,
+                                     this->shared_from_this(),
+                                     boost::asio::placeholders::error);
+    if (use_strand)
+    {
+        boost::asio::async_write(TCP_socket, output_buffer, strand.wrap(chunk_handler));
+    }
+    else
+    {
+        boost::asio::async_write(TCP_socket, output_buffer, chunk_handler);
+    }
+
+    // compress the next chunk while this one is sent
+    if (!chunk.is_last)
+    {
+        compress_chunk(chunks[1 - chunk_index]);
+    }
+}
+
+void Connection::handle_chunk_write(const boost::system::error_code &error)
+{
+    if (error || chunks[writing_chunk].is_last)
+    {
+        GetDeflateStreamPool().Release(compression_type, deflate_stream);
+        deflate_stream = nullptr;
+        handle_write(error);
+        return;
     }
+    write_chunk(1 - writing_chunk, std::vector<boost::asio::const_buffer>());
 }
 
 /// Handle completion of a write operation.
 void Connection::handle_write(const boost::system::error_code &error)
 {
-    if (!error)
+    if (error)
+    {
+        return;
+    }
+
+    if (!keep_alive)
     {
         // Initiate graceful connection closure.
         boost::system::error_code ignore_error;
         TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+        return;
+    }
+
+    // get ready for the next request on this connection
+    request_parser.Reset();
+    compression_type = noCompression;
+    request = Request();
+    reply = Reply();
+    compressed_output.clear();
+
+    // pipelined requests that arrived with the previous one are answered before reading again
+    if (pending_data_begin != pending_data_end)
+    {
+        process_data(pending_data_begin, pending_data_end);
+    }
+    else
+    {
+        read_more_data();
     }
 }
 
-void Connection::CompressBufferCollection(std::vector<char> uncompressed_data,
-                                          CompressionType compression_type,
-                                          std::vector<char> &compressed_data)
+void Connection::handle_idle_timeout(const boost::system::error_code &error,
+                                     const unsigned generation)
 {
-    boost::iostreams::gzip_params compression_parameters;
-
-    // there's a trade-off between speed and size. speed wins
-    compression_parameters.level = boost::iostreams::zlib::best_speed;
-    // check which compression flavor is used
-    if (deflateRFC1951 == compression_type)
+    // The timeout may have been queued just before data arrived, in which case handle_read has
+    // run or the timer has been re-armed since. Only a connection that still waits for the
+    // read the timer was armed for is idle.
+    if (error == boost::asio::error::operation_aborted || generation != idle_timer_generation)
     {
-        compression_parameters.noheader = true;
+        return;
     }
 
-    BOOST_ASSERT(compressed_data.empty());
-    // plug data into boost's compression stream
-    boost::iostreams::filtering_ostream gzip_stream;
-    gzip_stream.push(boost::iostreams::gzip_compressor(compression_parameters));
-    gzip_stream.push(boost::iostreams::back_inserter(compressed_data));
-    gzip_stream.write(&uncompressed_data[0], uncompressed_data.size());
-    boost::iostreams::close(gzip_stream);
+    boost::system::error_code ignore_error;
+    TCP_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignore_error);
+    TCP_socket.close(ignore_error);
+}
+
+void Connection::CompressBufferCollection(const std::vector<char> &uncompressed_data,
+                                          CompressionType compression_type,
+                                          std::vector<char> &compressed_data)
+{
+    z_stream *stream = GetDeflateStreamPool().Acquire(compression_type);
+    stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(uncompressed_data.data()));
+    stream->avail_in = static_cast<uInt>(uncompressed_data.size());
+    Deflate(*stream, Z_FINISH, compressed_data);
+    GetDeflateStreamPool().Release(compression_type, stream);
 }
 }
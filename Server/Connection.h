@@ -28,7 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CONNECTION_H
 #define CONNECTION_H
 
-// #include "RequestParser.h"
+#include "RequestParser.h"
 #include "Http/CompressionType.h"
 #include "Http/Request.h"
 
@@ -39,7 +39,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/config.hpp>
 #include <boost/version.hpp>
 
+ #include <array>
  #include <memory>
+ #include <string>
  #include <vector>
 
 //workaround for incomplete std::shared_ptr compatibility in old boost versions
@@ -64,17 +66,27 @@ T* get_pointer(std::shared_ptr<T>& p)
 
 
 class RequestHandler;
+struct z_stream_s;
 
 namespace http
 {
 
-/// Represents a single connection from a client.
+/// Represents a single connection from a client. The connection is kept open for further
+/// requests if the client asks for it, until it idles for keep_alive_timeout seconds or has
+/// served max_keep_alive_requests requests. A keep_alive_timeout of 0 disables keep-alive.
+/// Completion handlers only go through a strand if use_strand is set, which connections of
+/// an io_service that is run by a single thread can do without.
 class Connection : public std::enable_shared_from_this<Connection>
 {
   public:
-    explicit Connection(boost::asio::io_service &io_service, RequestHandler &handler);
+    explicit Connection(boost::asio::io_service &io_service,
+                        RequestHandler &handler,
+                        const unsigned keep_alive_timeout,
+                        const unsigned max_keep_alive_requests,
+                        const bool use_strand);
     Connection(const Connection &) = delete;
     Connection() = delete;
+    ~Connection();
 
     boost::asio::ip::tcp::socket &socket();
 
@@ -82,21 +94,67 @@ class Connection : public std::enable_shared_from_this<Connection>
     void start();
 
   private:
+    void read_more_data();
+
     void handle_read(const boost::system::error_code &e, std::size_t bytes_transferred);
 
+    /// Parse the data in [begin, end) and answer the request once it is complete.
+    void process_data(char *begin, char *end);
+
+    void write_reply(const std::vector<boost::asio::const_buffer> &output_buffer);
+
+    /// Compress and send the reply content in chunks, the next chunk is compressed while the
+    /// previous one is being sent.
+    void write_chunked_reply();
+
+    void write_chunk(const unsigned chunk_index,
+                     std::vector<boost::asio::const_buffer> output_buffer);
+
+    void handle_chunk_write(const boost::system::error_code &e);
+
     /// Handle completion of a write operation.
     void handle_write(const boost::system::error_code &e);
 
-    void CompressBufferCollection(std::vector<char> uncompressed_data,
+    void handle_idle_timeout(const boost::system::error_code &e, const unsigned generation);
+
+    void CompressBufferCollection(const std::vector<char> &uncompressed_data,
                                   CompressionType compression_type,
                                   std::vector<char> &compressed_data);
 
+    struct CompressedChunk
+    {
+        std::string size_line;
+        std::vector<char> data;
+        bool is_last;
+    };
+
+    void compress_chunk(CompressedChunk &chunk);
+
     boost::asio::io_service::strand strand;
     boost::asio::ip::tcp::socket TCP_socket;
+    boost::asio::deadline_timer idle_timer;
     RequestHandler &request_handler;
     boost::array<char, 8192> incoming_data_buffer;
+    // pipelined data behind the current request that has not been parsed yet
+    char *pending_data_begin;
+    char *pending_data_end;
+    RequestParser request_parser;
+    CompressionType compression_type;
     Request request;
     Reply reply;
+    std::vector<char> compressed_output;
+    // state of a chunked reply
+    z_stream_s *deflate_stream;
+    std::size_t compressed_content_size;
+    std::array<CompressedChunk, 2> chunks;
+    unsigned writing_chunk;
+    const unsigned keep_alive_timeout;
+    const unsigned max_keep_alive_requests;
+    const bool use_strand;
+    unsigned handled_requests;
+    bool keep_alive;
+    // counts the reads the idle timer was armed for, a timeout only counts for the current one
+    unsigned idle_timer_generation;
 };
 
 } // namespace http
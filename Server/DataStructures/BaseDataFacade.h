@@ -62,9 +62,7 @@ template <class EdgeDataT> class BaseDataFacade
 
     virtual NodeID GetTarget(const EdgeID e) const = 0;
 
-    // virtual EdgeDataT &GetEdgeData(const EdgeID e) = 0;
-
-    virtual const EdgeDataT &GetEdgeData(const EdgeID e) const = 0;
+    virtual EdgeDataT GetEdgeData(const EdgeID e) const = 0;
 
     virtual EdgeID BeginEdges(const NodeID n) const = 0;
 
@@ -80,6 +78,11 @@ template <class EdgeDataT> class BaseDataFacade
     virtual EdgeID
     FindEdgeIndicateIfReverse(const NodeID from, const NodeID to, bool &result) const = 0;
 
+    // nodes of the search graph by descending contraction level, empty without a .level file
+    virtual unsigned GetNumberOfLevelOrderedNodes() const = 0;
+
+    virtual NodeID GetLevelOrderedNode(const unsigned position) const = 0;
+
     // node and edge information access
     virtual FixedPointCoordinate GetCoordinateOfNode(const unsigned id) const = 0;
 
@@ -107,6 +110,12 @@ template <class EdgeDataT> class BaseDataFacade
     IncrementalFindPhantomNodeForCoordinate(const FixedPointCoordinate &input_coordinate,
                                             PhantomNode &resulting_phantom_node) = 0;
 
+    // looks up the phantom nodes of all coordinates, the i-th result belongs to the i-th coordinate
+    virtual void IncrementalFindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> &input_coordinates,
+        std::vector<std::vector<PhantomNode>> &resulting_phantom_node_vectors,
+        const unsigned number_of_results) = 0;
+
     virtual unsigned GetCheckSum() const = 0;
 
     virtual unsigned GetNameIndexFromEdgeID(const unsigned id) const = 0;
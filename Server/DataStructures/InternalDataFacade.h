@@ -36,23 +36,25 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../data_structures/query_node.hpp"
 #include "../../data_structures/query_edge.hpp"
 #include "../../data_structures/shared_memory_vector_wrapper.hpp"
-#include "../../data_structures/static_graph.hpp"
+#include "../../data_structures/static_query_graph.hpp"
 #include "../../data_structures/static_rtree.hpp"
 #include "../../data_structures/range_table.hpp"
 #include "../../Util/BoostFileSystemFix.h"
 #include "../../Util/graph_loader.hpp"
+#include "../../Util/make_unique.hpp"
 #include "../../Util/simple_logger.hpp"
 
 #include <osrm/Coordinate.h>
 #include <osrm/ServerPaths.h>
 
+#include <memory>
+
 template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<EdgeDataT>
 {
 
   private:
     typedef BaseDataFacade<EdgeDataT> super;
-    typedef StaticGraph<typename super::EdgeData> QueryGraph;
-    typedef typename QueryGraph::InputEdge InputEdge;
+    typedef StaticQueryGraph<false> QueryGraph;
     typedef typename super::RTreeLeaf RTreeLeaf;
 
     InternalDataFacade() {}
@@ -71,9 +73,10 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
     ShM<bool, false>::vector m_edge_is_compressed;
     ShM<unsigned, false>::vector m_geometry_indices;
     ShM<unsigned, false>::vector m_geometry_list;
+    ShM<NodeID, false>::vector m_level_order;
 
-    boost::thread_specific_ptr<
-        StaticRTree<RTreeLeaf, ShM<FixedPointCoordinate, false>::vector, false>> m_static_rtree;
+    std::unique_ptr<StaticRTree<RTreeLeaf, ShM<FixedPointCoordinate, false>::vector, false>>
+        m_static_rtree;
     boost::filesystem::path ram_index_path;
     boost::filesystem::path file_index_path;
     RangeTable<16, false> m_name_table;
@@ -105,19 +108,32 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
     {
         typename ShM<typename QueryGraph::NodeArrayEntry, false>::vector node_list;
         typename ShM<typename QueryGraph::EdgeArrayEntry, false>::vector edge_list;
+        typename ShM<typename QueryGraph::EdgeIDArrayEntry, false>::vector edge_id_list;
 
         SimpleLogger().Write() << "loading graph from " << hsgr_path.string();
 
-        m_number_of_nodes = readHSGRFromStream(hsgr_path, node_list, edge_list, &m_check_sum);
+        {
+            std::vector<typename QueryGraph::InputEdgeArrayEntry> input_edge_list;
+            m_number_of_nodes =
+                readHSGRFromStream(hsgr_path, node_list, input_edge_list, &m_check_sum);
+            edge_list.reserve(input_edge_list.size());
+            edge_id_list.reserve(input_edge_list.size());
+            for (const auto &input_edge : input_edge_list)
+            {
+                edge_list.emplace_back(input_edge);
+                edge_id_list.emplace_back(input_edge);
+            }
+        }
 
         BOOST_ASSERT_MSG(0 != node_list.size(), "node list empty");
         // BOOST_ASSERT_MSG(0 != edge_list.size(), "edge list empty");
         SimpleLogger().Write() << "loaded " << node_list.size() << " nodes and " << edge_list.size()
                                << " edges";
-        m_query_graph = new QueryGraph(node_list, edge_list);
+        m_query_graph = new QueryGraph(node_list, edge_list, edge_id_list);
 
         BOOST_ASSERT_MSG(0 == node_list.size(), "node list not flushed");
         BOOST_ASSERT_MSG(0 == edge_list.size(), "edge list not flushed");
+        BOOST_ASSERT_MSG(0 == edge_id_list.size(), "edge id list not flushed");
         SimpleLogger().Write() << "Data checksum is " << m_check_sum;
     }
 
@@ -197,12 +213,37 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
         geometry_stream.close();
     }
 
+    void LoadLevelOrder(const boost::filesystem::path &level_order_file)
+    {
+        if (level_order_file.empty() || !boost::filesystem::exists(level_order_file))
+        {
+            SimpleLogger().Write(logWARNING) << "level order file " << level_order_file
+                                             << " not found, one-to-all queries are disabled";
+            return;
+        }
+        boost::filesystem::ifstream level_order_stream(level_order_file, std::ios::binary);
+        unsigned number_of_nodes = 0;
+        level_order_stream.read((char *)&number_of_nodes, sizeof(unsigned));
+        if (number_of_nodes != m_query_graph->GetNumberOfNodes())
+        {
+            SimpleLogger().Write(logWARNING) << level_order_file
+                                             << " does not match the graph, ignoring it";
+            return;
+        }
+        m_level_order.resize(number_of_nodes);
+        if (number_of_nodes > 0)
+        {
+            level_order_stream.read((char *)&(m_level_order[0]), number_of_nodes * sizeof(NodeID));
+        }
+        level_order_stream.close();
+    }
+
     void LoadRTree()
     {
         BOOST_ASSERT_MSG(!m_coordinate_list->empty(), "coordinates must be loaded before r-tree");
 
-        m_static_rtree.reset(
-            new StaticRTree<RTreeLeaf>(ram_index_path, file_index_path, m_coordinate_list));
+        m_static_rtree = osrm::make_unique<StaticRTree<RTreeLeaf>>(ram_index_path, file_index_path,
+                                                                    m_coordinate_list);
     }
 
     void LoadStreetNames(const boost::filesystem::path &names_file)
@@ -227,7 +268,6 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
     virtual ~InternalDataFacade()
     {
         delete m_query_graph;
-        m_static_rtree.reset();
     }
 
     explicit InternalDataFacade(const ServerPaths &server_paths)
@@ -286,6 +326,10 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
         paths_iterator = server_paths.find("geometries");
         BOOST_ASSERT(server_paths.end() != paths_iterator);
         const boost::filesystem::path &geometries_path = paths_iterator->second;
+        paths_iterator = server_paths.find("levelorder");
+        const boost::filesystem::path level_order_path =
+            (server_paths.end() != paths_iterator ? paths_iterator->second
+                                                  : boost::filesystem::path());
 
         // load data
         SimpleLogger().Write() << "loading graph data";
@@ -295,12 +339,15 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
         AssertPathExists(nodes_data_path);
         AssertPathExists(edges_data_path);
         LoadNodeAndEdgeInformation(nodes_data_path, edges_data_path);
+        SimpleLogger().Write() << "loading level order";
+        LoadLevelOrder(level_order_path);
         SimpleLogger().Write() << "loading geometries";
         AssertPathExists(geometries_path);
         LoadGeometries(geometries_path);
         SimpleLogger().Write() << "loading r-tree";
         AssertPathExists(ram_index_path);
         AssertPathExists(file_index_path);
+        LoadRTree();
         SimpleLogger().Write() << "loading timestamp";
         LoadTimestamp(timestamp_path);
         SimpleLogger().Write() << "loading street names";
@@ -317,9 +364,7 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
 
     NodeID GetTarget(const EdgeID e) const final { return m_query_graph->GetTarget(e); }
 
-    // EdgeDataT &GetEdgeData(const EdgeID e) final { return m_query_graph->GetEdgeData(e); }
-
-    EdgeDataT &GetEdgeData(const EdgeID e) const final { return m_query_graph->GetEdgeData(e); }
+    EdgeDataT GetEdgeData(const EdgeID e) const final { return m_query_graph->GetEdgeData(e); }
 
     EdgeID BeginEdges(const NodeID n) const final { return m_query_graph->BeginEdges(n); }
 
@@ -346,6 +391,16 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
         return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
     }
 
+    unsigned GetNumberOfLevelOrderedNodes() const final
+    {
+        return static_cast<unsigned>(m_level_order.size());
+    }
+
+    NodeID GetLevelOrderedNode(const unsigned position) const final
+    {
+        return m_level_order[position];
+    }
+
     // node and edge information access
     FixedPointCoordinate GetCoordinateOfNode(const unsigned id) const final
     {
@@ -368,11 +423,6 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
                                             FixedPointCoordinate &result,
                                             const unsigned zoom_level = 18) final
     {
-        if (!m_static_rtree.get())
-        {
-            LoadRTree();
-        }
-
         return m_static_rtree->LocateClosestEndPointForCoordinate(
             input_coordinate, result, zoom_level);
     }
@@ -398,15 +448,19 @@ template <class EdgeDataT> class InternalDataFacade : public BaseDataFacade<Edge
                                             std::vector<PhantomNode> &resulting_phantom_node_vector,
                                             const unsigned number_of_results) final
     {
-        if (!m_static_rtree.get())
-        {
-            LoadRTree();
-        }
-
         return m_static_rtree->IncrementalFindPhantomNodeForCoordinate(
             input_coordinate, resulting_phantom_node_vector, number_of_results);
     }
 
+    void IncrementalFindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> &input_coordinates,
+        std::vector<std::vector<PhantomNode>> &resulting_phantom_node_vectors,
+        const unsigned number_of_results) final
+    {
+        m_static_rtree->IncrementalFindPhantomNodesForCoordinates(
+            input_coordinates, resulting_phantom_node_vectors, number_of_results);
+    }
+
     unsigned GetCheckSum() const final { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const final
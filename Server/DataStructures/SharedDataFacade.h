@@ -34,7 +34,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SharedDataType.h"
 
 #include "../../data_structures/range_table.hpp"
-#include "../../data_structures/static_graph.hpp"
+#include "../../data_structures/static_query_graph.hpp"
 #include "../../data_structures/static_rtree.hpp"
 #include "../../Util/BoostFileSystemFix.h"
 #include "../../Util/make_unique.hpp"
@@ -47,16 +47,14 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
 {
 
   private:
-    typedef EdgeDataT EdgeData;
-    typedef BaseDataFacade<EdgeData> super;
-    typedef StaticGraph<EdgeData, true> QueryGraph;
-    typedef typename StaticGraph<EdgeData, true>::NodeArrayEntry GraphNode;
-    typedef typename StaticGraph<EdgeData, true>::EdgeArrayEntry GraphEdge;
+    typedef BaseDataFacade<EdgeDataT> super;
+    typedef StaticQueryGraph<true> QueryGraph;
+    typedef typename QueryGraph::NodeArrayEntry GraphNode;
+    typedef typename QueryGraph::EdgeArrayEntry GraphEdge;
+    typedef typename QueryGraph::EdgeIDArrayEntry GraphEdgeID;
     typedef typename RangeTable<16, true>::BlockT NameIndexBlock;
-    typedef typename QueryGraph::InputEdge InputEdge;
     typedef typename super::RTreeLeaf RTreeLeaf;
     using SharedRTree = StaticRTree<RTreeLeaf, ShM<FixedPointCoordinate, true>::vector, true>;
-    using TimeStampedRTreePair = std::pair<unsigned, std::shared_ptr<SharedRTree>>;
     using RTreeNode = typename SharedRTree::TreeNode;
 
     SharedDataLayout *data_layout;
@@ -83,8 +81,9 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
     ShM<bool, true>::vector m_edge_is_compressed;
     ShM<unsigned, true>::vector m_geometry_indices;
     ShM<unsigned, true>::vector m_geometry_list;
+    ShM<NodeID, true>::vector m_level_order;
 
-    boost::thread_specific_ptr<std::pair<unsigned, std::shared_ptr<SharedRTree>>> m_static_rtree;
+    std::unique_ptr<SharedRTree> m_static_rtree;
     boost::filesystem::path file_index_path;
 
     std::shared_ptr<RangeTable<16, true>> m_name_table;
@@ -112,12 +111,9 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
 
         RTreeNode *tree_ptr =
             data_layout->GetBlockPtr<RTreeNode>(shared_memory, SharedDataLayout::R_SEARCH_TREE);
-        m_static_rtree.reset(new TimeStampedRTreePair(CURRENT_TIMESTAMP,
-            osrm::make_unique<SharedRTree>(
-                tree_ptr,
-                data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE],
-                file_index_path,
-                m_coordinate_list)));
+        m_static_rtree = osrm::make_unique<SharedRTree>(
+            tree_ptr, data_layout->num_entries[SharedDataLayout::R_SEARCH_TREE], file_index_path,
+            m_coordinate_list);
     }
 
     void LoadGraph()
@@ -128,11 +124,16 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
         GraphEdge *graph_edges_ptr =
             data_layout->GetBlockPtr<GraphEdge>(shared_memory, SharedDataLayout::GRAPH_EDGE_LIST);
 
+        GraphEdgeID *graph_edge_ids_ptr = data_layout->GetBlockPtr<GraphEdgeID>(
+            shared_memory, SharedDataLayout::GRAPH_EDGE_ID_LIST);
+
         typename ShM<GraphNode, true>::vector node_list(
             graph_nodes_ptr, data_layout->num_entries[SharedDataLayout::GRAPH_NODE_LIST]);
         typename ShM<GraphEdge, true>::vector edge_list(
             graph_edges_ptr, data_layout->num_entries[SharedDataLayout::GRAPH_EDGE_LIST]);
-        m_query_graph.reset(new QueryGraph(node_list, edge_list));
+        typename ShM<GraphEdgeID, true>::vector edge_id_list(
+            graph_edge_ids_ptr, data_layout->num_entries[SharedDataLayout::GRAPH_EDGE_ID_LIST]);
+        m_query_graph.reset(new QueryGraph(node_list, edge_list, edge_id_list));
     }
 
     void LoadNodeAndEdgeInformation()
@@ -216,6 +217,15 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
         m_geometry_list.swap(geometry_list);
     }
 
+    void LoadLevelOrder()
+    {
+        NodeID *level_order_ptr =
+            data_layout->GetBlockPtr<NodeID>(shared_memory, SharedDataLayout::LEVEL_ORDER);
+        typename ShM<NodeID, true>::vector level_order(
+            level_order_ptr, data_layout->num_entries[SharedDataLayout::LEVEL_ORDER]);
+        m_level_order.swap(level_order);
+    }
+
   public:
     virtual ~SharedDataFacade() {}
 
@@ -269,6 +279,8 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
             LoadTimestamp();
             LoadViaNodeList();
             LoadNames();
+            LoadLevelOrder();
+            LoadRTree();
 
             data_layout->PrintInformation();
 
@@ -292,7 +304,7 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
 
     NodeID GetTarget(const EdgeID e) const final { return m_query_graph->GetTarget(e); }
 
-    EdgeDataT &GetEdgeData(const EdgeID e) const final { return m_query_graph->GetEdgeData(e); }
+    EdgeDataT GetEdgeData(const EdgeID e) const final { return m_query_graph->GetEdgeData(e); }
 
     EdgeID BeginEdges(const NodeID n) const final { return m_query_graph->BeginEdges(n); }
 
@@ -319,6 +331,16 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
         return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
     }
 
+    unsigned GetNumberOfLevelOrderedNodes() const final
+    {
+        return static_cast<unsigned>(m_level_order.size());
+    }
+
+    NodeID GetLevelOrderedNode(const unsigned position) const final
+    {
+        return m_level_order[position];
+    }
+
     // node and edge information access
     FixedPointCoordinate GetCoordinateOfNode(const NodeID id) const final
     {
@@ -360,12 +382,7 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
                                             FixedPointCoordinate &result,
                                             const unsigned zoom_level = 18) final
     {
-        if (!m_static_rtree.get() || CURRENT_TIMESTAMP != m_static_rtree->first)
-        {
-            LoadRTree();
-        }
-
-        return m_static_rtree->second->LocateClosestEndPointForCoordinate(
+        return m_static_rtree->LocateClosestEndPointForCoordinate(
             input_coordinate, result, zoom_level);
     }
 
@@ -390,15 +407,19 @@ template <class EdgeDataT> class SharedDataFacade : public BaseDataFacade<EdgeDa
                                             std::vector<PhantomNode> &resulting_phantom_node_vector,
                                             const unsigned number_of_results) final
     {
-        if (!m_static_rtree.get() || CURRENT_TIMESTAMP != m_static_rtree->first)
-        {
-            LoadRTree();
-        }
-
-        return m_static_rtree->second->IncrementalFindPhantomNodeForCoordinate(
+        return m_static_rtree->IncrementalFindPhantomNodeForCoordinate(
             input_coordinate, resulting_phantom_node_vector, number_of_results);
     }
 
+    void IncrementalFindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> &input_coordinates,
+        std::vector<std::vector<PhantomNode>> &resulting_phantom_node_vectors,
+        const unsigned number_of_results) final
+    {
+        m_static_rtree->IncrementalFindPhantomNodesForCoordinates(
+            input_coordinates, resulting_phantom_node_vectors, number_of_results);
+    }
+
     unsigned GetCheckSum() const final { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const final
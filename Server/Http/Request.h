@@ -37,10 +37,16 @@ namespace http
 
 struct Request
 {
+    Request() : http_version_major(0), http_version_minor(0), keep_alive(false) {}
+
     std::string uri;
     std::string referrer;
     std::string agent;
     boost::asio::ip::address endpoint;
+    unsigned http_version_major;
+    unsigned http_version_minor;
+    // whether the client wants to send further requests over the same connection
+    bool keep_alive;
 };
 
 } // namespace http
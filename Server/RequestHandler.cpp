@@ -27,7 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "RequestHandler.h"
 
-#include "APIGrammar.h"
+#include "APIParser.h"
 #include "Http/Request.h"
 
 #include "../data_structures/json_container.hpp"
@@ -40,56 +40,30 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <osrm/Reply.h>
 #include <osrm/RouteParameters.h>
 
-#include <ctime>
-
 #include <algorithm>
 #include <iostream>
 
-RequestHandler::RequestHandler() : routing_machine(nullptr) {}
+RequestHandler::RequestHandler(const unsigned access_log_sampling_interval)
+    : routing_machine(nullptr), access_log(access_log_sampling_interval)
+{
+}
 
 void RequestHandler::handle_request(const http::Request &req, http::Reply &reply)
 {
     // parse command
     try
     {
-        std::string request;
-        URIDecode(req.uri, request);
-
-        // deactivated as GCC apparently does not implement that, not even in 4.9
-        // std::time_t t = std::time(nullptr);
-        // SimpleLogger().Write() << std::put_time(std::localtime(&t), "%m-%d-%Y %H:%M:%S") <<
-        //     " " << req.endpoint.to_string() << " " <<
-        //     req.referrer << ( 0 == req.referrer.length() ? "- " :" ") <<
-        //     req.agent << ( 0 == req.agent.length() ? "- " :" ") << request;
-
-        time_t ltime;
-        struct tm *time_stamp;
-
-        ltime = time(nullptr);
-        time_stamp = localtime(&ltime);
-
-        // log timestamp
-        SimpleLogger().Write() << (time_stamp->tm_mday < 10 ? "0" : "") << time_stamp->tm_mday << "-"
-                               << (time_stamp->tm_mon + 1 < 10 ? "0" : "") << (time_stamp->tm_mon + 1) << "-"
-                               << 1900 + time_stamp->tm_year << " " << (time_stamp->tm_hour < 10 ? "0" : "")
-                               << time_stamp->tm_hour << ":" << (time_stamp->tm_min < 10 ? "0" : "") << time_stamp->tm_min
-                               << ":" << (time_stamp->tm_sec < 10 ? "0" : "") << time_stamp->tm_sec << " "
-                               << req.endpoint.to_string() << " " << req.referrer
-                               << (0 == req.referrer.length() ? "- " : " ") << req.agent
-                               << (0 == req.agent.length() ? "- " : " ") << request;
+        access_log.Write(req.endpoint, req.referrer, req.agent, req.uri);
 
         RouteParameters route_parameters;
-        APIGrammarParser api_parser(&route_parameters);
-
-        auto iter = request.begin();
-        const bool result = boost::spirit::qi::parse(iter, request.end(), api_parser);
+        APIParser api_parser(route_parameters);
 
         // check if the was an error with the request
-        if (!result || (iter != request.end()))
+        std::size_t position = 0;
+        if (!api_parser.Parse(req.uri, position))
         {
             reply = http::Reply::StockReply(http::Reply::badRequest);
             reply.content.clear();
-            const auto position = std::distance(request.begin(), iter);
             JSON::Object json_result;
             json_result.values["status"] = 400;
             std::string message = "Query string malformed close to position ";
@@ -28,10 +28,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef REQUEST_HANDLER_H
 #define REQUEST_HANDLER_H
 
+#include "AccessLog.h"
+
 #include <string>
 
-template <typename Iterator, class HandlerT> struct APIGrammar;
-struct RouteParameters;
 class OSRM;
 
 namespace http
@@ -44,9 +44,7 @@ class RequestHandler
 {
 
   public:
-    using APIGrammarParser = APIGrammar<std::string::iterator, RouteParameters>;
-
-    RequestHandler();
+    explicit RequestHandler(const unsigned access_log_sampling_interval);
     RequestHandler(const RequestHandler &) = delete;
 
     void handle_request(const http::Request &req, http::Reply &rep);
@@ -54,6 +52,7 @@ class RequestHandler
 
   private:
     OSRM *routing_machine;
+    AccessLog access_log;
 };
 
 #endif // REQUEST_HANDLER_H
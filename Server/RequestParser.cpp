@@ -29,12 +29,22 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Http/Request.h"
 
+#include <boost/algorithm/string/find.hpp>
+
 namespace http
 {
 
-RequestParser::RequestParser() : state_(method_start), header({"", ""}) {}
+RequestParser::RequestParser()
+    : state_(method_start), header({"", ""}), keep_alive_requested(boost::indeterminate)
+{
+}
 
-void RequestParser::Reset() { state_ = method_start; }
+void RequestParser::Reset()
+{
+    state_ = method_start;
+    header.Clear();
+    keep_alive_requested = boost::indeterminate;
+}
 
 boost::tuple<boost::tribool, char *>
 RequestParser::Parse(Request &req, char *begin, char *end, http::CompressionType &compression_type)
@@ -132,6 +142,7 @@ RequestParser::consume(Request &req, char input, http::CompressionType &compress
     case http_version_major_start:
         if (isDigit(input))
         {
+            req.http_version_major = input - '0';
             state_ = http_version_major;
             return boost::indeterminate;
         }
@@ -144,12 +155,14 @@ RequestParser::consume(Request &req, char input, http::CompressionType &compress
         }
         if (isDigit(input))
         {
+            req.http_version_major = req.http_version_major * 10 + input - '0';
             return boost::indeterminate;
         }
         return false;
     case http_version_minor_start:
         if (isDigit(input))
         {
+            req.http_version_minor = input - '0';
             state_ = http_version_minor;
             return boost::indeterminate;
         }
@@ -162,6 +175,7 @@ RequestParser::consume(Request &req, char input, http::CompressionType &compress
         }
         if (isDigit(input))
         {
+            req.http_version_minor = req.http_version_minor * 10 + input - '0';
             return boost::indeterminate;
         }
         return false;
@@ -196,6 +210,18 @@ RequestParser::consume(Request &req, char input, http::CompressionType &compress
             req.agent = header.value;
         }
 
+        if ("Connection" == header.name)
+        {
+            if (boost::algorithm::ifind_first(header.value, "close"))
+            {
+                keep_alive_requested = false;
+            }
+            else if (boost::algorithm::ifind_first(header.value, "keep-alive"))
+            {
+                keep_alive_requested = true;
+            }
+        }
+
         if (input == '\r')
         {
             state_ = expecting_newline_3;
@@ -264,7 +290,21 @@ RequestParser::consume(Request &req, char input, http::CompressionType &compress
         }
         return false;
     default: // expecting_newline_3:
-        return (input == '\n');
+        if (input != '\n')
+        {
+            return false;
+        }
+        // HTTP/1.1 connections persist unless the client closes them, older ones only on request
+        if (boost::indeterminate(keep_alive_requested))
+        {
+            req.keep_alive = req.http_version_major > 1 ||
+                             (1 == req.http_version_major && 0 < req.http_version_minor);
+        }
+        else
+        {
+            req.keep_alive = static_cast<bool>(keep_alive_requested);
+        }
+        return true;
         // default:
         //     return false;
     }
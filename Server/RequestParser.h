@@ -83,6 +83,8 @@ class RequestParser
       expecting_newline_3 } state_;
 
     Header header;
+    // set by a Connection header, indeterminate if the client did not send one
+    boost::tribool keep_alive_requested;
 };
 
 } // namespace http
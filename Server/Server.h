@@ -40,6 +40,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <zlib.h>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <functional>
 #include <memory>
 #include <thread>
@@ -50,40 +55,94 @@ class Server
   public:
 
     // Note: returns a shared instead of a unique ptr as it is captured in a lambda somewhere else
-    static std::shared_ptr<Server> CreateServer(std::string &ip_address, int ip_port, unsigned requested_num_threads)
+    static std::shared_ptr<Server> CreateServer(std::string &ip_address,
+                                                int ip_port,
+                                                unsigned requested_num_threads,
+                                                unsigned keep_alive_timeout,
+                                                unsigned max_keep_alive_requests,
+                                                bool use_io_sharding,
+                                                unsigned access_log_sampling_interval)
     {
         SimpleLogger().Write() << "http 1.1 compression handled by zlib version " << zlibVersion();
         const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         const unsigned real_num_threads = std::min(hardware_threads, requested_num_threads);
-        return std::make_shared<Server>(ip_address, ip_port, real_num_threads);
+#ifndef SO_REUSEPORT
+        if (use_io_sharding)
+        {
+            SimpleLogger().Write(logWARNING)
+                << "SO_REUSEPORT is not supported, all threads share one io_service";
+            use_io_sharding = false;
+        }
+#endif
+        return std::make_shared<Server>(ip_address, ip_port, real_num_threads, keep_alive_timeout,
+                                        max_keep_alive_requests, use_io_sharding,
+                                        access_log_sampling_interval);
     }
 
-    explicit Server(const std::string &address, const int port, const unsigned thread_pool_size)
-        : thread_pool_size(thread_pool_size), acceptor(io_service),
-          new_connection(std::make_shared<http::Connection>(io_service, request_handler)), request_handler()
+    // Without io sharding all threads run one io_service that a single acceptor hands every
+    // connection to. With io sharding every thread runs an io_service of its own, pinned to a
+    // core, and accepts its connections with an acceptor of its own that shares the port
+    // through SO_REUSEPORT. Connections then never leave the thread that accepted them.
+    explicit Server(const std::string &address,
+                    const int port,
+                    const unsigned thread_pool_size,
+                    const unsigned keep_alive_timeout,
+                    const unsigned max_keep_alive_requests,
+                    const bool use_io_sharding,
+                    const unsigned access_log_sampling_interval)
+        : thread_pool_size(thread_pool_size), keep_alive_timeout(keep_alive_timeout),
+          max_keep_alive_requests(max_keep_alive_requests), use_io_sharding(use_io_sharding),
+          request_handler(access_log_sampling_interval)
     {
         const std::string port_string = cast::integral_to_string(port);
 
-        boost::asio::ip::tcp::resolver resolver(io_service);
-        boost::asio::ip::tcp::resolver::query query(address, port_string);
-        boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
-
-        acceptor.open(endpoint.protocol());
-        acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
-        acceptor.bind(endpoint);
-        acceptor.listen();
-        acceptor.async_accept(
-            new_connection->socket(),
-            boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+        const unsigned number_of_shards = use_io_sharding ? thread_pool_size : 1;
+        for (unsigned i = 0; i < number_of_shards; ++i)
+        {
+            shards.emplace_back(osrm::make_unique<IOShard>());
+            IOShard &shard = *shards.back();
+
+            boost::asio::ip::tcp::resolver resolver(shard.io_service);
+            boost::asio::ip::tcp::resolver::query query(address, port_string);
+            boost::asio::ip::tcp::endpoint endpoint = *resolver.resolve(query);
+
+            shard.acceptor.open(endpoint.protocol());
+            shard.acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+#ifdef SO_REUSEPORT
+            if (use_io_sharding)
+            {
+                shard.acceptor.set_option(
+                    boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+            }
+#endif
+            shard.acceptor.bind(endpoint);
+            shard.acceptor.listen();
+            AcceptNextConnection(shard);
+        }
     }
 
     void Run()
     {
+        const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
         std::vector<std::shared_ptr<std::thread>> threads;
         for (unsigned i = 0; i < thread_pool_size; ++i)
         {
+            IOShard &shard = *shards[i % shards.size()];
             std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-                boost::bind(&boost::asio::io_service::run, &io_service));
+                boost::bind(&boost::asio::io_service::run, &shard.io_service));
+#ifdef __linux__
+            if (use_io_sharding)
+            {
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                CPU_SET(i % hardware_threads, &cpu_set);
+                if (0 != pthread_setaffinity_np(thread->native_handle(), sizeof(cpu_set_t),
+                                                &cpu_set))
+                {
+                    SimpleLogger().Write(logWARNING) << "could not pin thread " << i << " to a core";
+                }
+            }
+#endif
             threads.push_back(thread);
         }
         for (auto thread : threads)
@@ -92,27 +151,51 @@ class Server
         }
     }
 
-    void Stop() { io_service.stop(); }
+    void Stop()
+    {
+        for (const auto &shard : shards)
+        {
+            shard->io_service.stop();
+        }
+    }
 
     RequestHandler &GetRequestHandlerPtr() { return request_handler; }
 
   private:
-    void HandleAccept(const boost::system::error_code &e)
+    struct IOShard
+    {
+        IOShard() : acceptor(io_service) {}
+
+        boost::asio::io_service io_service;
+        boost::asio::ip::tcp::acceptor acceptor;
+        std::shared_ptr<http::Connection> new_connection;
+    };
+
+    void AcceptNextConnection(IOShard &shard)
+    {
+        // a connection of a shard is only ever served by the thread of that shard
+        shard.new_connection = std::make_shared<http::Connection>(
+            shard.io_service, request_handler, keep_alive_timeout, max_keep_alive_requests,
+            !use_io_sharding);
+        shard.acceptor.async_accept(shard.new_connection->socket(),
+                                    boost::bind(&Server::HandleAccept, this, boost::ref(shard),
+                                                boost::asio::placeholders::error));
+    }
+
+    void HandleAccept(IOShard &shard, const boost::system::error_code &e)
     {
         if (!e)
         {
-            new_connection->start();
-            new_connection = std::make_shared<http::Connection>(io_service, request_handler);
-            acceptor.async_accept(
-                new_connection->socket(),
-                boost::bind(&Server::HandleAccept, this, boost::asio::placeholders::error));
+            shard.new_connection->start();
+            AcceptNextConnection(shard);
         }
     }
 
     unsigned thread_pool_size;
-    boost::asio::io_service io_service;
-    boost::asio::ip::tcp::acceptor acceptor;
-    std::shared_ptr<http::Connection> new_connection;
+    unsigned keep_alive_timeout;
+    unsigned max_keep_alive_requests;
+    bool use_io_sharding;
+    std::vector<std::unique_ptr<IOShard>> shards;
     RequestHandler request_handler;
 };
 
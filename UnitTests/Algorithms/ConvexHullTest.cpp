@@ -0,0 +1,72 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../../algorithms/convex_hull.hpp"
+#include "../../Include/osrm/Coordinate.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(convex_hull)
+
+BOOST_AUTO_TEST_CASE(square_with_inner_points_test)
+{
+    /*
+     * x-----x
+     * |  x  |
+     * | x  x|
+     * x-----x
+     */
+    const std::vector<FixedPointCoordinate> coordinates = {
+        {0, 0}, {10, 10}, {5, 5}, {0, 10}, {2, 3}, {10, 0}, {3, 9}, {10, 5}};
+    const std::vector<FixedPointCoordinate> hull = ConvexHull::Of(coordinates);
+
+    // counter-clockwise starting at the smallest lon, lat; (10, 5) is collinear and dropped
+    const std::vector<FixedPointCoordinate> expected = {{0, 0}, {0, 10}, {10, 10}, {10, 0}};
+    BOOST_REQUIRE_EQUAL(hull.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK(hull[i] == expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(degenerate_input_test)
+{
+    BOOST_CHECK(ConvexHull::Of({}).empty());
+
+    const std::vector<FixedPointCoordinate> duplicates = {{1, 1}, {1, 1}, {1, 1}};
+    BOOST_CHECK_EQUAL(ConvexHull::Of(duplicates).size(), 1);
+
+    const std::vector<FixedPointCoordinate> collinear = {{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+    const std::vector<FixedPointCoordinate> hull = ConvexHull::Of(collinear);
+    BOOST_CHECK_EQUAL(hull.size(), 2);
+    BOOST_CHECK(hull.front() == FixedPointCoordinate(0, 0));
+    BOOST_CHECK(hull.back() == FixedPointCoordinate(3, 3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
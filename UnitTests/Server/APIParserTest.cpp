@@ -0,0 +1,231 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "../../Server/APIParser.h"
+
+#include <osrm/RouteParameters.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(api_parser)
+
+namespace
+{
+bool Parse(const std::string &uri, RouteParameters &route_parameters, std::size_t &position)
+{
+    APIParser parser(route_parameters);
+    return parser.Parse(uri, position);
+}
+
+// returns where parsing stopped, the URI is expected to be malformed
+std::size_t ErrorPosition(const std::string &uri)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_CHECK_MESSAGE(!Parse(uri, route_parameters, position), uri << " was accepted");
+    return position;
+}
+
+bool Accepts(const std::string &uri)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    return Parse(uri, route_parameters, position);
+}
+}
+
+BOOST_AUTO_TEST_CASE(parses_all_parameters)
+{
+    const std::string uri = "/viaroute?z=12&output=gpx&checksum=42&compression=false&hl=de"
+                            "&instructions=true&geometry=false&alt=false&alt_budget=250"
+                            "&num_results=5&max_time=30&budget=100&debug=true&geomformat=cmp";
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse(uri, route_parameters, position));
+    BOOST_CHECK_EQUAL(position, uri.size());
+
+    BOOST_CHECK_EQUAL(route_parameters.service, "viaroute");
+    BOOST_CHECK_EQUAL(route_parameters.zoom_level, 12);
+    BOOST_CHECK_EQUAL(route_parameters.output_format, "gpx");
+    BOOST_CHECK_EQUAL(route_parameters.check_sum, 42u);
+    BOOST_CHECK(!route_parameters.compression);
+    BOOST_CHECK_EQUAL(route_parameters.language, "de");
+    BOOST_CHECK(route_parameters.print_instructions);
+    BOOST_CHECK(!route_parameters.geometry);
+    BOOST_CHECK(!route_parameters.alternate_route);
+    BOOST_CHECK_EQUAL(route_parameters.alternate_route_budget, 250u);
+    BOOST_CHECK_EQUAL(route_parameters.num_results, 5);
+    BOOST_CHECK_EQUAL(route_parameters.max_time, 30u);
+    BOOST_CHECK_EQUAL(route_parameters.time_budget, 100u);
+    BOOST_CHECK(route_parameters.debug);
+    BOOST_CHECK(route_parameters.deprecatedAPI);
+}
+
+BOOST_AUTO_TEST_CASE(parses_locations_sources_and_destinations)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse("/table?loc=52.5,13.4&src=1,2&dst=-3.25,+4", route_parameters, position));
+
+    BOOST_REQUIRE_EQUAL(route_parameters.coordinates.size(), 3u);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lat, 52500000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lon, 13400000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[1].lat, 1000000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[1].lon, 2000000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[2].lat, -3250000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[2].lon, 4000000);
+
+    BOOST_CHECK(route_parameters.is_source[0] && route_parameters.is_destination[0]);
+    BOOST_CHECK(route_parameters.is_source[1] && !route_parameters.is_destination[1]);
+    BOOST_CHECK(!route_parameters.is_source[2] && route_parameters.is_destination[2]);
+}
+
+BOOST_AUTO_TEST_CASE(parses_numbers_that_are_no_short_decimals)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(
+        Parse("/viaroute?loc=52.50000000000000001,1e1&loc=-0.5E-1,1.", route_parameters, position));
+
+    BOOST_REQUIRE_EQUAL(route_parameters.coordinates.size(), 2u);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lat, 52500000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lon, 10000000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[1].lat, -50000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[1].lon, 1000000);
+}
+
+BOOST_AUTO_TEST_CASE(hints_belong_to_the_last_location)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse("/viaroute?hint=dropped&loc=1,1&hint=ab_-.9&loc=2,2&u=true&loc=3,3",
+                        route_parameters, position));
+
+    BOOST_CHECK_EQUAL(route_parameters.coordinates.size(), 3u);
+    BOOST_REQUIRE_EQUAL(route_parameters.hints.size(), 1u);
+    BOOST_CHECK_EQUAL(route_parameters.hints[0], "ab_-.9");
+    BOOST_REQUIRE_EQUAL(route_parameters.uturns.size(), 2u);
+    BOOST_CHECK(!route_parameters.uturns[0]);
+    BOOST_CHECK(route_parameters.uturns[1]);
+}
+
+BOOST_AUTO_TEST_CASE(uturns_must_come_last)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse("/viaroute?loc=1,1&loc=2,2&uturns=true", route_parameters, position));
+    BOOST_CHECK(route_parameters.uturn_default);
+    BOOST_REQUIRE_EQUAL(route_parameters.uturns.size(), 2u);
+    BOOST_CHECK(route_parameters.uturns[0] && route_parameters.uturns[1]);
+
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&uturns=true&loc=2,2"), 29u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&uturns=true&uturns=true"), 29u);
+}
+
+BOOST_AUTO_TEST_CASE(decodes_percent_escapes)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    const std::string uri = "%2Fviaroute%3Floc=1%2C2%26hl=d%65";
+    BOOST_REQUIRE(Parse(uri, route_parameters, position));
+    // positions count decoded characters
+    BOOST_CHECK_EQUAL(position, std::string("/viaroute?loc=1,2&hl=de").size());
+
+    BOOST_CHECK_EQUAL(route_parameters.service, "viaroute");
+    BOOST_REQUIRE_EQUAL(route_parameters.coordinates.size(), 1u);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lat, 1000000);
+    BOOST_CHECK_EQUAL(route_parameters.coordinates[0].lon, 2000000);
+    BOOST_CHECK_EQUAL(route_parameters.language, "de");
+
+    // incomplete escapes are taken as they are
+    BOOST_CHECK(!Accepts("/viaroute?hl=d%6"));
+    BOOST_CHECK(!Accepts("/viaroute?hl=d%"));
+}
+
+BOOST_AUTO_TEST_CASE(keeps_escapes_that_are_left_in_jsonp)
+{
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse("/viaroute?jsonp=cb%5B0%5D", route_parameters, position));
+    BOOST_CHECK_EQUAL(route_parameters.jsonp_parameter, "cb[0]");
+
+    // %25 decodes to a '%' that starts an escape of its own
+    RouteParameters escaped_route_parameters;
+    BOOST_REQUIRE(Parse("/viaroute?jsonp=cb%255B0%255D", escaped_route_parameters, position));
+    BOOST_CHECK_EQUAL(escaped_route_parameters.jsonp_parameter, "cb%5B0%5D");
+
+    // only digits and upper case letters may follow it
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?jsonp=cb%255b"), 18u);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_numbers_that_overflow)
+{
+    BOOST_CHECK(Accepts("/viaroute?z=32767"));
+    BOOST_CHECK(Accepts("/viaroute?z=-32768"));
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?z=32768"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?z=-32769"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?num_results=100000"), 9u);
+
+    RouteParameters route_parameters;
+    std::size_t position = 0;
+    BOOST_REQUIRE(Parse("/viaroute?checksum=4294967295", route_parameters, position));
+    BOOST_CHECK_EQUAL(route_parameters.check_sum, 4294967295u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?checksum=4294967296"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?max_time=99999999999"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?budget=4294967296"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?alt_budget=4294967296"), 9u);
+}
+
+BOOST_AUTO_TEST_CASE(rejects_coordinates_that_are_not_finite)
+{
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=nan,1"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,inf"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,-inf"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1e400,1"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&loc=1,-1e400"), 17u);
+}
+
+BOOST_AUTO_TEST_CASE(reports_where_parsing_stopped)
+{
+    BOOST_CHECK_EQUAL(ErrorPosition(""), 0u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/"), 0u);
+    BOOST_CHECK_EQUAL(ErrorPosition("?"), 0u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute/loc=1,1"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?nonsense=1"), 9u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&loc=1"), 17u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&alt=maybe"), 17u);
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1&hl="), 17u);
+    // the number ends where its longest valid prefix ends
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1,1-2"), 17u);
+    // escaped characters count once
+    BOOST_CHECK_EQUAL(ErrorPosition("/viaroute?loc=1%2C1&loc=x"), 17u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
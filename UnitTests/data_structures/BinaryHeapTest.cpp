@@ -26,6 +26,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "../../data_structures/binary_heap.hpp"
+#include "../../data_structures/radix_heap.hpp"
 #include "../../typedefs.h"
 
 #include <boost/test/unit_test.hpp>
@@ -46,7 +47,15 @@ typedef int TestKey;
 typedef int TestWeight;
 typedef boost::mpl::list<ArrayStorage<TestNodeID, TestKey>,
                          MapStorage<TestNodeID, TestKey>,
-                         UnorderedMapStorage<TestNodeID, TestKey>> storage_types;
+                         UnorderedMapStorage<TestNodeID, TestKey>,
+                         TimestampedArrayStorage<TestNodeID, TestKey>> storage_types;
+
+using TestStorage = ArrayStorage<TestNodeID, TestKey>;
+typedef boost::mpl::list<BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 3>,
+                         BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 4>,
+                         BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage, 8>,
+                         RadixHeap<TestNodeID, TestKey, TestWeight, TestData, TestStorage>>
+    heap_types;
 
 template <unsigned NUM_ELEM> struct RandomDataFixture
 {
@@ -107,6 +116,30 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(insert_test, T, storage_types, RandomDataFixtur
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(const_lookup_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    // insert every other node only
+    for (unsigned idx : order)
+    {
+        if (0 == ids[idx] % 2)
+        {
+            heap.Insert(ids[idx], weights[idx], data[idx]);
+        }
+    }
+
+    const auto &const_heap = heap;
+    for (auto id : ids)
+    {
+        BOOST_CHECK_EQUAL(const_heap.WasInserted(id), 0 == id % 2);
+        if (0 == id % 2)
+        {
+            BOOST_CHECK_EQUAL(const_heap.GetKey(id), weights[id]);
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_min_test, T, storage_types, RandomDataFixture<NUM_NODES>)
 {
     BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
@@ -143,6 +176,35 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(delete_all_test, T, storage_types, RandomDataFi
     BOOST_CHECK(heap.Empty());
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(clear_test, T, storage_types, RandomDataFixture<NUM_NODES>)
+{
+    BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    heap.Clear();
+
+    BOOST_CHECK(heap.Empty());
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasInserted(id));
+    }
+
+    // reinsert in reverse order to make sure no stale index survives
+    for (auto id : ids)
+    {
+        heap.Insert(ids[NUM_NODES - 1 - id], weights[id], data[id]);
+    }
+    for (auto id : ids)
+    {
+        BOOST_CHECK(heap.WasInserted(id));
+        BOOST_CHECK_EQUAL(heap.GetKey(ids[NUM_NODES - 1 - id]), weights[id]);
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomDataFixture<10>)
 {
     BinaryHeap<TestNodeID, TestKey, TestWeight, TestData, T> heap(10);
@@ -175,4 +237,53 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(decrease_key_test, T, storage_types, RandomData
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(variant_delete_min_test, T, heap_types, RandomDataFixture<NUM_NODES>)
+{
+    T heap(NUM_NODES);
+
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+
+    for (auto id : ids)
+    {
+        BOOST_CHECK(!heap.WasRemoved(id));
+        BOOST_CHECK_EQUAL(heap.Min(), id);
+        BOOST_CHECK_EQUAL(id, heap.DeleteMin());
+        BOOST_CHECK(heap.WasRemoved(id));
+    }
+    BOOST_CHECK(heap.Empty());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(variant_decrease_key_test, T, heap_types, RandomDataFixture<NUM_NODES>)
+{
+    T heap(NUM_NODES);
+
+    // settle half of the nodes, then decrease the keys of the remaining ones in reverse order
+    for (unsigned idx : order)
+    {
+        heap.Insert(ids[idx], weights[idx], data[idx]);
+    }
+    for (unsigned i = 0; i < NUM_NODES / 2; ++i)
+    {
+        BOOST_CHECK_EQUAL(ids[i], heap.DeleteMin());
+    }
+
+    const TestWeight last_settled = weights[NUM_NODES / 2 - 1];
+    for (unsigned i = NUM_NODES / 2; i < NUM_NODES; ++i)
+    {
+        weights[i] = last_settled + static_cast<TestWeight>(NUM_NODES - i);
+        heap.DecreaseKey(ids[i], weights[i]);
+        BOOST_CHECK_EQUAL(heap.GetKey(ids[i]), weights[i]);
+        BOOST_CHECK_EQUAL(heap.Min(), ids[i]);
+    }
+
+    for (unsigned i = NUM_NODES; i > NUM_NODES / 2; --i)
+    {
+        BOOST_CHECK_EQUAL(ids[i - 1], heap.DeleteMin());
+    }
+    BOOST_CHECK(heap.Empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
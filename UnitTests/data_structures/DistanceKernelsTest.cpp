@@ -0,0 +1,180 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../../data_structures/distance_kernels.hpp"
+
+#include <osrm/Coordinate.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/mpl/list.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(distance_kernels)
+
+// the native lanes are the scalar ones if the compiler targets neither AVX2 nor SSE4.1
+typedef boost::mpl::if_<std::is_same<osrm::NativeLanes, osrm::ScalarLanes>,
+                        boost::mpl::list<osrm::ScalarLanes>,
+                        boost::mpl::list<osrm::ScalarLanes, osrm::NativeLanes>>::type lanes_types;
+
+// not a multiple of the lane width, so that the scalar tail is covered as well
+constexpr unsigned NUM_SEGMENTS = 1027;
+
+struct RandomSegmentsFixture
+{
+    RandomSegmentsFixture()
+        : segments(new osrm::SegmentArrays<NUM_SEGMENTS>()),
+          rectangles(new osrm::RectangleArrays<NUM_SEGMENTS>())
+    {
+        std::mt19937 g(42);
+        std::uniform_int_distribution<> lat_udist(-85 * COORDINATE_PRECISION,
+                                                  85 * COORDINATE_PRECISION);
+        std::uniform_int_distribution<> lon_udist(-180 * COORDINATE_PRECISION,
+                                                  180 * COORDINATE_PRECISION);
+        std::uniform_int_distribution<> offset_udist(-0.02 * COORDINATE_PRECISION,
+                                                     0.02 * COORDINATE_PRECISION);
+
+        location = FixedPointCoordinate(lat_udist(g), lon_udist(g));
+        for (unsigned i = 0; i < NUM_SEGMENTS; ++i)
+        {
+            FixedPointCoordinate source, target;
+            if (i % 2 == 0)
+            { // segments around the location
+                source = FixedPointCoordinate(location.lat + offset_udist(g),
+                                              location.lon + offset_udist(g));
+                target = FixedPointCoordinate(source.lat + offset_udist(g),
+                                              source.lon + offset_udist(g));
+            }
+            else
+            {
+                source = FixedPointCoordinate(lat_udist(g), lon_udist(g));
+                target = FixedPointCoordinate(lat_udist(g), lon_udist(g));
+            }
+            // degenerated segments and special cases of the projection
+            if (i % 5 == 0)
+            {
+                target.lat = source.lat;
+            }
+            if (i % 7 == 0)
+            {
+                target = source;
+            }
+            if (i % 11 == 0)
+            {
+                target = location;
+            }
+            if (i % 13 == 0)
+            {
+                source.lat = 0;
+                target.lat = 0;
+            }
+            sources.push_back(source);
+            targets.push_back(target);
+            segments->Set(i, source, target);
+            rectangles->Set(i, std::min(source.lat, target.lat), std::max(source.lat, target.lat),
+                            std::min(source.lon, target.lon), std::max(source.lon, target.lon));
+        }
+    }
+
+    FixedPointCoordinate location;
+    std::vector<FixedPointCoordinate> sources;
+    std::vector<FixedPointCoordinate> targets;
+    std::unique_ptr<osrm::SegmentArrays<NUM_SEGMENTS>> segments;
+    std::unique_ptr<osrm::RectangleArrays<NUM_SEGMENTS>> rectangles;
+};
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(segment_distances, LanesT, lanes_types, RandomSegmentsFixture)
+{
+    std::vector<float> distances(NUM_SEGMENTS);
+    osrm::ComputeSegmentDistances<LanesT>(location, *segments, NUM_SEGMENTS, distances.data());
+
+    for (unsigned i = 0; i < NUM_SEGMENTS; ++i)
+    {
+        FixedPointCoordinate nearest;
+        float ratio;
+        BOOST_CHECK_EQUAL(distances[i], FixedPointCoordinate::ComputePerpendicularDistance(
+                                            sources[i], targets[i], location, nearest, ratio));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(point_distances, LanesT, lanes_types, RandomSegmentsFixture)
+{
+    std::vector<float> distances(NUM_SEGMENTS);
+    osrm::ComputePointDistances<LanesT>(location, segments->source_lats.data(),
+                                        segments->source_lons.data(), NUM_SEGMENTS,
+                                        distances.data());
+
+    for (unsigned i = 0; i < NUM_SEGMENTS; ++i)
+    {
+        BOOST_CHECK_EQUAL(distances[i],
+                          FixedPointCoordinate::ApproximateEuclideanDistance(location, sources[i]));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(rectangle_distances, LanesT, lanes_types, RandomSegmentsFixture)
+{
+    std::vector<float> min_distances(NUM_SEGMENTS);
+    std::vector<float> min_max_distances(NUM_SEGMENTS);
+    osrm::ComputeRectangleMinDistances<LanesT>(location, *rectangles, NUM_SEGMENTS,
+                                               min_distances.data());
+    osrm::ComputeRectangleMinMaxDistances<LanesT>(location, *rectangles, NUM_SEGMENTS,
+                                                  min_max_distances.data());
+
+    for (unsigned i = 0; i < NUM_SEGMENTS; ++i)
+    {
+        const int min_lat = rectangles->min_lats[i];
+        const int max_lat = rectangles->max_lats[i];
+        const int min_lon = rectangles->min_lons[i];
+        const int max_lon = rectangles->max_lons[i];
+
+        const FixedPointCoordinate nearest(std::min(std::max(location.lat, min_lat), max_lat),
+                                           std::min(std::max(location.lon, min_lon), max_lon));
+        BOOST_CHECK_EQUAL(min_distances[i],
+                          FixedPointCoordinate::ApproximateEuclideanDistance(location, nearest));
+
+        const float upper_left = FixedPointCoordinate::ApproximateEuclideanDistance(
+            location, FixedPointCoordinate(max_lat, min_lon));
+        const float upper_right = FixedPointCoordinate::ApproximateEuclideanDistance(
+            location, FixedPointCoordinate(max_lat, max_lon));
+        const float lower_right = FixedPointCoordinate::ApproximateEuclideanDistance(
+            location, FixedPointCoordinate(min_lat, max_lon));
+        const float lower_left = FixedPointCoordinate::ApproximateEuclideanDistance(
+            location, FixedPointCoordinate(min_lat, min_lon));
+        const float min_max_dist = std::min(
+            std::min(std::max(upper_left, upper_right), std::max(upper_right, lower_right)),
+            std::min(std::max(lower_right, lower_left), std::max(lower_left, upper_left)));
+        BOOST_CHECK_EQUAL(min_max_distances[i], min_max_dist);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
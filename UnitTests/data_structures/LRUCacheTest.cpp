@@ -0,0 +1,85 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "../../data_structures/lru_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+BOOST_AUTO_TEST_SUITE(lru_cache)
+
+BOOST_AUTO_TEST_CASE(evicts_least_recently_used)
+{
+    LRUCache<unsigned, unsigned> cache(2);
+    cache.Insert(1, 10);
+    cache.Insert(2, 20);
+
+    unsigned value = 0;
+    BOOST_CHECK(cache.Fetch(1, value));
+    BOOST_CHECK_EQUAL(value, 10);
+
+    // 2 is now the least recently used entry
+    cache.Insert(3, 30);
+    BOOST_CHECK_EQUAL(cache.Size(), 2);
+    BOOST_CHECK(cache.Holds(1));
+    BOOST_CHECK(!cache.Holds(2));
+    BOOST_CHECK(cache.Holds(3));
+}
+
+BOOST_AUTO_TEST_CASE(insert_replaces_value)
+{
+    LRUCache<unsigned, unsigned> cache(2);
+    cache.Insert(1, 10);
+    cache.Insert(1, 11);
+    BOOST_CHECK_EQUAL(cache.Size(), 1);
+
+    unsigned value = 0;
+    BOOST_CHECK(cache.Fetch(1, value));
+    BOOST_CHECK_EQUAL(value, 11);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_cache_counts_hits_and_misses)
+{
+    ConcurrentLRUCache<std::uint64_t, unsigned> cache(64);
+    cache.Insert(7, 70);
+
+    unsigned value = 0;
+    BOOST_CHECK(cache.Fetch(7, value));
+    BOOST_CHECK_EQUAL(value, 70);
+    BOOST_CHECK(!cache.Fetch(8, value));
+    BOOST_CHECK_EQUAL(cache.GetNumberOfHits(), 1);
+    BOOST_CHECK_EQUAL(cache.GetNumberOfMisses(), 1);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.Size(), 0);
+    BOOST_CHECK(!cache.Fetch(7, value));
+    BOOST_CHECK_EQUAL(cache.GetNumberOfMisses(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../../data_structures/query_edge.hpp"
+#include "../../routing_algorithms/routing_base.hpp"
+#include "../../Util/osrm_exception.hpp"
+
+#include <osrm/QueryDeadline.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_SUITE(query_deadline)
+
+namespace
+{
+// PollDeadline does not touch the facade
+struct TestFacade
+{
+    using EdgeData = QueryEdge::EdgeData;
+};
+using TestRoutingInterface = BasicRoutingInterface<TestFacade>;
+}
+
+BOOST_AUTO_TEST_CASE(expires_once_the_budget_is_spent)
+{
+    QueryDeadline deadline;
+    BOOST_CHECK(!deadline.IsExpired());
+
+    deadline.SetBudget(std::chrono::milliseconds(3600 * 1000));
+    BOOST_CHECK(!deadline.IsExpired());
+
+    deadline.SetBudget(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    BOOST_CHECK(deadline.IsExpired());
+}
+
+BOOST_AUTO_TEST_CASE(expires_when_cancelled)
+{
+    QueryDeadline deadline;
+    deadline.SetBudget(std::chrono::milliseconds(3600 * 1000));
+    deadline.Cancel();
+    BOOST_CHECK(deadline.IsExpired());
+}
+
+BOOST_AUTO_TEST_CASE(copies_share_the_cancel_flag)
+{
+    QueryDeadline deadline;
+    const QueryDeadline copy = deadline;
+    QueryDeadline assigned;
+    assigned = deadline;
+
+    std::thread canceller([&deadline]()
+                          {
+                              deadline.Cancel();
+                          });
+    canceller.join();
+    BOOST_CHECK(copy.IsExpired());
+    BOOST_CHECK(assigned.IsExpired());
+
+    // a copy can cancel the original as well
+    QueryDeadline other;
+    QueryDeadline other_copy = other;
+    other_copy.Cancel();
+    BOOST_CHECK(other.IsExpired());
+}
+
+BOOST_AUTO_TEST_CASE(polls_once_per_interval)
+{
+    const unsigned poll_interval = TestRoutingInterface::DEADLINE_POLL_INTERVAL;
+    BOOST_CHECK_EQUAL(poll_interval, 1024u);
+
+    QueryDeadline deadline;
+    deadline.Cancel();
+    unsigned settled_nodes = 0;
+    for (unsigned round = 1; round <= 2; ++round)
+    {
+        for (unsigned i = 1; i < poll_interval; ++i)
+        {
+            BOOST_CHECK_NO_THROW(TestRoutingInterface::PollDeadline(deadline, settled_nodes));
+        }
+        BOOST_CHECK_THROW(TestRoutingInterface::PollDeadline(deadline, settled_nodes),
+                          osrm::query_timeout);
+        BOOST_CHECK_EQUAL(settled_nodes, round * poll_interval);
+    }
+
+    QueryDeadline open_deadline;
+    settled_nodes = 0;
+    for (unsigned i = 0; i < 4 * poll_interval; ++i)
+    {
+        TestRoutingInterface::PollDeadline(open_deadline, settled_nodes);
+    }
+    BOOST_CHECK_EQUAL(settled_nodes, 4 * poll_interval);
+}
+
+BOOST_AUTO_TEST_CASE(requests_can_only_lower_the_budget_of_their_service)
+{
+    QueryBudgets query_budgets;
+    query_budgets["viaroute"] = 100;
+    query_budgets["table"] = 0;
+
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "viaroute", 0), 100u);
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "viaroute", 50), 50u);
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "viaroute", 200), 100u);
+
+    // services without a budget take the one of the request
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "table", 0), 0u);
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "table", 200), 200u);
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "nearest", 0), 0u);
+    BOOST_CHECK_EQUAL(GetQueryBudget(query_budgets, "nearest", 200), 200u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../../data_structures/query_histograms.hpp"
+#include "../../data_structures/query_statistics.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(query_statistics)
+
+BOOST_AUTO_TEST_CASE(histogram_buckets_by_bit_length)
+{
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(0), 0);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(1), 1);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(2), 2);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(3), 2);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(1024), 11);
+    BOOST_CHECK_EQUAL(Histogram::BucketIndex(~std::uint64_t(0)), 64);
+
+    Histogram histogram;
+    histogram.Add(0);
+    histogram.Add(5);
+    histogram.Add(7);
+    BOOST_CHECK_EQUAL(histogram.GetCount(), 3);
+    BOOST_CHECK_EQUAL(histogram.GetBucket(0), 1);
+    BOOST_CHECK_EQUAL(histogram.GetBucket(3), 2);
+}
+
+BOOST_AUTO_TEST_CASE(histograms_ignore_unknown_services)
+{
+    QueryHistograms histograms;
+    histograms.AddService("viaroute");
+
+    QueryStatistics statistics;
+    statistics.settled_nodes = 42;
+    histograms.Add("viaroute", statistics);
+    histograms.Add("unknown", statistics);
+
+    const JSON::Object json_histograms = histograms.ToJSON();
+    BOOST_CHECK_EQUAL(json_histograms.values.size(), 1);
+    BOOST_CHECK(json_histograms.values.count("viaroute") > 0);
+}
+
+BOOST_AUTO_TEST_CASE(histograms_are_indexed_by_field)
+{
+    const unsigned expected_number_of_fields = QueryStatistics::NUMBER_OF_FIELDS;
+    unsigned number_of_fields = 0;
+    QueryStatistics().ForEachField([&number_of_fields](const char *, const std::uint64_t)
+                                   {
+                                       ++number_of_fields;
+                                   });
+    BOOST_CHECK_EQUAL(number_of_fields, expected_number_of_fields);
+
+    QueryHistograms histograms;
+    histograms.AddService("table");
+    QueryStatistics statistics;
+    statistics.render_time = 3;
+    histograms.Add("table", statistics);
+
+    using ObjectWrapper = mapbox::util::recursive_wrapper<JSON::Object>;
+    const JSON::Object json_services = histograms.ToJSON();
+    const auto &json_histograms = json_services.values.at("table").get<ObjectWrapper>().get();
+    BOOST_CHECK_EQUAL(json_histograms.values.size(), expected_number_of_fields);
+    const auto &render_histogram =
+        json_histograms.values.at("render_time").get<ObjectWrapper>().get();
+    const auto &sum = render_histogram.values.at("sum").get<JSON::Number>();
+    BOOST_CHECK_EQUAL(sum.value, 3.);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_tasks_add_to_calling_thread)
+{
+    QueryStatistics &statistics = QueryStatistics::ThreadLocal();
+    statistics = QueryStatistics();
+    statistics.settled_nodes = 10;
+
+    ParallelQueryStatistics parallel_statistics;
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&parallel_statistics]()
+                             {
+                                 // work done on this thread before the task is not counted
+                                 QueryStatistics::ThreadLocal().settled_nodes += 1000;
+                                 const ParallelQueryStatistics::Task task(parallel_statistics);
+                                 QueryStatistics::ThreadLocal().settled_nodes += 5;
+                                 QueryStatistics::ThreadLocal().relaxed_edges += 2;
+                             });
+    }
+    {
+        // the calling thread runs tasks as well
+        const ParallelQueryStatistics::Task task(parallel_statistics);
+        statistics.settled_nodes += 5;
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    parallel_statistics.Merge();
+
+    BOOST_CHECK_EQUAL(statistics.settled_nodes, 10 + 5 * 5);
+    BOOST_CHECK_EQUAL(statistics.relaxed_edges, 4 * 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../../data_structures/static_query_graph.hpp"
+#include "../../typedefs.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(static_query_graph)
+
+using TestQueryGraph = StaticQueryGraph<false>;
+using TestInputEdgeArrayEntry = TestQueryGraph::InputEdgeArrayEntry;
+
+constexpr unsigned TEST_NUM_NODES = 100;
+constexpr unsigned TEST_NUM_EDGES = 500;
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 15;
+
+BOOST_AUTO_TEST_CASE(split_edge_data_test)
+{
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> node_udist(0, TEST_NUM_NODES - 1);
+    std::uniform_int_distribution<> distance_udist(1, 100000);
+    std::uniform_int_distribution<> id_udist(0, (1 << 30));
+    std::bernoulli_distribution flag_dist(0.5);
+
+    std::vector<TestInputEdgeArrayEntry> input_edges(TEST_NUM_EDGES);
+    for (auto &input_edge : input_edges)
+    {
+        input_edge.target = node_udist(g);
+        input_edge.data.id = id_udist(g);
+        input_edge.data.shortcut = flag_dist(g);
+        input_edge.data.distance = distance_udist(g);
+        input_edge.data.forward = flag_dist(g);
+        input_edge.data.backward = flag_dist(g);
+    }
+
+    // all edges at node 0
+    std::vector<TestQueryGraph::NodeArrayEntry> nodes(TEST_NUM_NODES + 1);
+    for (unsigned i = 1; i <= TEST_NUM_NODES; ++i)
+    {
+        nodes[i].first_edge = TEST_NUM_EDGES;
+    }
+    std::vector<TestQueryGraph::EdgeArrayEntry> edges;
+    std::vector<TestQueryGraph::EdgeIDArrayEntry> edge_ids;
+    for (const auto &input_edge : input_edges)
+    {
+        edges.emplace_back(input_edge);
+        edge_ids.emplace_back(input_edge);
+    }
+
+    TestQueryGraph graph(nodes, edges, edge_ids);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfNodes(), TEST_NUM_NODES);
+    BOOST_CHECK_EQUAL(graph.GetNumberOfEdges(), TEST_NUM_EDGES);
+    BOOST_CHECK_EQUAL(graph.GetOutDegree(0), TEST_NUM_EDGES);
+    BOOST_CHECK_EQUAL(graph.GetOutDegree(1), 0);
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(0))
+    {
+        const auto &expected = input_edges[edge];
+        const auto data = graph.GetEdgeData(edge);
+        BOOST_CHECK_EQUAL(graph.GetTarget(edge), expected.target);
+        BOOST_CHECK_EQUAL(data.id, expected.data.id);
+        BOOST_CHECK_EQUAL(data.shortcut, expected.data.shortcut);
+        BOOST_CHECK_EQUAL(data.distance, expected.data.distance);
+        BOOST_CHECK_EQUAL(data.forward, expected.data.forward);
+        BOOST_CHECK_EQUAL(data.backward, expected.data.backward);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(find_test)
+{
+    /*
+     *  (0) -1-> (1)
+     *  ^
+     *  2
+     *  |
+     *  (2)
+     */
+    std::vector<TestQueryGraph::NodeArrayEntry> nodes = {{0}, {1}, {1}, {2}};
+    std::vector<TestInputEdgeArrayEntry> input_edges(2);
+    input_edges[0].target = 1;
+    input_edges[0].data.id = 7;
+    input_edges[0].data.distance = 1;
+    input_edges[1].target = 0;
+    input_edges[1].data.id = 8;
+    input_edges[1].data.distance = 2;
+
+    std::vector<TestQueryGraph::EdgeArrayEntry> edges;
+    std::vector<TestQueryGraph::EdgeIDArrayEntry> edge_ids;
+    for (const auto &input_edge : input_edges)
+    {
+        edges.emplace_back(input_edge);
+        edge_ids.emplace_back(input_edge);
+    }
+    TestQueryGraph graph(nodes, edges, edge_ids);
+
+    auto eit = graph.FindEdge(0, 1);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(eit).id, 7);
+    eit = graph.FindEdge(1, 0);
+    BOOST_CHECK_EQUAL(eit, SPECIAL_EDGEID);
+
+    bool reverse = false;
+    eit = graph.FindEdgeIndicateIfReverse(0, 2, reverse);
+    BOOST_CHECK_EQUAL(graph.GetEdgeData(eit).id, 8);
+    BOOST_CHECK(reverse);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
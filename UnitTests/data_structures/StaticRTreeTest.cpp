@@ -37,6 +37,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/test/test_case_template.hpp>
 #include <boost/mpl/list.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <random>
 #include <unordered_set>
 
@@ -272,7 +274,7 @@ typedef RandomGraphFixture<TEST_LEAF_NODE_SIZE * TEST_BRANCHING_FACTOR * 3,
 TestRandomGraphFixture_MultipleLevels;
 
 template <typename RTreeT>
-void simple_verify_rtree(RTreeT &rtree,
+void simple_verify_rtree(const RTreeT &rtree,
                          const std::shared_ptr<std::vector<FixedPointCoordinate>> &coords,
                          const std::vector<TestData> &edges)
 {
@@ -295,7 +297,7 @@ void simple_verify_rtree(RTreeT &rtree,
 }
 
 template <typename RTreeT>
-void sampling_verify_rtree(RTreeT &rtree, LinearSearchNN &lsnn, unsigned num_samples)
+void sampling_verify_rtree(const RTreeT &rtree, LinearSearchNN &lsnn, unsigned num_samples)
 {
     std::mt19937 g(RANDOM_SEED);
     std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
@@ -380,6 +382,81 @@ BOOST_FIXTURE_TEST_CASE(construct_multiple_levels_test, TestRandomGraphFixture_M
     construction_test("test_5", this);
 }
 
+BOOST_FIXTURE_TEST_CASE(truncated_leaf_file_test, TestRandomGraphFixture_TwoLeaves)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_truncated", this, leaves_path, nodes_path);
+    boost::filesystem::resize_file(leaves_path, boost::filesystem::file_size(leaves_path) - 1);
+    BOOST_CHECK_THROW(TestStaticRTree(nodes_path, leaves_path, coords), osrm::exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(concurrent_queries_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_concurrent", this, leaves_path, nodes_path);
+    const TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<FixedPointCoordinate> queries;
+    std::vector<PhantomNode> expected_phantoms(1000);
+    for (auto &expected : expected_phantoms)
+    {
+        queries.emplace_back(lat_udist(g), lon_udist(g));
+        rtree.FindPhantomNodeForCoordinate(queries.back(), expected, 1);
+    }
+
+    std::vector<PhantomNode> phantoms(queries.size());
+    std::vector<std::vector<PhantomNode>> incremental_phantoms(queries.size());
+    tbb::parallel_for(std::size_t(0), queries.size(), [&](const std::size_t i)
+                      {
+                          rtree.FindPhantomNodeForCoordinate(queries[i], phantoms[i], 1);
+                          rtree.IncrementalFindPhantomNodeForCoordinate(
+                              queries[i], incremental_phantoms[i], 1);
+                      });
+
+    for (const auto i : osrm::irange<std::size_t>(0, queries.size()))
+    {
+        BOOST_CHECK_EQUAL(expected_phantoms[i], phantoms[i]);
+        std::vector<PhantomNode> expected_incremental;
+        rtree.IncrementalFindPhantomNodeForCoordinate(queries[i], expected_incremental, 1);
+        BOOST_CHECK(expected_incremental == incremental_phantoms[i]);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(batch_queries_test, TestRandomGraphFixture_MultipleLevels)
+{
+    std::string leaves_path;
+    std::string nodes_path;
+    build_rtree("test_batch", this, leaves_path, nodes_path);
+    const TestStaticRTree rtree(nodes_path, leaves_path, coords);
+
+    std::mt19937 g(RANDOM_SEED);
+    std::uniform_int_distribution<> lat_udist(WORLD_MIN_LAT, WORLD_MAX_LAT);
+    std::uniform_int_distribution<> lon_udist(WORLD_MIN_LON, WORLD_MAX_LON);
+    std::vector<FixedPointCoordinate> queries;
+    for (unsigned i = 0; i < 1000; i++)
+    {
+        queries.emplace_back(lat_udist(g), lon_udist(g));
+    }
+    // duplicates are answered from the first of their occurrences
+    queries.insert(queries.end(), queries.begin(), queries.begin() + 100);
+
+    std::vector<std::vector<PhantomNode>> batch_phantoms;
+    rtree.IncrementalFindPhantomNodesForCoordinates(queries, batch_phantoms, 1);
+    BOOST_CHECK_EQUAL(batch_phantoms.size(), queries.size());
+
+    for (const auto i : osrm::irange<std::size_t>(0, queries.size()))
+    {
+        std::vector<PhantomNode> expected_phantoms;
+        rtree.IncrementalFindPhantomNodeForCoordinate(queries[i], expected_phantoms, 1);
+        BOOST_CHECK(expected_phantoms == batch_phantoms[i]);
+    }
+}
+
 /*
  * Bug: If you querry a point that lies between two BBs that have a gap,
  * one BB will be pruned, even if it could contain a nearer match.
@@ -447,6 +524,9 @@ void TestRectangle(double width, double height, double center_lat, double center
     FixedPointCoordinate south_east(rect.min_lat - offset, rect.max_lon + offset);
     FixedPointCoordinate south_west(rect.min_lat - offset, rect.min_lon - offset);
 
+    /* Distance to a contained location */
+    BOOST_CHECK_EQUAL(rect.GetMinDist(center), 0.f);
+
     /* Distance to line segments of rectangle */
     BOOST_CHECK_EQUAL(rect.GetMinDist(north),
                       FixedPointCoordinate::ApproximateEuclideanDistance(
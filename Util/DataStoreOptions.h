@@ -77,7 +77,10 @@ bool GenerateDataStoreOptions(const int argc, const char *argv[], ServerPaths &p
         boost::program_options::value<boost::filesystem::path>(&paths["namesdata"]),
         ".names file")("timestamp",
                        boost::program_options::value<boost::filesystem::path>(&paths["timestamp"]),
-                       ".timestamp file");
+                       ".timestamp file")(
+        "levelorder",
+        boost::program_options::value<boost::filesystem::path>(&paths["levelorder"]),
+        ".level file");
 
     // hidden options, will be allowed both on command line and in config
     // file, but will not be shown to the user
@@ -216,6 +219,12 @@ bool GenerateDataStoreOptions(const int argc, const char *argv[], ServerPaths &p
         {
             path_iterator->second = base_string + ".timestamp";
         }
+
+        path_iterator = paths.find("levelorder");
+        if (path_iterator != paths.end())
+        {
+            path_iterator->second = base_string + ".level";
+        }
     }
 
     path_iterator = paths.find("hsgrdata");
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "osrm_exception.hpp"
 #include "simple_logger.hpp"
 
+#include <osrm/QueryDeadline.h>
 #include <osrm/ServerPaths.h>
 
 #include <boost/any.hpp>
@@ -72,6 +73,8 @@ inline void populate_base_path(ServerPaths &server_paths)
         BOOST_ASSERT(server_paths.find("namesdata") != server_paths.end());
         server_paths["timestamp"] = base_string + ".timestamp";
         BOOST_ASSERT(server_paths.find("timestamp") != server_paths.end());
+        server_paths["levelorder"] = base_string + ".level";
+        BOOST_ASSERT(server_paths.find("levelorder") != server_paths.end());
     }
 
     // check if files are give and whether they exist at all
@@ -141,15 +144,21 @@ inline void populate_base_path(ServerPaths &server_paths)
     SimpleLogger().Write(logDEBUG) << "Index file:\t" << server_paths["fileindex"];
     SimpleLogger().Write(logDEBUG) << "Names file:\t" << server_paths["namesdata"];
     SimpleLogger().Write(logDEBUG) << "Timestamp file:\t" << server_paths["timestamp"];
+    SimpleLogger().Write(logDEBUG) << "Level order file:\t" << server_paths["levelorder"];
 }
 
 // generate boost::program_options object for the routing part
 inline unsigned GenerateServerProgramOptions(const int argc,
                                              const char *argv[],
                                              ServerPaths &paths,
+                                             QueryBudgets &query_budgets,
                                              std::string &ip_address,
                                              int &ip_port,
                                              int &requested_num_threads,
+                                             unsigned &keep_alive_timeout,
+                                             unsigned &max_keep_alive_requests,
+                                             bool &use_io_sharding,
+                                             unsigned &access_log_sampling_interval,
                                              bool &use_shared_memory,
                                              bool &trial)
 {
@@ -189,6 +198,9 @@ inline unsigned GenerateServerProgramOptions(const int argc,
         ".names file")("timestamp",
                        boost::program_options::value<boost::filesystem::path>(&paths["timestamp"]),
                        ".timestamp file")(
+        "levelorder",
+        boost::program_options::value<boost::filesystem::path>(&paths["levelorder"]),
+        ".level file")(
         "ip,i",
         boost::program_options::value<std::string>(&ip_address)->default_value("0.0.0.0"),
         "IP address")(
@@ -196,9 +208,30 @@ inline unsigned GenerateServerProgramOptions(const int argc,
         "threads,t",
         boost::program_options::value<int>(&requested_num_threads)->default_value(8),
         "Number of threads to use")(
+        "keepalive-timeout",
+        boost::program_options::value<unsigned>(&keep_alive_timeout)->default_value(5),
+        "Seconds an idle connection is kept open, 0 to close after every reply")(
+        "keepalive-requests",
+        boost::program_options::value<unsigned>(&max_keep_alive_requests)->default_value(1000),
+        "Number of requests served over one connection")(
+        "io-sharding",
+        boost::program_options::value<bool>(&use_io_sharding)->implicit_value(true),
+        "Give every thread a pinned io_service and SO_REUSEPORT acceptor of its own")(
+        "accesslog-sampling",
+        boost::program_options::value<unsigned>(&access_log_sampling_interval)->default_value(1),
+        "Log every n-th request of a thread, 0 to disable the access log")(
         "sharedmemory,s",
         boost::program_options::value<bool>(&use_shared_memory)->implicit_value(true),
-        "Load data from shared memory");
+        "Load data from shared memory")(
+        "viaroute-budget",
+        boost::program_options::value<unsigned>(&query_budgets["viaroute"])->default_value(0),
+        "Time budget of a route query in ms, 0 for none")(
+        "table-budget",
+        boost::program_options::value<unsigned>(&query_budgets["table"])->default_value(0),
+        "Time budget of a distance table query in ms, 0 for none")(
+        "isochrone-budget",
+        boost::program_options::value<unsigned>(&query_budgets["isochrone"])->default_value(0),
+        "Time budget of an isochrone query in ms, 0 for none");
 
     // hidden options, will be allowed both on command line and in config
     // file, but will not be shown to the user
@@ -177,6 +177,12 @@ inline void render(std::vector<char> &out, const Object &object)
     mapbox::util::apply_visitor(ArrayRenderer(out), value);
 }
 
+inline void render(std::vector<char> &out, const Array &array)
+{
+    ArrayRenderer renderer(out);
+    renderer(array);
+}
+
 } // namespace JSON
 
 #endif // JSON_RENDERER_HPP
@@ -40,4 +40,5 @@ namespace osrm
     // this, the compiler will copy the vtable and RTTI into every .o file that
     // #includes the header, bloating .o file sizes and increasing link times.
     void exception::anchor() const { }
+    void query_timeout::anchor() const { }
 }
@@ -47,5 +47,16 @@ class exception final : public std::exception
     const char *what() const noexcept { return message.c_str(); }
     const std::string message;
 };
+
+// thrown by searches whose query ran out of time or was cancelled
+class query_timeout final : public std::exception
+{
+  public:
+    query_timeout() = default;
+
+  private:
+    virtual void anchor() const;
+    const char *what() const noexcept { return "query time budget exceeded"; }
+};
 }
 #endif /* OSRM_EXCEPTION_HPP */
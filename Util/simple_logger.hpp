@@ -63,7 +63,8 @@ class SimpleLogger
     SimpleLogger();
 
     virtual ~SimpleLogger();
-    std::mutex &get_mutex();
+    // serializes all writes to stdout and stderr
+    static std::mutex &get_mutex();
     std::ostringstream &Write(LogLevel l = logINFO);
 
   private:
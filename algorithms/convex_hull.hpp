@@ -0,0 +1,94 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CONVEX_HULL_HPP
+#define CONVEX_HULL_HPP
+
+#include <osrm/Coordinate.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/* Computes the convex hull of a set of coordinates with Andrew's monotone chain.
+ * The hull is returned in counter-clockwise order (lon as x, lat as y) without repeating the
+ * first coordinate. Collinear and duplicate coordinates are dropped. */
+
+struct ConvexHull
+{
+    static std::vector<FixedPointCoordinate> Of(std::vector<FixedPointCoordinate> coordinates)
+    {
+        std::sort(coordinates.begin(), coordinates.end(),
+                  [](const FixedPointCoordinate &first, const FixedPointCoordinate &second)
+                  {
+            return first.lon < second.lon || (first.lon == second.lon && first.lat < second.lat);
+        });
+        coordinates.erase(std::unique(coordinates.begin(), coordinates.end()), coordinates.end());
+        if (coordinates.size() < 3)
+        {
+            return coordinates;
+        }
+
+        std::vector<FixedPointCoordinate> hull(2 * coordinates.size());
+        std::size_t hull_size = 0;
+        // lower hull
+        for (const FixedPointCoordinate &coordinate : coordinates)
+        {
+            while (hull_size >= 2 && Cross(hull[hull_size - 2], hull[hull_size - 1], coordinate) <= 0)
+            {
+                --hull_size;
+            }
+            hull[hull_size++] = coordinate;
+        }
+        // upper hull
+        const std::size_t lower_hull_size = hull_size + 1;
+        for (auto iter = coordinates.rbegin() + 1; iter != coordinates.rend(); ++iter)
+        {
+            while (hull_size >= lower_hull_size &&
+                   Cross(hull[hull_size - 2], hull[hull_size - 1], *iter) <= 0)
+            {
+                --hull_size;
+            }
+            hull[hull_size++] = *iter;
+        }
+        // the last coordinate is the first one again
+        hull.resize(hull_size - 1);
+        return hull;
+    }
+
+  private:
+    // z-component of (b - a) x (c - a), positive for a counter-clockwise turn
+    static std::int64_t Cross(const FixedPointCoordinate &a,
+                              const FixedPointCoordinate &b,
+                              const FixedPointCoordinate &c)
+    {
+        return static_cast<std::int64_t>(b.lon - a.lon) * (c.lat - a.lat) -
+               static_cast<std::int64_t>(b.lat - a.lat) * (c.lon - a.lon);
+    }
+};
+
+#endif // CONVEX_HULL_HPP
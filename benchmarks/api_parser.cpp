@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "../Server/APIParser.h"
+#include "../Util/integer_range.hpp"
+#include "../Util/simple_logger.hpp"
+#include "../Util/timing_util.hpp"
+
+#include <osrm/RouteParameters.h>
+
+#include <cstdlib>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+std::string RandomCoordinate(std::mt19937 &mt_rand)
+{
+    std::uniform_real_distribution<double> lat_udist(-85., 85.);
+    std::uniform_real_distribution<double> lon_udist(-180., 180.);
+    return std::to_string(lat_udist(mt_rand)) + "," + std::to_string(lon_udist(mt_rand));
+}
+
+// a hint has the length and alphabet of an encoded phantom node
+std::string RandomHint(std::mt19937 &mt_rand)
+{
+    const std::string alphabet("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+    std::uniform_int_distribution<std::size_t> character_udist(0, alphabet.size() - 1);
+    std::string hint;
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+        hint.push_back(alphabet[character_udist(mt_rand)]);
+    }
+    return hint;
+}
+
+void Benchmark(const std::string &name, const std::vector<std::string> &uris)
+{
+    // the checksum keeps the compiler from optimizing the parsing away
+    std::size_t checksum = 0;
+    TIMER_START(parse);
+    for (const std::string &uri : uris)
+    {
+        RouteParameters route_parameters;
+        APIParser api_parser(route_parameters);
+        std::size_t position = 0;
+        if (!api_parser.Parse(uri, position))
+        {
+            std::cout << "could not parse " << uri << " at position " << position << "\n";
+            return;
+        }
+        checksum += route_parameters.coordinates.size() + route_parameters.hints.size();
+    }
+    TIMER_STOP(parse);
+
+    std::cout << "#### " << name << "\n";
+    std::cout << "Took " << TIMER_MSEC(parse) << " msec for " << uris.size()
+              << " requests (checksum " << checksum << ")."
+              << "\n";
+    std::cout << 1000. * TIMER_MSEC(parse) / uris.size() << " usec/request."
+              << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    LogPolicy::GetInstance().Unmute();
+    const unsigned number_of_requests = (argc > 1 ? std::atoi(argv[1]) : 100000);
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::vector<std::string> nearest_uris, viaroute_uris, table_uris;
+    for (const auto i : osrm::irange(0u, number_of_requests))
+    {
+        nearest_uris.emplace_back("/nearest?loc=" + RandomCoordinate(mt_rand));
+
+        // every other route request comes with hints and percent escaped commas
+        std::string viaroute_uri("/viaroute?z=14&output=json&instructions=true");
+        for (unsigned j = 0; j < 3; ++j)
+        {
+            std::string coordinate = RandomCoordinate(mt_rand);
+            if (0 == i % 2)
+            {
+                coordinate.replace(coordinate.find(','), 1, "%2C");
+            }
+            viaroute_uri += "&loc=" + coordinate;
+            if (0 == i % 2)
+            {
+                viaroute_uri += "&hint=" + RandomHint(mt_rand);
+            }
+        }
+        viaroute_uris.emplace_back(std::move(viaroute_uri));
+
+        // table requests are parsed 100 times less often, but are a 100 times longer
+        if (0 == i % 100)
+        {
+            std::string table_uri("/table?");
+            for (const auto j : osrm::irange(0u, 100u))
+            {
+                table_uri += (0 == j ? "loc=" : "&loc=") + RandomCoordinate(mt_rand);
+            }
+            table_uris.emplace_back(std::move(table_uri));
+        }
+    }
+
+    Benchmark("nearest, 1 coordinate", nearest_uris);
+    Benchmark("viaroute, 3 coordinates", viaroute_uris);
+    Benchmark("table, 100 coordinates", table_uris);
+
+    return 0;
+}
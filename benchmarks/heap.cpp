@@ -0,0 +1,242 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#include "../data_structures/binary_heap.hpp"
+#include "../data_structures/query_edge.hpp"
+#include "../data_structures/radix_heap.hpp"
+#include "../data_structures/search_engine_data.hpp"
+#include "../data_structures/static_graph.hpp"
+#include "../Util/graph_loader.hpp"
+#include "../Util/integer_range.hpp"
+#include "../Util/osrm_exception.hpp"
+#include "../Util/simple_logger.hpp"
+#include "../Util/timing_util.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+
+using EdgeData = QueryEdge::EdgeData;
+using QueryGraph = StaticGraph<EdgeData>;
+
+struct HeapOperation
+{
+    enum OperationType : unsigned char
+    {
+        Clear,
+        Insert,
+        DecreaseKey,
+        DeleteMin,
+        WasInserted
+    };
+
+    HeapOperation(OperationType type, NodeID node, int weight)
+        : type(type), node(node), weight(weight)
+    {
+    }
+
+    OperationType type;
+    NodeID node;
+    int weight;
+};
+
+// Runs upward CH searches with stall-on-demand, the way RoutingStep does,
+// and records every heap operation they issue.
+std::vector<HeapOperation>
+RecordTrace(const QueryGraph &graph, const unsigned number_of_queries, std::size_t &settled_nodes)
+{
+    using TraceHeap = BinaryHeap<NodeID, NodeID, int, HeapData, ArrayStorage<NodeID, NodeID>>;
+    TraceHeap heap(graph.GetNumberOfNodes());
+    std::vector<HeapOperation> trace;
+
+    std::mt19937 mt_rand(RANDOM_SEED);
+    std::uniform_int_distribution<NodeID> node_udist(0, graph.GetNumberOfNodes() - 1);
+    settled_nodes = 0;
+
+    for (const auto query : osrm::irange(0u, number_of_queries))
+    {
+        const bool forward_direction = (0 == query % 2);
+        const NodeID source = node_udist(mt_rand);
+
+        heap.Clear();
+        trace.emplace_back(HeapOperation::Clear, SPECIAL_NODEID, 0);
+        heap.Insert(source, 0, source);
+        trace.emplace_back(HeapOperation::Insert, source, 0);
+
+        while (!heap.Empty())
+        {
+            const NodeID node = heap.DeleteMin();
+            const int distance = heap.GetKey(node);
+            trace.emplace_back(HeapOperation::DeleteMin, node, distance);
+            ++settled_nodes;
+
+            bool stalled = false;
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const EdgeData &data = graph.GetEdgeData(edge);
+                if (forward_direction ? data.backward : data.forward)
+                {
+                    const NodeID to = graph.GetTarget(edge);
+                    trace.emplace_back(HeapOperation::WasInserted, to, 0);
+                    if (heap.WasInserted(to) && heap.GetKey(to) + data.distance < distance)
+                    {
+                        stalled = true;
+                        break;
+                    }
+                }
+            }
+            if (stalled)
+            {
+                continue;
+            }
+
+            for (const auto edge : graph.GetAdjacentEdgeRange(node))
+            {
+                const EdgeData &data = graph.GetEdgeData(edge);
+                if (forward_direction ? data.forward : data.backward)
+                {
+                    const NodeID to = graph.GetTarget(edge);
+                    const int to_distance = distance + data.distance;
+                    trace.emplace_back(HeapOperation::WasInserted, to, 0);
+                    if (!heap.WasInserted(to))
+                    {
+                        heap.Insert(to, to_distance, node);
+                        trace.emplace_back(HeapOperation::Insert, to, to_distance);
+                    }
+                    else if (to_distance < heap.GetKey(to))
+                    {
+                        heap.GetData(to).parent = node;
+                        heap.DecreaseKey(to, to_distance);
+                        trace.emplace_back(HeapOperation::DecreaseKey, to, to_distance);
+                    }
+                }
+            }
+        }
+    }
+    return trace;
+}
+
+template <typename HeapT>
+void Replay(const std::string &name,
+            const std::vector<HeapOperation> &trace,
+            const unsigned number_of_nodes,
+            const unsigned number_of_queries)
+{
+    HeapT heap(number_of_nodes);
+
+    // the checksum keeps the compiler from optimizing the replay away
+    std::size_t checksum = 0;
+    TIMER_START(replay);
+    for (const HeapOperation &operation : trace)
+    {
+        switch (operation.type)
+        {
+        case HeapOperation::Clear:
+            heap.Clear();
+            break;
+        case HeapOperation::Insert:
+            heap.Insert(operation.node, operation.weight, operation.node);
+            break;
+        case HeapOperation::DecreaseKey:
+            heap.DecreaseKey(operation.node, operation.weight);
+            break;
+        case HeapOperation::DeleteMin:
+            checksum += heap.DeleteMin();
+            break;
+        case HeapOperation::WasInserted:
+            checksum += heap.WasInserted(operation.node);
+            break;
+        }
+    }
+    TIMER_STOP(replay);
+
+    std::cout << "#### " << name << "\n";
+    std::cout << "Took " << TIMER_MSEC(replay) << " msec for " << number_of_queries
+              << " searches (checksum " << checksum << ")."
+              << "\n";
+    std::cout << TIMER_MSEC(replay) / ((double)number_of_queries) << " msec/search."
+              << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    LogPolicy::GetInstance().Unmute();
+    if (argc < 2)
+    {
+        std::cout << "./heap-bench file.hsgr [number of searches]"
+                  << "\n";
+        return 1;
+    }
+
+    try
+    {
+        const unsigned number_of_queries = (argc > 2 ? std::atoi(argv[2]) : 1000);
+
+        std::vector<QueryGraph::NodeArrayEntry> node_list;
+        std::vector<QueryGraph::EdgeArrayEntry> edge_list;
+        unsigned check_sum = 0;
+        const unsigned number_of_nodes =
+            readHSGRFromStream(boost::filesystem::path(argv[1]), node_list, edge_list, &check_sum);
+        QueryGraph graph(node_list, edge_list);
+
+        std::size_t settled_nodes = 0;
+        const auto trace = RecordTrace(graph, number_of_queries, settled_nodes);
+        std::cout << "Recorded " << trace.size() << " heap operations, " << settled_nodes
+                  << " settled nodes in " << number_of_queries << " searches."
+                  << "\n";
+
+        using HashStorage = UnorderedMapStorage<NodeID, int>;
+        using ArrayIndex = TimestampedArrayStorage<NodeID, int>;
+
+        Replay<BinaryHeap<NodeID, NodeID, int, HeapData, HashStorage>>(
+            "binary heap, hash storage", trace, number_of_nodes, number_of_queries);
+        Replay<BinaryHeap<NodeID, NodeID, int, HeapData, ArrayIndex>>(
+            "binary heap, timestamped array storage", trace, number_of_nodes, number_of_queries);
+        Replay<BinaryHeap<NodeID, NodeID, int, HeapData, ArrayIndex, 4>>(
+            "4-ary heap, timestamped array storage", trace, number_of_nodes, number_of_queries);
+        Replay<BinaryHeap<NodeID, NodeID, int, HeapData, ArrayIndex, 8>>(
+            "8-ary heap, timestamped array storage", trace, number_of_nodes, number_of_queries);
+        Replay<RadixHeap<NodeID, NodeID, int, HeapData, ArrayIndex>>(
+            "radix heap, timestamped array storage", trace, number_of_nodes, number_of_queries);
+    }
+    catch (const std::exception &e)
+    {
+        SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "../data_structures/binary_heap.hpp"
+#include "../data_structures/query_edge.hpp"
+#include "../data_structures/search_engine_data.hpp"
+#include "../data_structures/static_graph.hpp"
+#include "../Util/graph_loader.hpp"
+#include "../Util/integer_range.hpp"
+#include "../Util/osrm_exception.hpp"
+#include "../Util/simple_logger.hpp"
+#include "../Util/timing_util.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Choosen by a fair W20 dice roll (this value is completely arbitrary)
+constexpr unsigned RANDOM_SEED = 13;
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+using EdgeData = QueryEdge::EdgeData;
+using QueryGraph = StaticGraph<EdgeData>;
+using QueryHeap = BinaryHeap<NodeID, NodeID, int, HeapData, TimestampedArrayStorage<NodeID, int>>;
+
+// Records the distinct cache lines of the node array, the edge array and the heap index that a
+// search touches. On a cold cache this is the number of misses the search causes.
+class CacheLineCounter
+{
+  public:
+    void Clear() { cache_lines.clear(); }
+
+    void TouchNode(const NodeID node)
+    {
+        cache_lines.insert(Line(NodeArray, node * sizeof(QueryGraph::NodeArrayEntry)));
+        cache_lines.insert(Line(HeapIndex, node * sizeof(std::pair<int, unsigned>)));
+    }
+
+    void TouchEdge(const EdgeID edge)
+    {
+        cache_lines.insert(Line(EdgeArray, edge * sizeof(QueryGraph::EdgeArrayEntry)));
+    }
+
+    std::size_t Size() const { return cache_lines.size(); }
+
+  private:
+    enum Array : uint64_t
+    {
+        NodeArray,
+        EdgeArray,
+        HeapIndex
+    };
+
+    static uint64_t Line(const Array array, const uint64_t offset)
+    {
+        return (static_cast<uint64_t>(array) << 56) | (offset / CACHE_LINE_SIZE);
+    }
+
+    std::unordered_set<uint64_t> cache_lines;
+};
+
+// does not record anything, used for the timed runs
+struct NoCounter
+{
+    void TouchNode(const NodeID) {}
+    void TouchEdge(const EdgeID) {}
+};
+
+template <typename CounterT>
+void RoutingStep(const QueryGraph &graph,
+                 QueryHeap &heap,
+                 QueryHeap &opposite_heap,
+                 const bool forward_direction,
+                 int &upper_bound,
+                 CounterT &counter)
+{
+    const NodeID node = heap.DeleteMin();
+    const int distance = heap.GetKey(node);
+    counter.TouchNode(node);
+
+    if (opposite_heap.WasInserted(node))
+    {
+        const int new_distance = opposite_heap.GetKey(node) + distance;
+        upper_bound = std::min(upper_bound, new_distance);
+    }
+
+    // stall-on-demand
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        counter.TouchEdge(edge);
+        const EdgeData &data = graph.GetEdgeData(edge);
+        if (forward_direction ? data.backward : data.forward)
+        {
+            const NodeID to = graph.GetTarget(edge);
+            counter.TouchNode(to);
+            if (heap.WasInserted(to) && heap.GetKey(to) + data.distance < distance)
+            {
+                return;
+            }
+        }
+    }
+
+    for (const auto edge : graph.GetAdjacentEdgeRange(node))
+    {
+        const EdgeData &data = graph.GetEdgeData(edge);
+        if (forward_direction ? data.forward : data.backward)
+        {
+            const NodeID to = graph.GetTarget(edge);
+            const int to_distance = distance + data.distance;
+            counter.TouchNode(to);
+            if (!heap.WasInserted(to))
+            {
+                heap.Insert(to, to_distance, node);
+            }
+            else if (to_distance < heap.GetKey(to))
+            {
+                heap.GetData(to).parent = node;
+                heap.DecreaseKey(to, to_distance);
+            }
+        }
+    }
+}
+
+template <typename CounterT>
+int Query(const QueryGraph &graph,
+          QueryHeap &forward_heap,
+          QueryHeap &reverse_heap,
+          const NodeID source,
+          const NodeID target,
+          CounterT &counter)
+{
+    forward_heap.Clear();
+    reverse_heap.Clear();
+    forward_heap.Insert(source, 0, source);
+    reverse_heap.Insert(target, 0, target);
+
+    int upper_bound = INVALID_EDGE_WEIGHT;
+    while (!forward_heap.Empty() || !reverse_heap.Empty())
+    {
+        if (!forward_heap.Empty())
+        {
+            if (forward_heap.GetKey(forward_heap.Min()) >= upper_bound)
+            {
+                forward_heap.DeleteAll();
+            }
+            else
+            {
+                RoutingStep(graph, forward_heap, reverse_heap, true, upper_bound, counter);
+            }
+        }
+        if (!reverse_heap.Empty())
+        {
+            if (reverse_heap.GetKey(reverse_heap.Min()) >= upper_bound)
+            {
+                reverse_heap.DeleteAll();
+            }
+            else
+            {
+                RoutingStep(graph, reverse_heap, forward_heap, false, upper_bound, counter);
+            }
+        }
+    }
+    return upper_bound;
+}
+
+// Renumbers the graph with new_node_ids[old] = new, the edges of each node keep their order.
+void Renumber(const std::vector<NodeID> &new_node_ids,
+              std::vector<QueryGraph::NodeArrayEntry> &node_list,
+              std::vector<QueryGraph::EdgeArrayEntry> &edge_list)
+{
+    const unsigned number_of_nodes = static_cast<unsigned>(node_list.size() - 1);
+    std::vector<NodeID> old_node_ids(number_of_nodes);
+    for (const auto node : osrm::irange(0u, number_of_nodes))
+    {
+        old_node_ids[new_node_ids[node]] = node;
+    }
+
+    std::vector<QueryGraph::NodeArrayEntry> new_node_list(node_list.size());
+    std::vector<QueryGraph::EdgeArrayEntry> new_edge_list;
+    new_edge_list.reserve(edge_list.size());
+    for (const auto new_node : osrm::irange(0u, number_of_nodes))
+    {
+        const NodeID old_node = old_node_ids[new_node];
+        new_node_list[new_node].first_edge = static_cast<EdgeID>(new_edge_list.size());
+        for (const auto edge : osrm::irange(node_list[old_node].first_edge,
+                                            node_list[old_node + 1].first_edge))
+        {
+            new_edge_list.push_back(edge_list[edge]);
+            new_edge_list.back().target = new_node_ids[edge_list[edge].target];
+        }
+    }
+    new_node_list[number_of_nodes].first_edge = static_cast<EdgeID>(new_edge_list.size());
+
+    node_list.swap(new_node_list);
+    edge_list.swap(new_edge_list);
+}
+
+void Benchmark(const std::string &name,
+               const QueryGraph &graph,
+               const std::vector<std::pair<NodeID, NodeID>> &queries)
+{
+    QueryHeap forward_heap(graph.GetNumberOfNodes());
+    QueryHeap reverse_heap(graph.GetNumberOfNodes());
+
+    // the checksum also shows that both numberings compute the same distances
+    std::size_t checksum = 0;
+    NoCounter no_counter;
+    TIMER_START(queries);
+    for (const auto &query : queries)
+    {
+        checksum += Query(graph, forward_heap, reverse_heap, query.first, query.second, no_counter);
+    }
+    TIMER_STOP(queries);
+
+    std::size_t cache_lines = 0;
+    CacheLineCounter counter;
+    for (const auto &query : queries)
+    {
+        counter.Clear();
+        Query(graph, forward_heap, reverse_heap, query.first, query.second, counter);
+        cache_lines += counter.Size();
+    }
+
+    std::cout << "#### " << name << "\n";
+    std::cout << "Took " << TIMER_MSEC(queries) << " msec for " << queries.size()
+              << " queries (checksum " << checksum << ")."
+              << "\n";
+    std::cout << TIMER_MSEC(queries) / ((double)queries.size()) << " msec/query."
+              << "\n";
+    std::cout << cache_lines / ((double)queries.size()) << " distinct cache lines/query."
+              << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    LogPolicy::GetInstance().Unmute();
+    if (argc < 2)
+    {
+        std::cout << "./node-order-bench file.hsgr [number of queries]"
+                  << "\n";
+        return 1;
+    }
+
+    try
+    {
+        const unsigned number_of_queries = (argc > 2 ? std::atoi(argv[2]) : 1000);
+
+        std::vector<QueryGraph::NodeArrayEntry> node_list;
+        std::vector<QueryGraph::EdgeArrayEntry> edge_list;
+        unsigned check_sum = 0;
+        readHSGRFromStream(boost::filesystem::path(argv[1]), node_list, edge_list, &check_sum);
+        const unsigned number_of_nodes = static_cast<unsigned>(node_list.size() - 1);
+
+        std::mt19937 mt_rand(RANDOM_SEED);
+        std::uniform_int_distribution<NodeID> node_udist(0, number_of_nodes - 1);
+        std::vector<std::pair<NodeID, NodeID>> queries;
+        for (const auto i : osrm::irange(0u, number_of_queries))
+        {
+            static_cast<void>(i);
+            queries.emplace_back(node_udist(mt_rand), node_udist(mt_rand));
+        }
+
+        // a random numbering stands in for a graph without any locality
+        std::vector<NodeID> random_node_ids(number_of_nodes);
+        std::iota(random_node_ids.begin(), random_node_ids.end(), 0);
+        std::shuffle(random_node_ids.begin(), random_node_ids.end(), mt_rand);
+        std::vector<QueryGraph::NodeArrayEntry> random_node_list(node_list);
+        std::vector<QueryGraph::EdgeArrayEntry> random_edge_list(edge_list);
+        Renumber(random_node_ids, random_node_list, random_edge_list);
+        std::vector<std::pair<NodeID, NodeID>> random_queries;
+        for (const auto &query : queries)
+        {
+            random_queries.emplace_back(random_node_ids[query.first],
+                                        random_node_ids[query.second]);
+        }
+
+        const QueryGraph graph(node_list, edge_list);
+        Benchmark("numbering of the data set", graph, queries);
+        const QueryGraph random_graph(random_node_list, random_edge_list);
+        Benchmark("random numbering", random_graph, random_queries);
+    }
+    catch (const std::exception &e)
+    {
+        SimpleLogger().Write(logWARNING) << "[exception] " << e.what();
+        return 1;
+    }
+
+    return 0;
+}
@@ -306,6 +306,8 @@ class Contractor
         std::vector<RemainingNodeData> remaining_nodes(number_of_nodes);
         std::vector<float> node_priorities(number_of_nodes);
         std::vector<NodePriorityData> node_data(number_of_nodes);
+        node_levels.assign(number_of_nodes, 0);
+        unsigned current_level = 0;
 
 
         // initialize priorities in parallel
@@ -446,6 +448,14 @@ class Contractor
                                                 { return !node_data.is_independent; });
             const int first_independent_node = static_cast<int>(first - remaining_nodes.begin());
 
+            // remember the level of the independent nodes in terms of the original node ids
+            for (const auto position : osrm::irange(first_independent_node, last))
+            {
+                const NodeID x = remaining_nodes[position].id;
+                node_levels[flushed_contractor ? orig_node_id_to_new_id_map[x] : x] = current_level;
+            }
+            ++current_level;
+
             // contract independent nodes
             tbb::parallel_for(tbb::blocked_range<int>(first_independent_node, last, ContractGrainSize),
                 [this, &remaining_nodes, &thread_data_list](const tbb::blocked_range<int>& range)
@@ -605,6 +615,14 @@ class Contractor
         external_edge_list.clear();
     }
 
+    // Every edge of the contracted graph leads from a node to a node of a strictly higher level,
+    // so processing nodes by descending level is a topological order of the downward graph.
+    inline void GetNodeLevels(std::vector<unsigned> &levels)
+    {
+        levels.swap(node_levels);
+        node_levels.clear();
+    }
+
   private:
     inline void Dijkstra(const int max_distance,
                          const unsigned number_of_targets,
@@ -966,6 +984,8 @@ class Contractor
     std::vector<ContractorGraph::InputEdge> contracted_edge_list;
     stxxl::vector<QueryEdge> external_edge_list;
     std::vector<NodeID> orig_node_id_to_new_id_map;
+    // round of the independent set in which each (original) node was contracted
+    std::vector<unsigned> node_levels;
     XORFastHash fast_hash;
 };
 
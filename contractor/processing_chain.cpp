@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../algorithms/crc32_processor.hpp"
 #include "../data_structures/deallocating_vector.hpp"
+#include "../data_structures/hilbert_value.hpp"
 #include "../data_structures/static_rtree.hpp"
 #include "../data_structures/restriction_map.hpp"
 
@@ -51,8 +52,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <tbb/task_scheduler_init.h>
 #include <tbb/parallel_sort.h>
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <thread>
 #include <vector>
@@ -115,6 +119,7 @@ int Prepare::Process(int argc, char *argv[])
     edge_out = input_path.string() + ".edges";
     geometry_filename = input_path.string() + ".geometry";
     graph_out = input_path.string() + ".hsgr";
+    level_out = input_path.string() + ".level";
     rtree_nodes_path = input_path.string() + ".ramIndex";
     rtree_leafs_path = input_path.string() + ".fileIndex";
 
@@ -171,6 +176,8 @@ int Prepare::Process(int argc, char *argv[])
 
     TIMER_STOP(expansion);
 
+    RenumberEdgeBasedNodes(number_of_edge_based_nodes, node_based_edge_list, edge_based_edge_list);
+
     BuildRTree(node_based_edge_list);
 
     RangebasedCRC32 crc32;
@@ -204,6 +211,10 @@ int Prepare::Process(int argc, char *argv[])
 
     SimpleLogger().Write() << "Contraction took " << TIMER_SEC(contraction) << " sec";
 
+    std::vector<unsigned> node_levels;
+    contractor->GetNodeLevels(node_levels);
+    WriteLevelOrder(node_levels);
+
     DeallocatingVector<QueryEdge> contracted_edge_list;
     contractor->GetEdges(contracted_edge_list);
     contractor.reset();
@@ -547,6 +558,79 @@ Prepare::BuildEdgeExpandedGraph(lua_State *lua_state,
     return number_of_edge_based_nodes;
 }
 
+/**
+    \brief Renumbering the edge-based nodes along the Hilbert curve
+
+    The edge-based graph factory numbers nodes in no particular spatial order. Nodes that are
+    close on the map are likely to be settled by the same searches, so giving them close IDs
+    keeps the node and edge arrays of the contracted graph cache friendly. Only the graph and
+    the r-tree leaves store edge-based node IDs, the .edges, .nodes and .geometry files are
+    indexed by edge-based edge IDs and node-based node IDs and stay untouched.
+ */
+void Prepare::RenumberEdgeBasedNodes(const unsigned number_of_edge_based_nodes,
+                                     std::vector<EdgeBasedNode> &node_based_edge_list,
+                                     DeallocatingVector<EdgeBasedEdge> &edge_based_edge_list)
+{
+    SimpleLogger().Write() << "renumbering edge-based nodes ...";
+
+    // a node is represented by the smallest Hilbert value of its segments
+    std::vector<uint64_t> hilbert_values(number_of_edge_based_nodes,
+                                         std::numeric_limits<uint64_t>::max());
+    HilbertCode get_hilbert_number;
+    for (const EdgeBasedNode &segment : node_based_edge_list)
+    {
+        const uint64_t hilbert_value = get_hilbert_number(EdgeBasedNode::Centroid(
+            FixedPointCoordinate(internal_to_external_node_map[segment.u].lat,
+                                 internal_to_external_node_map[segment.u].lon),
+            FixedPointCoordinate(internal_to_external_node_map[segment.v].lat,
+                                 internal_to_external_node_map[segment.v].lon)));
+        for (const NodeID node : {segment.forward_edge_based_node_id,
+                                  segment.reverse_edge_based_node_id})
+        {
+            if (SPECIAL_NODEID != node)
+            {
+                BOOST_ASSERT(node < number_of_edge_based_nodes);
+                hilbert_values[node] = std::min(hilbert_values[node], hilbert_value);
+            }
+        }
+    }
+
+    std::vector<NodeID> hilbert_order(number_of_edge_based_nodes);
+    std::iota(hilbert_order.begin(), hilbert_order.end(), 0);
+    tbb::parallel_sort(hilbert_order.begin(), hilbert_order.end(),
+                       [&hilbert_values](const NodeID first, const NodeID second)
+                       {
+        if (hilbert_values[first] != hilbert_values[second])
+        {
+            return hilbert_values[first] < hilbert_values[second];
+        }
+        return first < second;
+    });
+
+    std::vector<NodeID> new_node_ids(number_of_edge_based_nodes);
+    for (const auto position : osrm::irange(0u, number_of_edge_based_nodes))
+    {
+        new_node_ids[hilbert_order[position]] = position;
+    }
+
+    for (EdgeBasedNode &segment : node_based_edge_list)
+    {
+        if (SPECIAL_NODEID != segment.forward_edge_based_node_id)
+        {
+            segment.forward_edge_based_node_id = new_node_ids[segment.forward_edge_based_node_id];
+        }
+        if (SPECIAL_NODEID != segment.reverse_edge_based_node_id)
+        {
+            segment.reverse_edge_based_node_id = new_node_ids[segment.reverse_edge_based_node_id];
+        }
+    }
+    for (EdgeBasedEdge &edge : edge_based_edge_list)
+    {
+        edge.source = new_node_ids[edge.source];
+        edge.target = new_node_ids[edge.target];
+    }
+}
+
 /**
   \brief Writing info on original (node-based) nodes
  */
@@ -566,6 +650,37 @@ void Prepare::WriteNodeMapping()
     internal_to_external_node_map.shrink_to_fit();
 }
 
+/**
+    \brief Writing the nodes of the contracted graph by descending contraction level
+
+    Saves info to file: '.level'. Sweeping over the nodes in this order visits every node after
+    all nodes it has a downward edge from, which is what one-to-all (PHAST) queries need.
+ */
+void Prepare::WriteLevelOrder(const std::vector<unsigned> &node_levels)
+{
+    SimpleLogger().Write() << "writing level order ...";
+    std::vector<NodeID> level_order(node_levels.size());
+    std::iota(level_order.begin(), level_order.end(), 0);
+    tbb::parallel_sort(level_order.begin(), level_order.end(),
+                       [&node_levels](const NodeID first, const NodeID second)
+                       {
+        if (node_levels[first] != node_levels[second])
+        {
+            return node_levels[first] > node_levels[second];
+        }
+        return first < second;
+    });
+
+    boost::filesystem::ofstream level_stream(level_out, std::ios::binary);
+    const unsigned number_of_nodes = level_order.size();
+    level_stream.write((char *)&number_of_nodes, sizeof(unsigned));
+    if (number_of_nodes > 0)
+    {
+        level_stream.write((char *)&(level_order[0]), number_of_nodes * sizeof(NodeID));
+    }
+    level_stream.close();
+}
+
 /**
     \brief Building rtree-based nearest-neighbor data structure
 
@@ -66,7 +66,11 @@ class Prepare
                                        std::vector<EdgeBasedNode> &nodeBasedEdgeList,
                                        DeallocatingVector<EdgeBasedEdge> &edgeBasedEdgeList,
                                        EdgeBasedGraphFactory::SpeedProfileProperties &speed_profile);
+    void RenumberEdgeBasedNodes(const unsigned number_of_edge_based_nodes,
+                                std::vector<EdgeBasedNode> &node_based_edge_list,
+                                DeallocatingVector<EdgeBasedEdge> &edge_based_edge_list);
     void WriteNodeMapping();
+    void WriteLevelOrder(const std::vector<unsigned> &node_levels);
     void BuildRTree(std::vector<EdgeBasedNode> &node_based_edge_list);
 
   private:
@@ -88,6 +92,7 @@ class Prepare
     std::string info_out;
     std::string geometry_filename;
     std::string graph_out;
+    std::string level_out;
     std::string rtree_nodes_path;
     std::string rtree_leafs_path;
 };
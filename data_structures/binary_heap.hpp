@@ -31,8 +31,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <map>
+#include <new>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -50,6 +52,8 @@ template <typename NodeID, typename Key> class ArrayStorage
 
     Key &operator[](NodeID node) { return positions[node]; }
 
+    Key operator[](NodeID node) const { return positions[node]; }
+
     void Clear() {}
 
   private:
@@ -63,6 +67,12 @@ template <typename NodeID, typename Key> class MapStorage
 
     Key &operator[](NodeID node) { return nodes[node]; }
 
+    Key operator[](NodeID node) const
+    {
+        const auto iter = nodes.find(node);
+        return nodes.end() == iter ? std::numeric_limits<Key>::max() : iter->second;
+    }
+
     void Clear() { nodes.clear(); }
 
   private:
@@ -76,10 +86,10 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
 
     Key &operator[](const NodeID node) { return nodes[node]; }
 
-    Key const &operator[](const NodeID node) const
+    Key operator[](const NodeID node) const
     {
-        auto iter = nodes.find(node);
-        return iter->second;
+        const auto iter = nodes.find(node);
+        return nodes.end() == iter ? std::numeric_limits<Key>::max() : iter->second;
     }
 
     void Clear() { nodes.clear(); }
@@ -88,14 +98,123 @@ template <typename NodeID, typename Key> class UnorderedMapStorage
     std::unordered_map<NodeID, Key> nodes;
 };
 
+// Dense array storage that is cleared in O(1) by bumping a generation counter.
+// Cells that were written in an earlier generation read as 'not inserted'.
+template <typename NodeID, typename Key> class TimestampedArrayStorage
+{
+  public:
+    explicit TimestampedArrayStorage(size_t size) : cells(size), current_timestamp(1) {}
+
+    Key &operator[](const NodeID node)
+    {
+        if (node >= cells.size())
+        {
+            // the data set was swapped for a larger one, e.g. by osrm-datastore
+            cells.resize(node + 1);
+        }
+        StorageCell &cell = cells[node];
+        if (cell.time != current_timestamp)
+        {
+            cell.key = std::numeric_limits<Key>::max();
+            cell.time = current_timestamp;
+        }
+        return cell.key;
+    }
+
+    Key operator[](const NodeID node) const
+    {
+        if (node >= cells.size() || cells[node].time != current_timestamp)
+        {
+            return std::numeric_limits<Key>::max();
+        }
+        return cells[node].key;
+    }
+
+    void Clear()
+    {
+        ++current_timestamp;
+        if (std::numeric_limits<unsigned>::max() == current_timestamp)
+        {
+            std::fill(cells.begin(), cells.end(), StorageCell());
+            current_timestamp = 1;
+        }
+    }
+
+  private:
+    struct StorageCell
+    {
+        StorageCell() : key(std::numeric_limits<Key>::max()), time(0) {}
+        Key key;
+        unsigned time;
+    };
+
+    std::vector<StorageCell> cells;
+    unsigned current_timestamp;
+};
+
+// Allocator for vectors whose first element starts on a cache line boundary. Every allocation
+// is padded, the pointer that ::operator new returned is kept in front of the aligned block.
+template <typename T> class CacheAlignedAllocator
+{
+  public:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U> CacheAlignedAllocator(const CacheAlignedAllocator<U> &) {}
+
+    T *allocate(const std::size_t n)
+    {
+        void *block = ::operator new(n * sizeof(T) + sizeof(void *) + CACHE_LINE_SIZE - 1);
+        const std::uintptr_t aligned_address =
+            (reinterpret_cast<std::uintptr_t>(block) + sizeof(void *) + CACHE_LINE_SIZE - 1) &
+            ~static_cast<std::uintptr_t>(CACHE_LINE_SIZE - 1);
+        void **aligned_block = reinterpret_cast<void **>(aligned_address);
+        aligned_block[-1] = block;
+        return reinterpret_cast<T *>(aligned_block);
+    }
+
+    void deallocate(T *aligned_block, std::size_t) noexcept
+    {
+        ::operator delete(reinterpret_cast<void **>(aligned_block)[-1]);
+    }
+
+    template <typename U> struct rebind
+    {
+        using other = CacheAlignedAllocator<U>;
+    };
+};
+
+template <typename T, typename U>
+bool operator==(const CacheAlignedAllocator<T> &, const CacheAlignedAllocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const CacheAlignedAllocator<T> &, const CacheAlignedAllocator<U> &)
+{
+    return false;
+}
+
+// Implicit d-ary heap. The arity defaults to a plain binary heap, larger values make the heap
+// shallower and keep all children of a heap element next to each other in memory. The root is
+// stored at index Arity - 1, so that every group of children starts at a multiple of Arity.
+// As the storage is cache line aligned, every group lies within a single cache line only if
+// Arity * sizeof(HeapElement) divides the cache line size, e.g. 4-ary or 8-ary with 8 byte
+// elements. Otherwise groups may straddle two lines, e.g. 3-ary groups start at byte 0, 24, 48.
 template <typename NodeID,
           typename Key,
           typename Weight,
           typename Data,
-          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>,
+          unsigned Arity = 2>
 class BinaryHeap
 {
   private:
+    static_assert(Arity >= 2, "heap arity must be at least two");
+
     BinaryHeap(const BinaryHeap &right);
     void operator=(const BinaryHeap &right);
 
@@ -107,13 +226,12 @@ class BinaryHeap
 
     void Clear()
     {
-        heap.resize(1);
+        ClearHeap();
         inserted_nodes.clear();
-        heap[0].weight = std::numeric_limits<Weight>::min();
         node_index.Clear();
     }
 
-    std::size_t Size() const { return (heap.size() - 1); }
+    std::size_t Size() const { return (heap.size() - ROOT); }
 
     bool Empty() const { return 0 == Size(); }
 
@@ -148,6 +266,12 @@ class BinaryHeap
         return inserted_nodes[index].weight;
     }
 
+    Weight const &GetKey(NodeID node) const
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
     bool WasRemoved(const NodeID node)
     {
         BOOST_ASSERT(WasInserted(node));
@@ -165,21 +289,32 @@ class BinaryHeap
         return inserted_nodes[index].node == node;
     }
 
+    // does not touch the index storage, so several threads may query a heap nobody modifies
+    bool WasInserted(const NodeID node) const
+    {
+        const Key index = node_index[node];
+        if (index >= static_cast<Key>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
     NodeID Min() const
     {
-        BOOST_ASSERT(heap.size() > 1);
-        return inserted_nodes[heap[1].index].node;
+        BOOST_ASSERT(heap.size() > ROOT);
+        return inserted_nodes[heap[ROOT].index].node;
     }
 
     NodeID DeleteMin()
     {
-        BOOST_ASSERT(heap.size() > 1);
-        const Key removedIndex = heap[1].index;
-        heap[1] = heap[heap.size() - 1];
+        BOOST_ASSERT(heap.size() > ROOT);
+        const Key removedIndex = heap[ROOT].index;
+        heap[ROOT] = heap[heap.size() - 1];
         heap.pop_back();
-        if (heap.size() > 1)
+        if (heap.size() > ROOT)
         {
-            Downheap(1);
+            Downheap(ROOT);
         }
         inserted_nodes[removedIndex].key = 0;
         CheckHeap();
@@ -189,12 +324,11 @@ class BinaryHeap
     void DeleteAll()
     {
         auto iend = heap.end();
-        for (typename std::vector<HeapElement>::iterator i = heap.begin() + 1; i != iend; ++i)
+        for (auto i = heap.begin() + ROOT; i != iend; ++i)
         {
             inserted_nodes[i->index].key = 0;
         }
-        heap.resize(1);
-        heap[0].weight = (std::numeric_limits<Weight>::min)();
+        ClearHeap();
     }
 
     void DecreaseKey(NodeID node, Weight weight)
@@ -227,22 +361,41 @@ class BinaryHeap
         Weight weight;
     };
 
+    // the elements in front of the root are sentinels with minimal weight, no key is 0
+    static constexpr Key ROOT = Arity - 1;
+
     std::vector<HeapNode> inserted_nodes;
-    std::vector<HeapElement> heap;
+    std::vector<HeapElement, CacheAlignedAllocator<HeapElement>> heap;
     IndexStorage node_index;
 
+    static inline Key FirstChild(const Key key) { return Arity * (key - Arity + 2); }
+
+    // the parent of the root is the sentinel in front of it
+    static inline Key Parent(const Key key) { return key / Arity + Arity - 2; }
+
+    void ClearHeap()
+    {
+        HeapElement sentinel;
+        sentinel.index = 0;
+        sentinel.weight = (std::numeric_limits<Weight>::min)();
+        heap.assign(ROOT, sentinel);
+    }
+
     void Downheap(Key key)
     {
         const Key droppingIndex = heap[key].index;
         const Weight weight = heap[key].weight;
-        Key nextKey = key << 1;
-        while (nextKey < static_cast<Key>(heap.size()))
+        const Key heap_size = static_cast<Key>(heap.size());
+        Key nextKey = FirstChild(key);
+        while (nextKey < heap_size)
         {
-            const Key nextKeyOther = nextKey + 1;
-            if ((nextKeyOther < static_cast<Key>(heap.size())) &&
-                (heap[nextKey].weight > heap[nextKeyOther].weight))
+            const Key end_of_children = std::min(static_cast<Key>(nextKey + Arity), heap_size);
+            for (Key nextKeyOther = nextKey + 1; nextKeyOther < end_of_children; ++nextKeyOther)
             {
-                nextKey = nextKeyOther;
+                if (heap[nextKey].weight > heap[nextKeyOther].weight)
+                {
+                    nextKey = nextKeyOther;
+                }
             }
             if (weight <= heap[nextKey].weight)
             {
@@ -251,7 +404,7 @@ class BinaryHeap
             heap[key] = heap[nextKey];
             inserted_nodes[heap[key].index].key = key;
             key = nextKey;
-            nextKey <<= 1;
+            nextKey = FirstChild(key);
         }
         heap[key].index = droppingIndex;
         heap[key].weight = weight;
@@ -262,14 +415,14 @@ class BinaryHeap
     {
         const Key risingIndex = heap[key].index;
         const Weight weight = heap[key].weight;
-        Key nextKey = key >> 1;
+        Key nextKey = Parent(key);
         while (heap[nextKey].weight > weight)
         {
             BOOST_ASSERT(nextKey != 0);
             heap[key] = heap[nextKey];
             inserted_nodes[heap[key].index].key = key;
             key = nextKey;
-            nextKey >>= 1;
+            nextKey = Parent(key);
         }
         heap[key].index = risingIndex;
         heap[key].weight = weight;
@@ -279,9 +432,9 @@ class BinaryHeap
     void CheckHeap()
     {
 #ifndef NDEBUG
-        for (Key i = 2; i < (Key)heap.size(); ++i)
+        for (Key i = ROOT + 1; i < (Key)heap.size(); ++i)
         {
-            BOOST_ASSERT(heap[i].weight >= heap[i >> 1].weight);
+            BOOST_ASSERT(heap[i].weight >= heap[Parent(i)].weight);
         }
 #endif
     }
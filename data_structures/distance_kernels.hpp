@@ -0,0 +1,641 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef DISTANCE_KERNELS_HPP
+#define DISTANCE_KERNELS_HPP
+
+#include "../Util/MercatorUtil.h"
+
+#include <osrm/Coordinate.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Distance kernels of the R-tree queries. They evaluate
+// FixedPointCoordinate::ComputePerpendicularDistance for many segments and
+// FixedPointCoordinate::ApproximateEuclideanDistance for many points or rectangles at once,
+// with AVX2 or SSE4.1 if the compiler targets them and with a scalar fallback otherwise.
+//
+// The kernels repeat the floating point operations of the scalar functions in the same
+// order and precision. Only cos, exp and atan are replaced by polynomial approximations
+// that are accurate to about one unit in the last place of a double, so the distances
+// agree with the scalar functions except for rare rounding differences. All variants share
+// the same code and produce identical results.
+namespace osrm
+{
+
+// End points of segments as a structure of arrays. The latitudes are also stored in the
+// Mercator projection that ComputePerpendicularDistance works in.
+template <std::size_t N> struct SegmentArrays
+{
+    SegmentArrays()
+        : source_lats(), source_lons(), target_lats(), target_lons(), projected_source_lats(),
+          projected_target_lats()
+    {
+    }
+
+    void Set(const std::size_t index,
+             const FixedPointCoordinate &source,
+             const FixedPointCoordinate &target)
+    {
+        source_lats[index] = source.lat;
+        source_lons[index] = source.lon;
+        target_lats[index] = target.lat;
+        target_lons[index] = target.lon;
+        projected_source_lats[index] = lat2y(source.lat / COORDINATE_PRECISION);
+        projected_target_lats[index] = lat2y(target.lat / COORDINATE_PRECISION);
+    }
+
+    std::array<int32_t, N> source_lats;
+    std::array<int32_t, N> source_lons;
+    std::array<int32_t, N> target_lats;
+    std::array<int32_t, N> target_lons;
+    std::array<double, N> projected_source_lats;
+    std::array<double, N> projected_target_lats;
+};
+
+// Bounding rectangles as a structure of arrays
+template <std::size_t N> struct RectangleArrays
+{
+    void Set(const std::size_t index,
+             const int32_t min_lat,
+             const int32_t max_lat,
+             const int32_t min_lon,
+             const int32_t max_lon)
+    {
+        min_lats[index] = min_lat;
+        max_lats[index] = max_lat;
+        min_lons[index] = min_lon;
+        max_lons[index] = max_lon;
+    }
+
+    std::array<int32_t, N> min_lats;
+    std::array<int32_t, N> max_lats;
+    std::array<int32_t, N> min_lons;
+    std::array<int32_t, N> max_lons;
+};
+
+// The lane types provide the arithmetic of the kernels on WIDTH values at once. Integer
+// coordinates are held exactly in doubles. Floats hold the single precision intermediates
+// of ApproximateEuclideanDistance, one per lane.
+struct ScalarLanes
+{
+    static constexpr std::size_t WIDTH = 1;
+    using Double = double;
+    using Float = float;
+    using Mask = bool;
+
+    static Double Load(const double *values) { return *values; }
+    static Double Load(const int32_t *values) { return *values; }
+    static void Store(float *values, const Float value) { *values = value; }
+    static Double Set(const double value) { return value; }
+    static Float Set(const float value) { return value; }
+
+    static Double Add(const Double a, const Double b) { return a + b; }
+    static Double Sub(const Double a, const Double b) { return a - b; }
+    static Double Mul(const Double a, const Double b) { return a * b; }
+    static Double Div(const Double a, const Double b) { return a / b; }
+    static Double Sqrt(const Double a) { return std::sqrt(a); }
+    static Double Abs(const Double a) { return std::abs(a); }
+    static Double Negate(const Double a) { return -a; }
+    // same operand order and NaN handling as minpd and maxpd
+    static Double Min(const Double a, const Double b) { return a < b ? a : b; }
+    static Double Max(const Double a, const Double b) { return a > b ? a : b; }
+    static Double Floor(const Double a) { return std::floor(a); }
+    static Double Truncate(const Double a) { return std::trunc(a); }
+    // multiplies by 2^exponent for an integral exponent that keeps the result normal
+    static Double ScaleByPowerOfTwo(const Double a, const Double exponent)
+    {
+        return std::ldexp(a, static_cast<int>(exponent));
+    }
+    static Double RoundToFloat(const Double a) { return static_cast<float>(a); }
+
+    static Mask Less(const Double a, const Double b) { return a < b; }
+    static Mask LessEqual(const Double a, const Double b) { return a <= b; }
+    static Mask Greater(const Double a, const Double b) { return a > b; }
+    static Mask GreaterEqual(const Double a, const Double b) { return a >= b; }
+    static Mask Equal(const Double a, const Double b) { return a == b; }
+    static Mask IsNaN(const Double a) { return a != a; }
+    static Mask And(const Mask a, const Mask b) { return a && b; }
+    static Double Select(const Mask mask, const Double a, const Double b) { return mask ? a : b; }
+
+    static Float ToFloat(const Double a) { return static_cast<float>(a); }
+    static Double ToDouble(const Float a) { return a; }
+    static Float Add(const Float a, const Float b) { return a + b; }
+    static Float Sub(const Float a, const Float b) { return a - b; }
+    static Float Mul(const Float a, const Float b) { return a * b; }
+    static Float Div(const Float a, const Float b) { return a / b; }
+    static Float Min(const Float a, const Float b) { return a < b ? a : b; }
+    static Float Max(const Float a, const Float b) { return a > b ? a : b; }
+};
+
+#if defined(__AVX2__)
+struct AVX2Lanes
+{
+    static constexpr std::size_t WIDTH = 4;
+    using Double = __m256d;
+    using Float = __m128;
+    using Mask = __m256d;
+
+    static Double Load(const double *values) { return _mm256_loadu_pd(values); }
+    static Double Load(const int32_t *values)
+    {
+        return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values)));
+    }
+    static void Store(float *values, const Float value) { _mm_storeu_ps(values, value); }
+    static Double Set(const double value) { return _mm256_set1_pd(value); }
+    static Float Set(const float value) { return _mm_set1_ps(value); }
+
+    static Double Add(const Double a, const Double b) { return _mm256_add_pd(a, b); }
+    static Double Sub(const Double a, const Double b) { return _mm256_sub_pd(a, b); }
+    static Double Mul(const Double a, const Double b) { return _mm256_mul_pd(a, b); }
+    static Double Div(const Double a, const Double b) { return _mm256_div_pd(a, b); }
+    static Double Sqrt(const Double a) { return _mm256_sqrt_pd(a); }
+    static Double Abs(const Double a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.), a); }
+    static Double Negate(const Double a) { return _mm256_xor_pd(_mm256_set1_pd(-0.), a); }
+    static Double Min(const Double a, const Double b) { return _mm256_min_pd(a, b); }
+    static Double Max(const Double a, const Double b) { return _mm256_max_pd(a, b); }
+    static Double Floor(const Double a) { return _mm256_floor_pd(a); }
+    static Double Truncate(const Double a)
+    {
+        return _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+    static Double ScaleByPowerOfTwo(const Double a, const Double exponent)
+    {
+        const __m256i shifted_exponent =
+            _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(exponent)), 52);
+        return _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(a), shifted_exponent));
+    }
+    static Double RoundToFloat(const Double a) { return _mm256_cvtps_pd(_mm256_cvtpd_ps(a)); }
+
+    static Mask Less(const Double a, const Double b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static Mask LessEqual(const Double a, const Double b)
+    {
+        return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+    }
+    static Mask Greater(const Double a, const Double b)
+    {
+        return _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+    }
+    static Mask GreaterEqual(const Double a, const Double b)
+    {
+        return _mm256_cmp_pd(a, b, _CMP_GE_OQ);
+    }
+    static Mask Equal(const Double a, const Double b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static Mask IsNaN(const Double a) { return _mm256_cmp_pd(a, a, _CMP_UNORD_Q); }
+    static Mask And(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+    static Double Select(const Mask mask, const Double a, const Double b)
+    {
+        return _mm256_blendv_pd(b, a, mask);
+    }
+
+    static Float ToFloat(const Double a) { return _mm256_cvtpd_ps(a); }
+    static Double ToDouble(const Float a) { return _mm256_cvtps_pd(a); }
+    static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+    static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+    static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+    static Float Div(const Float a, const Float b) { return _mm_div_ps(a, b); }
+    static Float Min(const Float a, const Float b) { return _mm_min_ps(a, b); }
+    static Float Max(const Float a, const Float b) { return _mm_max_ps(a, b); }
+};
+using NativeLanes = AVX2Lanes;
+#elif defined(__SSE4_1__)
+// two lanes, the floats only use the lower half of their register
+struct SSE41Lanes
+{
+    static constexpr std::size_t WIDTH = 2;
+    using Double = __m128d;
+    using Float = __m128;
+    using Mask = __m128d;
+
+    static Double Load(const double *values) { return _mm_loadu_pd(values); }
+    static Double Load(const int32_t *values)
+    {
+        return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(values)));
+    }
+    static void Store(float *values, const Float value)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64 *>(values), value);
+    }
+    static Double Set(const double value) { return _mm_set1_pd(value); }
+    static Float Set(const float value) { return _mm_set1_ps(value); }
+
+    static Double Add(const Double a, const Double b) { return _mm_add_pd(a, b); }
+    static Double Sub(const Double a, const Double b) { return _mm_sub_pd(a, b); }
+    static Double Mul(const Double a, const Double b) { return _mm_mul_pd(a, b); }
+    static Double Div(const Double a, const Double b) { return _mm_div_pd(a, b); }
+    static Double Sqrt(const Double a) { return _mm_sqrt_pd(a); }
+    static Double Abs(const Double a) { return _mm_andnot_pd(_mm_set1_pd(-0.), a); }
+    static Double Negate(const Double a) { return _mm_xor_pd(_mm_set1_pd(-0.), a); }
+    static Double Min(const Double a, const Double b) { return _mm_min_pd(a, b); }
+    static Double Max(const Double a, const Double b) { return _mm_max_pd(a, b); }
+    static Double Floor(const Double a) { return _mm_floor_pd(a); }
+    static Double Truncate(const Double a)
+    {
+        return _mm_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+    static Double ScaleByPowerOfTwo(const Double a, const Double exponent)
+    {
+        const __m128i shifted_exponent =
+            _mm_slli_epi64(_mm_cvtepi32_epi64(_mm_cvtpd_epi32(exponent)), 52);
+        return _mm_castsi128_pd(_mm_add_epi64(_mm_castpd_si128(a), shifted_exponent));
+    }
+    static Double RoundToFloat(const Double a) { return _mm_cvtps_pd(_mm_cvtpd_ps(a)); }
+
+    static Mask Less(const Double a, const Double b) { return _mm_cmplt_pd(a, b); }
+    static Mask LessEqual(const Double a, const Double b) { return _mm_cmple_pd(a, b); }
+    static Mask Greater(const Double a, const Double b) { return _mm_cmpgt_pd(a, b); }
+    static Mask GreaterEqual(const Double a, const Double b) { return _mm_cmpge_pd(a, b); }
+    static Mask Equal(const Double a, const Double b) { return _mm_cmpeq_pd(a, b); }
+    static Mask IsNaN(const Double a) { return _mm_cmpunord_pd(a, a); }
+    static Mask And(const Mask a, const Mask b) { return _mm_and_pd(a, b); }
+    static Double Select(const Mask mask, const Double a, const Double b)
+    {
+        return _mm_blendv_pd(b, a, mask);
+    }
+
+    static Float ToFloat(const Double a) { return _mm_cvtpd_ps(a); }
+    static Double ToDouble(const Float a) { return _mm_cvtps_pd(a); }
+    static Float Add(const Float a, const Float b) { return _mm_add_ps(a, b); }
+    static Float Sub(const Float a, const Float b) { return _mm_sub_ps(a, b); }
+    static Float Mul(const Float a, const Float b) { return _mm_mul_ps(a, b); }
+    static Float Div(const Float a, const Float b) { return _mm_div_ps(a, b); }
+    static Float Min(const Float a, const Float b) { return _mm_min_ps(a, b); }
+    static Float Max(const Float a, const Float b) { return _mm_max_ps(a, b); }
+};
+using NativeLanes = SSE41Lanes;
+#else
+using NativeLanes = ScalarLanes;
+#endif
+
+template <typename LanesT> class DistanceKernel
+{
+    using L = LanesT;
+    using Double = typename L::Double;
+    using Float = typename L::Float;
+    using Mask = typename L::Mask;
+
+  public:
+    // FixedPointCoordinate::ApproximateEuclideanDistance of integral coordinates
+    static Float ApproximateEuclideanDistance(const Double lat1,
+                                              const Double lon1,
+                                              const Double lat2,
+                                              const Double lon2)
+    {
+        const Float precision = L::Set(COORDINATE_PRECISION);
+        const Float rad = L::Set(0.017453292519943295769236907684886f);
+        const Float float_lat1 = L::Mul(L::Div(L::ToFloat(lat1), precision), rad);
+        const Float float_lon1 = L::Mul(L::Div(L::ToFloat(lon1), precision), rad);
+        const Float float_lat2 = L::Mul(L::Div(L::ToFloat(lat2), precision), rad);
+        const Float float_lon2 = L::Mul(L::Div(L::ToFloat(lon2), precision), rad);
+
+        const Double mean_lat = L::ToDouble(L::Div(L::Add(float_lat1, float_lat2), L::Set(2.f)));
+        const Float x_value =
+            L::ToFloat(L::Mul(L::ToDouble(L::Sub(float_lon2, float_lon1)), Cos(mean_lat)));
+        const Float y_value = L::Sub(float_lat2, float_lat1);
+        const Float squared_length = L::Add(L::Mul(x_value, x_value), L::Mul(y_value, y_value));
+        const double earth_radius = 6372797.560856f;
+        return L::ToFloat(L::Mul(L::Sqrt(L::ToDouble(squared_length)), L::Set(earth_radius)));
+    }
+
+    // FixedPointCoordinate::ComputePerpendicularDistance, the segment latitudes are projected
+    static Float PerpendicularDistance(const Double query_lat,
+                                       const Double query_lon,
+                                       const Double projected_query_lat,
+                                       const Double source_lat,
+                                       const Double source_lon,
+                                       const Double projected_source_lat,
+                                       const Double target_lat,
+                                       const Double target_lon,
+                                       const Double projected_target_lat)
+    {
+        const Double zero = L::Set(0.);
+        const Double one = L::Set(1.);
+        const Double epsilon = L::Set(std::numeric_limits<double>::epsilon());
+
+        const Double x = projected_query_lat;
+        const Double y = LonToDegrees(query_lon);
+        const Double a = projected_source_lat;
+        const Double b = LonToDegrees(source_lon);
+        const Double c = projected_target_lat;
+        const Double d = LonToDegrees(target_lon);
+
+        // Projection of (x,y) on line joining (a,b) and (c,d), unless the segment is vertical
+        const Mask has_slope = L::Greater(L::Abs(L::Sub(a, c)), epsilon);
+        const Double m = L::Div(L::Sub(d, b), L::Sub(c, a));
+        const Double projected_p =
+            L::Div(L::Add(L::Add(x, L::Mul(m, y)), L::Sub(L::Mul(L::Mul(m, m), a), L::Mul(m, b))),
+                   L::Add(one, L::Mul(m, m)));
+        const Double projected_q = L::Add(b, L::Mul(m, L::Sub(projected_p, a)));
+        const Double p = L::Select(has_slope, projected_p, c);
+        const Double q = L::Select(has_slope, projected_q, y);
+
+        Double nY = L::Div(L::Sub(L::Mul(d, p), L::Mul(c, q)), L::Sub(L::Mul(a, d), L::Mul(b, c)));
+        nY = L::Select(L::Less(L::Abs(nY), L::Set(static_cast<double>(1.f / COORDINATE_PRECISION))),
+                       zero, nY);
+
+        // the scalar code keeps the ratio in a float
+        Double ratio = L::RoundToFloat(L::Div(L::Sub(p, L::Mul(nY, a)), c));
+        const Mask target_is_query =
+            L::And(L::Equal(target_lat, query_lat), L::Equal(target_lon, query_lon));
+        ratio = L::Select(L::IsNaN(ratio), L::Select(target_is_query, one, zero), ratio);
+        ratio = L::Select(L::LessEqual(L::Abs(ratio), epsilon), zero, ratio);
+        ratio = L::Select(L::LessEqual(L::Abs(L::Sub(ratio, one)), epsilon), one, ratio);
+
+        const Double precision = L::Set(static_cast<double>(COORDINATE_PRECISION));
+        const Double foot_point_lat = L::Truncate(L::Mul(MercatorToLatitude(p), precision));
+        const Double foot_point_lon = L::Truncate(L::Mul(q, precision));
+        const Mask left_of_segment = L::LessEqual(ratio, zero);
+        const Mask right_of_segment = L::GreaterEqual(ratio, one);
+        const Double nearest_lat =
+            L::Select(left_of_segment, source_lat,
+                      L::Select(right_of_segment, target_lat, foot_point_lat));
+        const Double nearest_lon =
+            L::Select(left_of_segment, source_lon,
+                      L::Select(right_of_segment, target_lon, foot_point_lon));
+        return ApproximateEuclideanDistance(query_lat, query_lon, nearest_lat, nearest_lon);
+    }
+
+    // RectangleInt2D::GetMinDist
+    static Float RectangleMinDistance(const Double query_lat,
+                                      const Double query_lon,
+                                      const Double min_lat,
+                                      const Double max_lat,
+                                      const Double min_lon,
+                                      const Double max_lon)
+    {
+        const Double nearest_lat = L::Min(L::Max(query_lat, min_lat), max_lat);
+        const Double nearest_lon = L::Min(L::Max(query_lon, min_lon), max_lon);
+        return ApproximateEuclideanDistance(query_lat, query_lon, nearest_lat, nearest_lon);
+    }
+
+    // RectangleInt2D::GetMinMaxDist
+    static Float RectangleMinMaxDistance(const Double query_lat,
+                                         const Double query_lon,
+                                         const Double min_lat,
+                                         const Double max_lat,
+                                         const Double min_lon,
+                                         const Double max_lon)
+    {
+        const Float upper_left = ApproximateEuclideanDistance(query_lat, query_lon, max_lat, min_lon);
+        const Float upper_right =
+            ApproximateEuclideanDistance(query_lat, query_lon, max_lat, max_lon);
+        const Float lower_right =
+            ApproximateEuclideanDistance(query_lat, query_lon, min_lat, max_lon);
+        const Float lower_left = ApproximateEuclideanDistance(query_lat, query_lon, min_lat, min_lon);
+        Float min_max_dist = L::Max(upper_left, upper_right);
+        min_max_dist = L::Min(min_max_dist, L::Max(upper_right, lower_right));
+        min_max_dist = L::Min(min_max_dist, L::Max(lower_right, lower_left));
+        return L::Min(min_max_dist, L::Max(lower_left, upper_left));
+    }
+
+  private:
+    // lon / COORDINATE_PRECISION is evaluated in single precision
+    static Double LonToDegrees(const Double lon)
+    {
+        return L::ToDouble(L::Div(L::ToFloat(lon), L::Set(COORDINATE_PRECISION)));
+    }
+
+    // y2lat
+    static Double MercatorToLatitude(const Double y)
+    {
+        const Double exponential = Exp(L::Div(L::Mul(y, L::Set(M_PI)), L::Set(180.)));
+        return L::Mul(L::Set(180. * M_1_PI),
+                      L::Sub(L::Mul(L::Set(2.), AtanOfPositive(exponential)), L::Set(M_PI_2)));
+    }
+
+    // The polynomials of cos, exp and atan are the ones of the Cephes Math Library
+
+    // cos for |x| <= pi/2, the range of latitudes in radians
+    static Double Cos(const Double x)
+    {
+        const Double absolute_x = L::Abs(x);
+        // reduce (pi/4, pi/2] to a sine around pi/2
+        const Mask is_reduced =
+            L::GreaterEqual(L::Mul(absolute_x, L::Set(1.27323954473516268615)), L::Set(1.));
+        const Double quarter_turns = L::Select(is_reduced, L::Set(2.), L::Set(0.));
+        const Double z = L::Sub(L::Sub(L::Sub(absolute_x,
+                                              L::Mul(quarter_turns, L::Set(7.85398125648498535156E-1))),
+                                       L::Mul(quarter_turns, L::Set(3.77489470793079817668E-8))),
+                                L::Mul(quarter_turns, L::Set(2.69515142907905952645E-15)));
+        const Double zz = L::Mul(z, z);
+
+        Double sine = L::Set(1.58962301576546568060E-10);
+        sine = L::Add(L::Mul(sine, zz), L::Set(-2.50507477628578072866E-8));
+        sine = L::Add(L::Mul(sine, zz), L::Set(2.75573136213857245213E-6));
+        sine = L::Add(L::Mul(sine, zz), L::Set(-1.98412698295895385996E-4));
+        sine = L::Add(L::Mul(sine, zz), L::Set(8.33333333332211858878E-3));
+        sine = L::Add(L::Mul(sine, zz), L::Set(-1.66666666666666307295E-1));
+        sine = L::Add(z, L::Mul(L::Mul(z, zz), sine));
+
+        Double cosine = L::Set(-1.13585365213876817300E-11);
+        cosine = L::Add(L::Mul(cosine, zz), L::Set(2.08757008419747316778E-9));
+        cosine = L::Add(L::Mul(cosine, zz), L::Set(-2.75573141792967388112E-7));
+        cosine = L::Add(L::Mul(cosine, zz), L::Set(2.48015872888517045348E-5));
+        cosine = L::Add(L::Mul(cosine, zz), L::Set(-1.38888888888730564116E-3));
+        cosine = L::Add(L::Mul(cosine, zz), L::Set(4.16666666666665929218E-2));
+        cosine = L::Add(L::Sub(L::Set(1.), L::Mul(zz, L::Set(0.5))), L::Mul(L::Mul(zz, zz), cosine));
+
+        return L::Select(is_reduced, L::Negate(sine), cosine);
+    }
+
+    // exp, the argument is clamped to a range where the result stays normal
+    static Double Exp(const Double x)
+    {
+        const Double clamped_x = L::Min(L::Max(x, L::Set(-700.)), L::Set(700.));
+        const Double n =
+            L::Floor(L::Add(L::Mul(clamped_x, L::Set(1.4426950408889634073599)), L::Set(0.5)));
+        Double r = L::Sub(clamped_x, L::Mul(n, L::Set(6.93145751953125E-1)));
+        r = L::Sub(r, L::Mul(n, L::Set(1.42860682030941723212E-6)));
+        const Double rr = L::Mul(r, r);
+
+        Double numerator = L::Set(1.26177193074810590878E-4);
+        numerator = L::Add(L::Mul(numerator, rr), L::Set(3.02994407707441961300E-2));
+        numerator = L::Add(L::Mul(numerator, rr), L::Set(9.99999999999999999910E-1));
+        numerator = L::Mul(r, numerator);
+
+        Double denominator = L::Set(3.00198505138664455042E-6);
+        denominator = L::Add(L::Mul(denominator, rr), L::Set(2.52448340349684104192E-3));
+        denominator = L::Add(L::Mul(denominator, rr), L::Set(2.27265548208155028766E-1));
+        denominator = L::Add(L::Mul(denominator, rr), L::Set(2.00000000000000000009E0));
+
+        const Double fraction = L::Div(numerator, L::Sub(denominator, numerator));
+        return L::ScaleByPowerOfTwo(L::Add(L::Set(1.), L::Mul(L::Set(2.), fraction)), n);
+    }
+
+    // atan for x >= 0
+    static Double AtanOfPositive(const Double x)
+    {
+        const Double more_bits = L::Set(6.123233995736765886130E-17);
+        const Mask is_large = L::Greater(x, L::Set(2.41421356237309504880));
+        const Mask is_medium = L::Greater(x, L::Set(0.66));
+        const Double reduced_x =
+            L::Select(is_large, L::Div(L::Set(-1.), x),
+                      L::Select(is_medium, L::Div(L::Sub(x, L::Set(1.)), L::Add(x, L::Set(1.))), x));
+        const Double offset = L::Select(is_large, L::Set(M_PI_2),
+                                        L::Select(is_medium, L::Set(M_PI_4), L::Set(0.)));
+        const Double offset_bits =
+            L::Select(is_large, more_bits,
+                      L::Select(is_medium, L::Mul(L::Set(0.5), more_bits), L::Set(0.)));
+
+        const Double z = L::Mul(reduced_x, reduced_x);
+        Double numerator = L::Set(-8.750608600031904122785E-1);
+        numerator = L::Add(L::Mul(numerator, z), L::Set(-1.615753718733365076637E1));
+        numerator = L::Add(L::Mul(numerator, z), L::Set(-7.500855792314704667340E1));
+        numerator = L::Add(L::Mul(numerator, z), L::Set(-1.228866684490136173410E2));
+        numerator = L::Add(L::Mul(numerator, z), L::Set(-6.485021904942025371773E1));
+
+        Double denominator = L::Add(z, L::Set(2.485846490142306297962E1));
+        denominator = L::Add(L::Mul(denominator, z), L::Set(1.650270098316988542046E2));
+        denominator = L::Add(L::Mul(denominator, z), L::Set(4.328810604912902668951E2));
+        denominator = L::Add(L::Mul(denominator, z), L::Set(4.853903996359136964868E2));
+        denominator = L::Add(L::Mul(denominator, z), L::Set(1.945506571482613964425E2));
+
+        const Double polynomial = L::Div(L::Mul(z, numerator), denominator);
+        const Double atan_of_reduced =
+            L::Add(L::Add(L::Mul(reduced_x, polynomial), reduced_x), offset_bits);
+        return L::Add(offset, atan_of_reduced);
+    }
+};
+
+// Distances of a location to count segments, as ComputePerpendicularDistance computes them.
+// Vector lanes process the leading segments, the scalar fallback the rest.
+template <typename LanesT = NativeLanes, std::size_t N>
+void ComputeSegmentDistances(const FixedPointCoordinate &location,
+                             const SegmentArrays<N> &segments,
+                             const std::size_t count,
+                             float *distances)
+{
+    const double projected_lat = lat2y(location.lat / COORDINATE_PRECISION);
+    std::size_t i = 0;
+    for (; i + LanesT::WIDTH <= count; i += LanesT::WIDTH)
+    {
+        LanesT::Store(distances + i,
+                      DistanceKernel<LanesT>::PerpendicularDistance(
+                          LanesT::Set(static_cast<double>(location.lat)),
+                          LanesT::Set(static_cast<double>(location.lon)),
+                          LanesT::Set(projected_lat), LanesT::Load(&segments.source_lats[i]),
+                          LanesT::Load(&segments.source_lons[i]),
+                          LanesT::Load(&segments.projected_source_lats[i]),
+                          LanesT::Load(&segments.target_lats[i]),
+                          LanesT::Load(&segments.target_lons[i]),
+                          LanesT::Load(&segments.projected_target_lats[i])));
+    }
+    for (; i < count; ++i)
+    {
+        distances[i] = DistanceKernel<ScalarLanes>::PerpendicularDistance(
+            location.lat, location.lon, projected_lat, segments.source_lats[i],
+            segments.source_lons[i], segments.projected_source_lats[i], segments.target_lats[i],
+            segments.target_lons[i], segments.projected_target_lats[i]);
+    }
+}
+
+// Distances of a location to count points, as ApproximateEuclideanDistance computes them
+template <typename LanesT = NativeLanes>
+void ComputePointDistances(const FixedPointCoordinate &location,
+                           const int32_t *lats,
+                           const int32_t *lons,
+                           const std::size_t count,
+                           float *distances)
+{
+    std::size_t i = 0;
+    for (; i + LanesT::WIDTH <= count; i += LanesT::WIDTH)
+    {
+        LanesT::Store(distances + i, DistanceKernel<LanesT>::ApproximateEuclideanDistance(
+                                         LanesT::Set(static_cast<double>(location.lat)),
+                                         LanesT::Set(static_cast<double>(location.lon)),
+                                         LanesT::Load(lats + i), LanesT::Load(lons + i)));
+    }
+    for (; i < count; ++i)
+    {
+        distances[i] = DistanceKernel<ScalarLanes>::ApproximateEuclideanDistance(
+            location.lat, location.lon, lats[i], lons[i]);
+    }
+}
+
+// Lower bounds of the distances of a location to count rectangles, as GetMinDist computes them
+template <typename LanesT = NativeLanes, std::size_t N>
+void ComputeRectangleMinDistances(const FixedPointCoordinate &location,
+                                  const RectangleArrays<N> &rectangles,
+                                  const std::size_t count,
+                                  float *distances)
+{
+    std::size_t i = 0;
+    for (; i + LanesT::WIDTH <= count; i += LanesT::WIDTH)
+    {
+        LanesT::Store(distances + i,
+                      DistanceKernel<LanesT>::RectangleMinDistance(
+                          LanesT::Set(static_cast<double>(location.lat)),
+                          LanesT::Set(static_cast<double>(location.lon)),
+                          LanesT::Load(&rectangles.min_lats[i]), LanesT::Load(&rectangles.max_lats[i]),
+                          LanesT::Load(&rectangles.min_lons[i]), LanesT::Load(&rectangles.max_lons[i])));
+    }
+    for (; i < count; ++i)
+    {
+        distances[i] = DistanceKernel<ScalarLanes>::RectangleMinDistance(
+            location.lat, location.lon, rectangles.min_lats[i], rectangles.max_lats[i],
+            rectangles.min_lons[i], rectangles.max_lons[i]);
+    }
+}
+
+// Upper bounds of the distances of a location to the nearest object in count rectangles, as
+// GetMinMaxDist computes them
+template <typename LanesT = NativeLanes, std::size_t N>
+void ComputeRectangleMinMaxDistances(const FixedPointCoordinate &location,
+                                     const RectangleArrays<N> &rectangles,
+                                     const std::size_t count,
+                                     float *distances)
+{
+    std::size_t i = 0;
+    for (; i + LanesT::WIDTH <= count; i += LanesT::WIDTH)
+    {
+        LanesT::Store(distances + i,
+                      DistanceKernel<LanesT>::RectangleMinMaxDistance(
+                          LanesT::Set(static_cast<double>(location.lat)),
+                          LanesT::Set(static_cast<double>(location.lon)),
+                          LanesT::Load(&rectangles.min_lats[i]), LanesT::Load(&rectangles.max_lats[i]),
+                          LanesT::Load(&rectangles.min_lons[i]), LanesT::Load(&rectangles.max_lons[i])));
+    }
+    for (; i < count; ++i)
+    {
+        distances[i] = DistanceKernel<ScalarLanes>::RectangleMinMaxDistance(
+            location.lat, location.lon, rectangles.min_lats[i], rectangles.max_lats[i],
+            rectangles.min_lons[i], rectangles.max_lons[i]);
+    }
+}
+}
+
+#endif // DISTANCE_KERNELS_HPP
@@ -28,8 +28,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef LRUCACHE_HPP
 #define LRUCACHE_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 template <typename KeyT, typename ValueT> class LRUCache
 {
@@ -56,10 +63,19 @@ template <typename KeyT, typename ValueT> class LRUCache
         return false;
     }
 
-    void Insert(const KeyT key, ValueT &value)
+    // inserting a key that is already cached replaces its value
+    void Insert(const KeyT key, ValueT value)
     {
-        itemsInCache.push_front(CacheEntry(key, value));
-        positionMap.insert(std::make_pair(key, itemsInCache.begin()));
+        const auto position = positionMap.find(key);
+        if (position != positionMap.end())
+        {
+            position->second->value = std::move(value);
+            itemsInCache.splice(itemsInCache.begin(), itemsInCache, position->second);
+            return;
+        }
+
+        itemsInCache.emplace_front(key, std::move(value));
+        positionMap.emplace(key, itemsInCache.begin());
         if (itemsInCache.size() > capacity)
         {
             positionMap.erase(itemsInCache.back().key);
@@ -67,31 +83,107 @@ template <typename KeyT, typename ValueT> class LRUCache
         }
     }
 
-    void Insert(const KeyT key, ValueT value)
+    bool Fetch(const KeyT key, ValueT &result)
     {
-        itemsInCache.push_front(CacheEntry(key, value));
-        positionMap.insert(std::make_pair(key, itemsInCache.begin()));
-        if (itemsInCache.size() > capacity)
+        const auto position = positionMap.find(key);
+        if (position == positionMap.end())
         {
-            positionMap.erase(itemsInCache.back().key);
-            itemsInCache.pop_back();
+            return false;
         }
+        result = position->second->value;
+
+        // move to front, list iterators stay valid
+        itemsInCache.splice(itemsInCache.begin(), itemsInCache, position->second);
+        return true;
+    }
+
+    void Clear()
+    {
+        positionMap.clear();
+        itemsInCache.clear();
+    }
+
+    unsigned Size() const { return itemsInCache.size(); }
+};
+
+// LRUCache that can be shared by all threads of the server. Keys are distributed over a number
+// of independently locked shards, so concurrent queries rarely wait for each other. The bound
+// is per shard, i.e. the cache holds at most 'capacity' entries in total.
+template <typename KeyT, typename ValueT> class ConcurrentLRUCache
+{
+  private:
+    static constexpr unsigned NUMBER_OF_SHARDS = 16;
+
+    struct Shard
+    {
+        explicit Shard(unsigned capacity) : cache(capacity) {}
+        std::mutex mutex;
+        LRUCache<KeyT, ValueT> cache;
+    };
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+
+    Shard &GetShard(const KeyT key) const
+    {
+        // the low bits of consecutive ids end up in different shards
+        return *shards[std::hash<KeyT>()(key) % NUMBER_OF_SHARDS];
     }
 
+  public:
+    explicit ConcurrentLRUCache(unsigned capacity) : hits(0), misses(0)
+    {
+        const unsigned shard_capacity = std::max(1u, capacity / NUMBER_OF_SHARDS);
+        for (unsigned i = 0; i < NUMBER_OF_SHARDS; ++i)
+        {
+            shards.emplace_back(new Shard(shard_capacity));
+        }
+    }
+
+    ConcurrentLRUCache(const ConcurrentLRUCache &) = delete;
+    ConcurrentLRUCache &operator=(const ConcurrentLRUCache &) = delete;
+
     bool Fetch(const KeyT key, ValueT &result)
     {
-        if (Holds(key))
+        Shard &shard = GetShard(key);
+        bool found;
         {
-            CacheEntry e = *(positionMap.find(key)->second);
-            result = e.value;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            found = shard.cache.Fetch(key, result);
+        }
+        ++(found ? hits : misses);
+        return found;
+    }
 
-            // move to front
-            itemsInCache.splice(positionMap.find(key)->second, itemsInCache, itemsInCache.begin());
-            positionMap.find(key)->second = itemsInCache.begin();
-            return true;
+    void Insert(const KeyT key, ValueT value)
+    {
+        Shard &shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.cache.Insert(key, std::move(value));
+    }
+
+    // drops all entries, the hit and miss counters keep counting
+    void Clear()
+    {
+        for (const auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->cache.Clear();
         }
-        return false;
     }
-    unsigned Size() const { return itemsInCache.size(); }
+
+    unsigned Size() const
+    {
+        unsigned size = 0;
+        for (const auto &shard : shards)
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            size += shard->cache.Size();
+        }
+        return size;
+    }
+
+    std::uint64_t GetNumberOfHits() const { return hits.load(); }
+    std::uint64_t GetNumberOfMisses() const { return misses.load(); }
 };
 #endif // LRUCACHE_HPP
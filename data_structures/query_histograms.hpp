@@ -0,0 +1,154 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef QUERY_HISTOGRAMS_HPP
+#define QUERY_HISTOGRAMS_HPP
+
+#include "json_container.hpp"
+#include "query_statistics.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Distribution of a value over power-of-two buckets. Bucket i counts the values that take i
+// bits, i.e. bucket 0 counts zeros and bucket i > 0 counts values in [2^(i-1), 2^i).
+class Histogram
+{
+  public:
+    static constexpr unsigned NUMBER_OF_BUCKETS = 65;
+
+    Histogram() : count(0), sum(0)
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static unsigned BucketIndex(std::uint64_t value)
+    {
+        unsigned index = 0;
+        while (0 != value)
+        {
+            ++index;
+            value >>= 1;
+        }
+        return index;
+    }
+
+    void Add(const std::uint64_t value)
+    {
+        buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    std::uint64_t GetCount() const { return count.load(std::memory_order_relaxed); }
+
+    std::uint64_t GetBucket(const unsigned index) const
+    {
+        return buckets[index].load(std::memory_order_relaxed);
+    }
+
+    // buckets after the last non-empty one are left out
+    JSON::Object ToJSON() const
+    {
+        JSON::Object json_histogram;
+        json_histogram.values.emplace("count", JSON::Number(static_cast<double>(GetCount())));
+        json_histogram.values.emplace(
+            "sum", JSON::Number(static_cast<double>(sum.load(std::memory_order_relaxed))));
+        unsigned number_of_buckets = NUMBER_OF_BUCKETS;
+        while (number_of_buckets > 0 && 0 == GetBucket(number_of_buckets - 1))
+        {
+            --number_of_buckets;
+        }
+        JSON::Array json_buckets;
+        for (unsigned index = 0; index < number_of_buckets; ++index)
+        {
+            json_buckets.values.push_back(static_cast<double>(GetBucket(index)));
+        }
+        json_histogram.values.emplace("buckets", std::move(json_buckets));
+        return json_histogram;
+    }
+
+  private:
+    std::array<std::atomic<std::uint64_t>, NUMBER_OF_BUCKETS> buckets;
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> sum;
+};
+
+// Histograms of every query statistic per service, aggregated over all queries of the server.
+// The histograms of a service are indexed by the order in which ForEachField visits the fields.
+class QueryHistograms
+{
+  public:
+    // Services have to be added before queries are answered, adding is not thread-safe.
+    void AddService(const std::string &service) { service_histograms[service]; }
+
+    void Add(const std::string &service, const QueryStatistics &statistics)
+    {
+        const auto iter = service_histograms.find(service);
+        if (service_histograms.end() == iter)
+        {
+            return;
+        }
+        auto &histograms = iter->second;
+        unsigned field_index = 0;
+        statistics.ForEachField([&histograms, &field_index](const char *, const std::uint64_t value)
+                                {
+                                    histograms[field_index++].Add(value);
+                                });
+    }
+
+    JSON::Object ToJSON() const
+    {
+        JSON::Object json_services;
+        for (const auto &service : service_histograms)
+        {
+            const auto &histograms = service.second;
+            JSON::Object json_histograms;
+            unsigned field_index = 0;
+            QueryStatistics().ForEachField(
+                [&histograms, &json_histograms, &field_index](const char *name, const std::uint64_t)
+                {
+                    json_histograms.values.emplace(name, histograms[field_index++].ToJSON());
+                });
+            json_services.values.emplace(service.first, std::move(json_histograms));
+        }
+        return json_services;
+    }
+
+  private:
+    using FieldHistograms = std::array<Histogram, QueryStatistics::NUMBER_OF_FIELDS>;
+    std::unordered_map<std::string, FieldHistograms> service_histograms;
+};
+
+#endif // QUERY_HISTOGRAMS_HPP
@@ -0,0 +1,219 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef QUERY_STATISTICS_HPP
+#define QUERY_STATISTICS_HPP
+
+#include "json_container.hpp"
+
+#include <boost/thread/tss.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Work done for a single query. Every thread counts into its own instance, see ThreadLocal().
+struct QueryStatistics
+{
+    QueryStatistics()
+        : settled_nodes(0), relaxed_edges(0), stalled_nodes(0), heap_operations(0),
+          unpacked_edges(0), phantom_lookup_time(0), search_time(0), unpack_time(0),
+          description_time(0), render_time(0)
+    {
+    }
+
+    // search space
+    std::uint64_t settled_nodes;
+    std::uint64_t relaxed_edges;
+    std::uint64_t stalled_nodes;
+    std::uint64_t heap_operations;
+    std::uint64_t unpacked_edges;
+
+    // phases in microseconds. The search includes unpacking, which is summed over all threads
+    // that unpacked paths in parallel.
+    std::uint64_t phantom_lookup_time;
+    std::uint64_t search_time;
+    std::uint64_t unpack_time;
+    std::uint64_t description_time;
+    std::uint64_t render_time;
+
+    // visits the fields in this order, which consumers may index them by
+    static constexpr unsigned NUMBER_OF_FIELDS = 10;
+
+    template <class VisitorT> void ForEachField(VisitorT &&visitor) const
+    {
+        visitor("settled_nodes", settled_nodes);
+        visitor("relaxed_edges", relaxed_edges);
+        visitor("stalled_nodes", stalled_nodes);
+        visitor("heap_operations", heap_operations);
+        visitor("unpacked_edges", unpacked_edges);
+        visitor("phantom_lookup_time", phantom_lookup_time);
+        visitor("search_time", search_time);
+        visitor("unpack_time", unpack_time);
+        visitor("description_time", description_time);
+        visitor("render_time", render_time);
+    }
+
+    QueryStatistics &operator+=(const QueryStatistics &other)
+    {
+        settled_nodes += other.settled_nodes;
+        relaxed_edges += other.relaxed_edges;
+        stalled_nodes += other.stalled_nodes;
+        heap_operations += other.heap_operations;
+        unpacked_edges += other.unpacked_edges;
+        phantom_lookup_time += other.phantom_lookup_time;
+        search_time += other.search_time;
+        unpack_time += other.unpack_time;
+        description_time += other.description_time;
+        render_time += other.render_time;
+        return *this;
+    }
+
+    QueryStatistics &operator-=(const QueryStatistics &other)
+    {
+        settled_nodes -= other.settled_nodes;
+        relaxed_edges -= other.relaxed_edges;
+        stalled_nodes -= other.stalled_nodes;
+        heap_operations -= other.heap_operations;
+        unpacked_edges -= other.unpacked_edges;
+        phantom_lookup_time -= other.phantom_lookup_time;
+        search_time -= other.search_time;
+        unpack_time -= other.unpack_time;
+        description_time -= other.description_time;
+        render_time -= other.render_time;
+        return *this;
+    }
+
+    JSON::Object ToJSON() const
+    {
+        JSON::Object json_statistics;
+        ForEachField([&json_statistics](const char *name, const std::uint64_t value)
+                     {
+                         json_statistics.values.emplace(
+                             name, JSON::Number(static_cast<double>(value)));
+                     });
+        return json_statistics;
+    }
+
+    // Statistics of the query that the calling thread works on. A query resets them before it
+    // is handled, the searches count into them without any synchronization.
+    static QueryStatistics &ThreadLocal()
+    {
+        static boost::thread_specific_ptr<QueryStatistics> statistics;
+        if (!statistics.get())
+        {
+            statistics.reset(new QueryStatistics());
+        }
+        return *statistics;
+    }
+};
+
+// Adds the time until it is stopped or goes out of scope to a phase of the thread's query
+// statistics.
+class PhaseTimer
+{
+  public:
+    explicit PhaseTimer(std::uint64_t QueryStatistics::*phase)
+        : phase_time(QueryStatistics::ThreadLocal().*phase),
+          start(std::chrono::steady_clock::now()), running(true)
+    {
+    }
+
+    ~PhaseTimer() { Stop(); }
+
+    void Stop()
+    {
+        if (running)
+        {
+            phase_time += std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - start).count();
+            running = false;
+        }
+    }
+
+  private:
+    std::uint64_t &phase_time;
+    std::chrono::steady_clock::time_point start;
+    bool running;
+};
+
+/*
+    Collects the statistics of the tasks of a parallel search. The tasks run on arbitrary
+    threads, which may also be working on tasks of other queries in between. So each task only
+    records the difference it made to the statistics of its thread, and Merge() sets the
+    statistics of the calling thread to what they were before plus the work of all tasks.
+
+        ParallelQueryStatistics parallel_statistics;
+        tbb::parallel_for(range, [&](...)
+                          {
+                              const ParallelQueryStatistics::Task task(parallel_statistics);
+                              ...
+                          });
+        parallel_statistics.Merge();
+*/
+class ParallelQueryStatistics
+{
+  public:
+    ParallelQueryStatistics() : caller_statistics(QueryStatistics::ThreadLocal()) {}
+
+    class Task
+    {
+      public:
+        explicit Task(ParallelQueryStatistics &parallel_statistics)
+            : parallel_statistics(parallel_statistics),
+              statistics_before(QueryStatistics::ThreadLocal())
+        {
+        }
+
+        ~Task()
+        {
+            QueryStatistics difference = QueryStatistics::ThreadLocal();
+            difference -= statistics_before;
+            std::lock_guard<std::mutex> lock(parallel_statistics.mutex);
+            parallel_statistics.task_statistics += difference;
+        }
+
+      private:
+        ParallelQueryStatistics &parallel_statistics;
+        const QueryStatistics statistics_before;
+    };
+
+    // to be called by the calling thread once all tasks are finished
+    void Merge()
+    {
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
+        statistics = caller_statistics;
+        statistics += task_statistics;
+    }
+
+  private:
+    std::mutex mutex;
+    const QueryStatistics caller_statistics;
+    QueryStatistics task_statistics;
+};
+
+#endif // QUERY_STATISTICS_HPP
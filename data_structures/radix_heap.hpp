@@ -0,0 +1,317 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include "binary_heap.hpp"
+
+#include <boost/assert.hpp>
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Monotone radix heap for integral weights. Keys must never be smaller than the last key that
+// was removed by DeleteMin(), which holds for Dijkstra-like searches with non-negative edge weights.
+// Negative weights (e.g. phantom node offsets) are fine as long as they are monotone.
+// The interface mirrors BinaryHeap, so both can be used interchangeably.
+template <typename NodeID,
+          typename Key,
+          typename Weight,
+          typename Data,
+          typename IndexStorage = ArrayStorage<NodeID, NodeID>>
+class RadixHeap
+{
+  private:
+    static_assert(std::is_integral<Weight>::value, "radix heap needs integral weights");
+
+    using RadixType = typename std::make_unsigned<Weight>::type;
+    static constexpr unsigned NUMBER_OF_BUCKETS = std::numeric_limits<RadixType>::digits + 1;
+
+    RadixHeap(const RadixHeap &right);
+    void operator=(const RadixHeap &right);
+
+  public:
+    using WeightType = Weight;
+    using DataType = Data;
+
+    explicit RadixHeap(size_t maxID) : node_index(maxID) { Clear(); }
+
+    void Clear()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.clear();
+        }
+        inserted_nodes.clear();
+        node_index.Clear();
+        last_deleted = 0;
+        number_of_elements = 0;
+    }
+
+    std::size_t Size() const { return number_of_elements; }
+
+    bool Empty() const { return 0 == Size(); }
+
+    void Insert(NodeID node, Weight weight, const Data &data)
+    {
+        const Key index = static_cast<Key>(inserted_nodes.size());
+        inserted_nodes.emplace_back(node, weight, data);
+        node_index[node] = index;
+        Push(index, weight);
+        ++number_of_elements;
+    }
+
+    Data &GetData(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].data;
+    }
+
+    Data const &GetData(NodeID node) const
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].data;
+    }
+
+    Weight &GetKey(NodeID node)
+    {
+        const Key index = node_index[node];
+        return inserted_nodes[index].weight;
+    }
+
+    bool WasRemoved(const NodeID node)
+    {
+        BOOST_ASSERT(WasInserted(node));
+        const Key index = node_index[node];
+        return inserted_nodes[index].removed;
+    }
+
+    bool WasInserted(const NodeID node)
+    {
+        const Key index = node_index[node];
+        if (index >= static_cast<Key>(inserted_nodes.size()))
+        {
+            return false;
+        }
+        return inserted_nodes[index].node == node;
+    }
+
+    NodeID Min() const
+    {
+        BOOST_ASSERT(!Empty());
+        for (const auto &bucket : buckets)
+        {
+            bool found = false;
+            Key min_index = 0;
+            for (const BucketElement &element : bucket)
+            {
+                if (IsStale(element))
+                {
+                    continue;
+                }
+                if (!found || element.weight < inserted_nodes[min_index].weight)
+                {
+                    min_index = element.index;
+                    found = true;
+                }
+            }
+            if (found)
+            {
+                return inserted_nodes[min_index].node;
+            }
+        }
+        BOOST_ASSERT_MSG(false, "radix heap is inconsistent");
+        return std::numeric_limits<NodeID>::max();
+    }
+
+    NodeID DeleteMin()
+    {
+        BOOST_ASSERT(!Empty());
+        Key removed_index = 0;
+        while (!PopFromFirstBucket(removed_index))
+        {
+            Redistribute();
+        }
+        inserted_nodes[removed_index].removed = true;
+        --number_of_elements;
+        return inserted_nodes[removed_index].node;
+    }
+
+    void DeleteAll()
+    {
+        for (auto &bucket : buckets)
+        {
+            for (const BucketElement &element : bucket)
+            {
+                inserted_nodes[element.index].removed = true;
+            }
+            bucket.clear();
+        }
+        number_of_elements = 0;
+    }
+
+    void DecreaseKey(NodeID node, Weight weight)
+    {
+        BOOST_ASSERT(std::numeric_limits<NodeID>::max() != node);
+        const Key index = node_index[node];
+        BOOST_ASSERT(!inserted_nodes[index].removed);
+        BOOST_ASSERT(weight <= inserted_nodes[index].weight);
+
+        // the old bucket entry becomes stale and is dropped lazily
+        inserted_nodes[index].weight = weight;
+        Push(index, weight);
+    }
+
+  private:
+    class HeapNode
+    {
+      public:
+        HeapNode(NodeID n, Weight w, Data d) : node(n), weight(w), data(d), removed(false) {}
+
+        NodeID node;
+        Weight weight;
+        Data data;
+        bool removed;
+    };
+    struct BucketElement
+    {
+        Key index;
+        Weight weight;
+    };
+
+    std::vector<HeapNode> inserted_nodes;
+    std::array<std::vector<BucketElement>, NUMBER_OF_BUCKETS> buckets;
+    IndexStorage node_index;
+    RadixType last_deleted;
+    std::size_t number_of_elements;
+
+    // order preserving mapping of signed weights onto unsigned radix values
+    static inline RadixType ToRadix(const Weight weight)
+    {
+        return static_cast<RadixType>(weight) ^
+               (std::is_signed<Weight>::value
+                    ? (RadixType(1) << (std::numeric_limits<RadixType>::digits - 1))
+                    : RadixType(0));
+    }
+
+    // bucket i holds all values that first differ from last_deleted in bit i-1
+    inline unsigned GetBucket(const RadixType radix) const
+    {
+        BOOST_ASSERT_MSG(radix >= last_deleted, "radix heap is not monotone");
+        RadixType difference = radix ^ last_deleted;
+#if defined(__GNUC__) || defined(__clang__)
+        return (0 == difference)
+                   ? 0
+                   : std::numeric_limits<unsigned long long>::digits -
+                         __builtin_clzll(static_cast<unsigned long long>(difference));
+#else
+        unsigned bucket = 0;
+        while (0 != difference)
+        {
+            difference >>= 1;
+            ++bucket;
+        }
+        return bucket;
+#endif
+    }
+
+    inline bool IsStale(const BucketElement &element) const
+    {
+        const HeapNode &heap_node = inserted_nodes[element.index];
+        return heap_node.removed || heap_node.weight != element.weight;
+    }
+
+    inline void Push(const Key index, const Weight weight)
+    {
+        buckets[GetBucket(ToRadix(weight))].push_back(BucketElement{index, weight});
+    }
+
+    bool PopFromFirstBucket(Key &index)
+    {
+        auto &first_bucket = buckets.front();
+        while (!first_bucket.empty())
+        {
+            const BucketElement element = first_bucket.back();
+            first_bucket.pop_back();
+            if (!IsStale(element))
+            {
+                index = element.index;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // moves the contents of the first non-empty bucket into lower buckets
+    void Redistribute()
+    {
+        unsigned bucket_id = 1;
+        while (buckets[bucket_id].empty())
+        {
+            ++bucket_id;
+            BOOST_ASSERT(bucket_id < NUMBER_OF_BUCKETS);
+        }
+
+        auto &bucket = buckets[bucket_id];
+        bool found = false;
+        RadixType new_last_deleted = 0;
+        for (const BucketElement &element : bucket)
+        {
+            if (IsStale(element))
+            {
+                continue;
+            }
+            const RadixType radix = ToRadix(element.weight);
+            if (!found || radix < new_last_deleted)
+            {
+                new_last_deleted = radix;
+                found = true;
+            }
+        }
+
+        if (found)
+        {
+            last_deleted = new_last_deleted;
+            for (const BucketElement &element : bucket)
+            {
+                if (!IsStale(element))
+                {
+                    const unsigned new_bucket_id = GetBucket(ToRadix(element.weight));
+                    BOOST_ASSERT(new_bucket_id < bucket_id);
+                    buckets[new_bucket_id].push_back(element);
+                }
+            }
+        }
+        bucket.clear();
+    }
+};
+
+#endif // RADIX_HEAP_HPP
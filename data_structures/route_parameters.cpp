@@ -33,7 +33,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 RouteParameters::RouteParameters()
     : zoom_level(18), print_instructions(false), alternate_route(true), geometry(true),
-      compression(true), deprecatedAPI(false), uturn_default(false), check_sum(-1), num_results(1)
+      compression(true), deprecatedAPI(false), uturn_default(false), debug(false), check_sum(-1), num_results(1),
+      max_time(0), alternate_route_budget(0), time_budget(0)
 {
 }
 
@@ -53,8 +54,19 @@ void RouteParameters::setNumberOfResults(const short number)
     }
 }
 
+void RouteParameters::setMaxTime(const unsigned time) { max_time = time; }
+
 void RouteParameters::setAlternateRouteFlag(const bool flag) { alternate_route = flag; }
 
+void RouteParameters::setAlternateRouteBudget(const unsigned milliseconds)
+{
+    alternate_route_budget = milliseconds;
+}
+
+void RouteParameters::setTimeBudget(const unsigned milliseconds) { time_budget = milliseconds; }
+
+void RouteParameters::setDebugFlag(const bool flag) { debug = flag; }
+
 void RouteParameters::setUTurn(const bool flag)
 {
     uturns.resize(coordinates.size(), uturn_default);
@@ -114,4 +126,26 @@ RouteParameters::addCoordinate(const boost::fusion::vector<double, double> &tran
     coordinates.emplace_back(
         static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<0>(transmitted_coordinates)),
         static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<1>(transmitted_coordinates)));
+    is_source.push_back(true);
+    is_destination.push_back(true);
+}
+
+void
+RouteParameters::addSource(const boost::fusion::vector<double, double> &transmitted_coordinates)
+{
+    coordinates.emplace_back(
+        static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<0>(transmitted_coordinates)),
+        static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<1>(transmitted_coordinates)));
+    is_source.push_back(true);
+    is_destination.push_back(false);
+}
+
+void
+RouteParameters::addDestination(const boost::fusion::vector<double, double> &transmitted_coordinates)
+{
+    coordinates.emplace_back(
+        static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<0>(transmitted_coordinates)),
+        static_cast<int>(COORDINATE_PRECISION * boost::fusion::at_c<1>(transmitted_coordinates)));
+    is_source.push_back(false);
+    is_destination.push_back(true);
 }
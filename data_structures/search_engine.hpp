@@ -29,8 +29,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SEARCH_ENGINE_HPP
 
 #include "search_engine_data.hpp"
+#include "shortcut_cache.hpp"
 #include "../routing_algorithms/alternative_path.hpp"
 #include "../routing_algorithms/many_to_many.hpp"
+#include "../routing_algorithms/many_to_many_sweep.hpp"
+#include "../routing_algorithms/one_to_all.hpp"
+#include "../routing_algorithms/parallel_shortest_path.hpp"
 #include "../routing_algorithms/shortest_path.hpp"
 
 #include <type_traits>
@@ -43,12 +47,20 @@ template <class DataFacadeT> class SearchEngine
 
   public:
     ShortestPathRouting<DataFacadeT> shortest_path;
+    ParallelShortestPathRouting<DataFacadeT> shortest_path_parallel;
     AlternativeRouting<DataFacadeT> alternative_path;
     ManyToManyRouting<DataFacadeT> distance_table;
+    ManyToManySweepRouting<DataFacadeT> distance_table_sweep;
+    OneToAllRouting<DataFacadeT> one_to_all;
 
-    explicit SearchEngine(DataFacadeT *facade)
-        : facade(facade), shortest_path(facade, engine_working_data),
-          alternative_path(facade, engine_working_data), distance_table(facade, engine_working_data)
+    // the shortcut cache is shared with all other search engines on the same facade
+    SearchEngine(DataFacadeT *facade, ShortcutCache &shortcut_cache)
+        : facade(facade), shortest_path(facade, engine_working_data, shortcut_cache),
+          shortest_path_parallel(facade, engine_working_data, shortcut_cache),
+          alternative_path(facade, engine_working_data, shortcut_cache),
+          distance_table(facade, engine_working_data, shortcut_cache),
+          distance_table_sweep(facade, engine_working_data, shortcut_cache),
+          one_to_all(facade, engine_working_data, shortcut_cache)
     {
         static_assert(!std::is_pointer<DataFacadeT>::value, "don't instantiate with ptr type");
         static_assert(std::is_object<DataFacadeT>::value, "don't instantiate with void, function, or reference");
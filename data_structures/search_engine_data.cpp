@@ -91,3 +91,24 @@ void SearchEngineData::InitializeOrClearThirdThreadLocalStorage(const unsigned n
         backwardHeap3.reset(new QueryHeap(number_of_nodes));
     }
 }
+
+void SearchEngineData::InitializeOrClearSharingThreadLocalStorage(const unsigned number_of_nodes)
+{
+    if (forwardSharing.get())
+    {
+        forwardSharing->Clear();
+    }
+    else
+    {
+        forwardSharing.reset(new SharingStorage(number_of_nodes));
+    }
+
+    if (backwardSharing.get())
+    {
+        backwardSharing->Clear();
+    }
+    else
+    {
+        backwardSharing.reset(new SharingStorage(number_of_nodes));
+    }
+}
@@ -41,8 +41,17 @@ struct HeapData
 
 struct SearchEngineData
 {
-    using QueryHeap = BinaryHeap<NodeID, NodeID, int, HeapData, UnorderedMapStorage<NodeID, int>>;
+#ifdef OSRM_QUERY_HEAP_HASH_STORAGE
+    // trades query speed for a smaller footprint on memory-constrained hosts
+    using QueryHeapStorage = UnorderedMapStorage<NodeID, int>;
+    using SharingStorage = UnorderedMapStorage<NodeID, int>;
+#else
+    using QueryHeapStorage = TimestampedArrayStorage<NodeID, int>;
+    using SharingStorage = TimestampedArrayStorage<NodeID, int>;
+#endif
+    using QueryHeap = BinaryHeap<NodeID, NodeID, int, HeapData, QueryHeapStorage>;
     using SearchEngineHeapPtr = boost::thread_specific_ptr<QueryHeap>;
+    using SharingStoragePtr = boost::thread_specific_ptr<SharingStorage>;
 
     static SearchEngineHeapPtr forwardHeap;
     static SearchEngineHeapPtr backwardHeap;
@@ -51,11 +60,17 @@ struct SearchEngineData
     static SearchEngineHeapPtr forwardHeap3;
     static SearchEngineHeapPtr backwardHeap3;
 
+    // approximated sharing with the shortest path of the alternative route search
+    static SharingStoragePtr forwardSharing;
+    static SharingStoragePtr backwardSharing;
+
     void InitializeOrClearFirstThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearSecondThreadLocalStorage(const unsigned number_of_nodes);
 
     void InitializeOrClearThirdThreadLocalStorage(const unsigned number_of_nodes);
+
+    void InitializeOrClearSharingThreadLocalStorage(const unsigned number_of_nodes);
 };
 
 #endif // SEARCH_ENGINE_DATA_HPP
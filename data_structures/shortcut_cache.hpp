@@ -0,0 +1,92 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SHORTCUT_CACHE_HPP
+#define SHORTCUT_CACHE_HPP
+
+#include "lru_cache.hpp"
+#include "../typedefs.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// edge of a packed path, the id is SPECIAL_EDGEID until it is known
+struct PackedEdge
+{
+    NodeID from;
+    NodeID to;
+    EdgeID edge_id;
+};
+
+// Original edges of recently unpacked shortcuts. One cache is shared by all search engines and
+// threads that route on the same data facade. A shortcut can be traversed in both directions,
+// so the key is twice its edge id plus one if reversed.
+class ShortcutCache
+{
+  public:
+    using UnpackedShortcutPtr = std::shared_ptr<const std::vector<PackedEdge>>;
+
+    static constexpr unsigned CAPACITY = 1 << 14;
+
+    ShortcutCache() : cache(CAPACITY), cached_check_sum(0) {}
+    ShortcutCache(const ShortcutCache &) = delete;
+
+    // The cached edge ids are only valid for the data set they were unpacked from.
+    void Validate(const unsigned check_sum)
+    {
+        if (cached_check_sum.exchange(check_sum) != check_sum)
+        {
+            cache.Clear();
+        }
+    }
+
+    bool Fetch(const EdgeID edge_id, const bool reversed, UnpackedShortcutPtr &original_edges)
+    {
+        return cache.Fetch(GetKey(edge_id, reversed), original_edges);
+    }
+
+    void Insert(const EdgeID edge_id, const bool reversed, UnpackedShortcutPtr original_edges)
+    {
+        cache.Insert(GetKey(edge_id, reversed), std::move(original_edges));
+    }
+
+    std::uint64_t GetNumberOfHits() const { return cache.GetNumberOfHits(); }
+    std::uint64_t GetNumberOfMisses() const { return cache.GetNumberOfMisses(); }
+
+  private:
+    static std::uint64_t GetKey(const EdgeID edge_id, const bool reversed)
+    {
+        return 2 * static_cast<std::uint64_t>(edge_id) + (reversed ? 1 : 0);
+    }
+
+    ConcurrentLRUCache<std::uint64_t, UnpackedShortcutPtr> cache;
+    std::atomic<unsigned> cached_check_sum;
+};
+
+#endif // SHORTCUT_CACHE_HPP
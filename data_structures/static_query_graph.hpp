@@ -0,0 +1,190 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STATIC_QUERY_GRAPH_HPP
+#define STATIC_QUERY_GRAPH_HPP
+
+#include "query_edge.hpp"
+#include "shared_memory_vector_wrapper.hpp"
+#include "static_graph.hpp"
+#include "../Util/integer_range.hpp"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+
+#include <utility>
+
+// Structure-of-arrays variant of StaticGraph<QueryEdge::EdgeData>. The edge array only holds
+// what the searches need to relax an edge, i.e. target, distance and direction flags. The id of
+// the original edge or middle node is kept in a second array and is only read when a path is
+// unpacked. The .hsgr files keep the layout of StaticGraph.
+template <bool UseSharedMemory = false> class StaticQueryGraph
+{
+  public:
+    using NodeIterator = NodeID;
+    using EdgeIterator = NodeID;
+    using EdgeData = QueryEdge::EdgeData;
+    using EdgeRange = osrm::range<EdgeIterator>;
+    using NodeArrayEntry = typename StaticGraph<EdgeData>::NodeArrayEntry;
+    // layout of the edges in .hsgr files
+    using InputEdgeArrayEntry = typename StaticGraph<EdgeData>::EdgeArrayEntry;
+
+    struct EdgeArrayEntry
+    {
+        EdgeArrayEntry() : target(SPECIAL_NODEID), distance(0), forward(false), backward(false) {}
+
+        explicit EdgeArrayEntry(const InputEdgeArrayEntry &input_edge)
+            : target(input_edge.target), distance(input_edge.data.distance),
+              forward(input_edge.data.forward), backward(input_edge.data.backward)
+        {
+        }
+
+        // all bit-fields share one type, otherwise MSVC does not pack them into one unit
+        NodeID target;
+        unsigned distance : 30;
+        unsigned forward : 1;
+        unsigned backward : 1;
+    };
+
+    struct EdgeIDArrayEntry
+    {
+        EdgeIDArrayEntry() : id(0), shortcut(false) {}
+
+        explicit EdgeIDArrayEntry(const InputEdgeArrayEntry &input_edge)
+            : id(input_edge.data.id), shortcut(input_edge.data.shortcut)
+        {
+        }
+
+        unsigned id : 31;
+        unsigned shortcut : 1;
+    };
+
+    static_assert(sizeof(EdgeArrayEntry) == 8, "searches stream through the edge array");
+    static_assert(sizeof(EdgeIDArrayEntry) == 4, "edge ids should not take more space");
+
+    // both edge vectors have one entry per edge
+    StaticQueryGraph(typename ShM<NodeArrayEntry, UseSharedMemory>::vector &nodes,
+                     typename ShM<EdgeArrayEntry, UseSharedMemory>::vector &edges,
+                     typename ShM<EdgeIDArrayEntry, UseSharedMemory>::vector &edge_ids)
+    {
+        BOOST_ASSERT(edges.size() == edge_ids.size());
+        number_of_nodes = static_cast<decltype(number_of_nodes)>(nodes.size() - 1);
+        number_of_edges = static_cast<decltype(number_of_edges)>(edges.size());
+
+        node_array.swap(nodes);
+        edge_array.swap(edges);
+        edge_id_array.swap(edge_ids);
+    }
+
+    unsigned GetNumberOfNodes() const { return number_of_nodes; }
+
+    unsigned GetNumberOfEdges() const { return number_of_edges; }
+
+    unsigned GetOutDegree(const NodeIterator n) const { return EndEdges(n) - BeginEdges(n); }
+
+    inline NodeIterator GetTarget(const EdgeIterator e) const
+    {
+        return NodeIterator(edge_array[e].target);
+    }
+
+    // Assembled from both arrays. Once inlined, searches that never look at id or shortcut do
+    // not touch the id array.
+    inline EdgeData GetEdgeData(const EdgeIterator e) const
+    {
+        EdgeData data;
+        data.distance = edge_array[e].distance;
+        data.forward = edge_array[e].forward;
+        data.backward = edge_array[e].backward;
+        data.id = edge_id_array[e].id;
+        data.shortcut = edge_id_array[e].shortcut;
+        return data;
+    }
+
+    EdgeIterator BeginEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array[n].first_edge);
+    }
+
+    EdgeIterator EndEdges(const NodeIterator n) const
+    {
+        return EdgeIterator(node_array[n + 1].first_edge);
+    }
+
+    EdgeRange GetAdjacentEdgeRange(const NodeID node) const
+    {
+        return osrm::irange(BeginEdges(node), EndEdges(node));
+    }
+
+    // searches for a specific edge
+    EdgeIterator FindEdge(const NodeIterator from, const NodeIterator to) const
+    {
+        EdgeIterator smallest_edge = SPECIAL_EDGEID;
+        EdgeWeight smallest_weight = INVALID_EDGE_WEIGHT;
+        for (auto edge : GetAdjacentEdgeRange(from))
+        {
+            const NodeID target = GetTarget(edge);
+            const EdgeWeight weight = edge_array[edge].distance;
+            if (target == to && weight < smallest_weight)
+            {
+                smallest_edge = edge;
+                smallest_weight = weight;
+            }
+        }
+        return smallest_edge;
+    }
+
+    EdgeIterator FindEdgeInEitherDirection(const NodeIterator from, const NodeIterator to) const
+    {
+        EdgeIterator tmp = FindEdge(from, to);
+        return (SPECIAL_NODEID != tmp ? tmp : FindEdge(to, from));
+    }
+
+    EdgeIterator
+    FindEdgeIndicateIfReverse(const NodeIterator from, const NodeIterator to, bool &result) const
+    {
+        EdgeIterator current_iterator = FindEdge(from, to);
+        if (SPECIAL_NODEID == current_iterator)
+        {
+            current_iterator = FindEdge(to, from);
+            if (SPECIAL_NODEID != current_iterator)
+            {
+                result = true;
+            }
+        }
+        return current_iterator;
+    }
+
+  private:
+    NodeIterator number_of_nodes;
+    EdgeIterator number_of_edges;
+
+    typename ShM<NodeArrayEntry, UseSharedMemory>::vector node_array;
+    typename ShM<EdgeArrayEntry, UseSharedMemory>::vector edge_array;
+    typename ShM<EdgeIDArrayEntry, UseSharedMemory>::vector edge_id_array;
+};
+
+#endif // STATIC_QUERY_GRAPH_HPP
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define STATIC_RTREE_HPP
 
 #include "deallocating_vector.hpp"
+#include "distance_kernels.hpp"
 #include "hilbert_value.hpp"
 #include "phantom_node.hpp"
 #include "query_node.hpp"
@@ -49,6 +50,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/assert.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/thread.hpp>
 
 #include <tbb/parallel_for.h>
@@ -56,11 +58,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <variant/variant.hpp>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
 #include <algorithm>
 #include <array>
 #include <limits>
 #include <memory>
-#include <queue>
 #include <string>
 #include <vector>
 
@@ -141,71 +146,12 @@ class StaticRTree
 
         inline float GetMinDist(const FixedPointCoordinate &location) const
         {
-            const bool is_contained = Contains(location);
-            if (is_contained)
-            {
-                return 0.;
-            }
-
-            enum Direction
-            {
-                INVALID    = 0,
-                NORTH      = 1,
-                SOUTH      = 2,
-                EAST       = 4,
-                NORTH_EAST = 5,
-                SOUTH_EAST = 6,
-                WEST       = 8,
-                NORTH_WEST = 9,
-                SOUTH_WEST = 10
-            };
-
-            Direction d = INVALID;
-            if (location.lat > max_lat)
-                d = (Direction) (d | NORTH);
-            else if (location.lat < min_lat)
-                d = (Direction) (d | SOUTH);
-            if (location.lon > max_lon)
-                d = (Direction) (d | EAST);
-            else if (location.lon < min_lon)
-                d = (Direction) (d | WEST);
-
-            BOOST_ASSERT(d != INVALID);
-
-            float min_dist = std::numeric_limits<float>::max();
-            switch (d)
-            {
-                case NORTH:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(max_lat, location.lon));
-                    break;
-                case SOUTH:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(min_lat, location.lon));
-                    break;
-                case WEST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(location.lat, min_lon));
-                    break;
-                case EAST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(location.lat, max_lon));
-                    break;
-                case NORTH_EAST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(max_lat, max_lon));
-                    break;
-                case NORTH_WEST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(max_lat, min_lon));
-                    break;
-                case SOUTH_EAST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(min_lat, max_lon));
-                    break;
-                case SOUTH_WEST:
-                    min_dist = FixedPointCoordinate::ApproximateEuclideanDistance(location, FixedPointCoordinate(min_lat, min_lon));
-                    break;
-                default:
-                    break;
-            }
-
-            BOOST_ASSERT(min_dist != std::numeric_limits<float>::max());
-
-            return min_dist;
+            // clamping yields the nearest point of the rectangle, which is the location itself
+            // if it is contained
+            const FixedPointCoordinate nearest_location(
+                std::min(std::max(location.lat, min_lat), max_lat),
+                std::min(std::max(location.lon, min_lon), max_lon));
+            return FixedPointCoordinate::ApproximateEuclideanDistance(location, nearest_location);
         }
 
         inline float GetMinMaxDist(const FixedPointCoordinate &location) const
@@ -292,6 +238,8 @@ class StaticRTree
         LeafNode() : object_count(0), objects() {}
         uint32_t object_count;
         std::array<EdgeDataT, LEAF_NODE_SIZE> objects;
+        // end points of the objects for the distance kernels, latitudes projected at build time
+        osrm::SegmentArrays<LEAF_NODE_SIZE> segments;
     };
 
     struct QueryCandidate
@@ -330,11 +278,63 @@ class StaticRTree
         IncrementalQueryNodeType node;
     };
 
+    // Priority queue of a traversal that keeps its storage from query to query.
+    template <typename CandidateT> class TraversalQueue
+    {
+      public:
+        bool empty() const { return heap.empty(); }
+
+        std::size_t size() const { return heap.size(); }
+
+        const CandidateT &top() const { return heap.front(); }
+
+        template <typename... ArgsT> void emplace(ArgsT &&... args)
+        {
+            heap.emplace_back(std::forward<ArgsT>(args)...);
+            std::push_heap(heap.begin(), heap.end());
+        }
+
+        void pop()
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.pop_back();
+        }
+
+        void clear() { heap.clear(); }
+
+      private:
+        std::vector<CandidateT> heap;
+    };
+
+    // The queries only read the tree, so a single tree serves all threads. Each thread
+    // traverses it with its own queues. Like the query heaps in SearchEngineData, the queues are
+    // static: a thread_specific_ptr must outlive the threads that use it, while a tree is
+    // replaced on every data reload.
+    template <typename CandidateT>
+    static TraversalQueue<CandidateT> &
+    GetTraversalQueue(boost::thread_specific_ptr<TraversalQueue<CandidateT>> &queue_ptr)
+    {
+        if (!queue_ptr.get())
+        {
+            queue_ptr.reset(new TraversalQueue<CandidateT>());
+        }
+        queue_ptr->clear();
+        return *queue_ptr;
+    }
+
     typename ShM<TreeNode, UseSharedMemory>::vector m_search_tree;
     uint64_t m_element_count;
     const std::string m_leaf_node_filename;
     std::shared_ptr<CoordinateListT> m_coordinate_list;
-    boost::filesystem::ifstream leaves_stream;
+    // The leaf file is mapped read-only, queries read the leaves in place. The pages are shared
+    // by all threads and with every other process that maps the same file.
+    boost::iostreams::mapped_file_source m_leaves_region;
+    const LeafNode *m_leaves;
+    // number of spatially adjacent queries of a batch that a worker answers in a row
+    static constexpr std::size_t QUERY_BATCH_GRAIN_SIZE = 64;
+    static boost::thread_specific_ptr<TraversalQueue<QueryCandidate>> m_traversal_queue;
+    static boost::thread_specific_ptr<TraversalQueue<IncrementalQueryCandidate>>
+        m_incremental_traversal_queue;
 
   public:
     StaticRTree() = delete;
@@ -410,6 +410,13 @@ class StaticRTree
                             .m_array_index;
                     current_leaf.objects[current_element_index] =
                         input_data_vector[index_of_next_object];
+                    const EdgeDataT &current_object = current_leaf.objects[current_element_index];
+                    current_leaf.segments.Set(
+                        current_element_index,
+                        FixedPointCoordinate(coordinate_list.at(current_object.u).lat,
+                                             coordinate_list.at(current_object.u).lon),
+                        FixedPointCoordinate(coordinate_list.at(current_object.v).lat,
+                                             coordinate_list.at(current_object.v).lon));
                     ++current_leaf.object_count;
                 }
             }
@@ -504,7 +511,7 @@ class StaticRTree
     explicit StaticRTree(const boost::filesystem::path &node_file,
                          const boost::filesystem::path &leaf_file,
                          const std::shared_ptr<CoordinateListT> coordinate_list)
-        : m_leaf_node_filename(leaf_file.string())
+        : m_leaf_node_filename(leaf_file.string()), m_leaves(nullptr)
     {
         // open tree node file and load into RAM.
         m_coordinate_list = coordinate_list;
@@ -538,8 +545,7 @@ class StaticRTree
             throw osrm::exception("mem index file is empty");
         }
 
-        leaves_stream.open(leaf_file, std::ios::binary);
-        leaves_stream.read((char *)&m_element_count, sizeof(uint64_t));
+        MapLeaves(leaf_file);
 
         // SimpleLogger().Write() << tree_size << " nodes in search tree";
         // SimpleLogger().Write() << m_element_count << " elements in leafs";
@@ -550,7 +556,7 @@ class StaticRTree
                          const boost::filesystem::path &leaf_file,
                          std::shared_ptr<CoordinateListT> coordinate_list)
         : m_search_tree(tree_node_ptr, number_of_nodes), m_leaf_node_filename(leaf_file.string()),
-          m_coordinate_list(coordinate_list)
+          m_coordinate_list(coordinate_list), m_leaves(nullptr)
     {
         // open leaf node file and store thread specific pointer
         if (!boost::filesystem::exists(leaf_file))
@@ -562,8 +568,7 @@ class StaticRTree
             throw osrm::exception("mem index file is empty");
         }
 
-        leaves_stream.open(leaf_file, std::ios::binary);
-        leaves_stream.read((char *)&m_element_count, sizeof(uint64_t));
+        MapLeaves(leaf_file);
 
         // SimpleLogger().Write() << tree_size << " nodes in search tree";
         // SimpleLogger().Write() << m_element_count << " elements in leafs";
@@ -572,7 +577,7 @@ class StaticRTree
 
     bool LocateClosestEndPointForCoordinate(const FixedPointCoordinate &input_coordinate,
                                             FixedPointCoordinate &result_coordinate,
-                                            const unsigned zoom_level)
+                                            const unsigned zoom_level) const
     {
         bool ignore_tiny_components = (zoom_level <= 14);
 
@@ -580,7 +585,7 @@ class StaticRTree
         float min_max_dist = std::numeric_limits<float>::max();
 
         // initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
+        auto &traversal_queue = GetTraversalQueue(m_traversal_queue);
         traversal_queue.emplace(0.f, 0);
 
         while (!traversal_queue.empty())
@@ -592,11 +597,19 @@ class StaticRTree
             const bool prune_upward = (current_query_node.min_dist >= min_dist);
             if (!prune_downward && !prune_upward)
             { // downward pruning
-                TreeNode &current_tree_node = m_search_tree[current_query_node.node_id];
+                const TreeNode &current_tree_node = m_search_tree[current_query_node.node_id];
                 if (current_tree_node.child_is_on_disk)
                 {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(current_tree_node.children[0], current_leaf_node);
+                    const LeafNode &current_leaf_node = GetLeaf(current_tree_node.children[0]);
+                    const auto &segments = current_leaf_node.segments;
+                    float source_distances[LEAF_NODE_SIZE];
+                    float target_distances[LEAF_NODE_SIZE];
+                    osrm::ComputePointDistances(input_coordinate, segments.source_lats.data(),
+                                                segments.source_lons.data(),
+                                                current_leaf_node.object_count, source_distances);
+                    osrm::ComputePointDistances(input_coordinate, segments.target_lats.data(),
+                                                segments.target_lons.data(),
+                                                current_leaf_node.object_count, target_distances);
                     for (uint32_t i = 0; i < current_leaf_node.object_count; ++i)
                     {
                         EdgeDataT const &current_edge = current_leaf_node.objects[i];
@@ -605,30 +618,17 @@ class StaticRTree
                             continue;
                         }
 
-                        float current_minimum_distance =
-                            FixedPointCoordinate::ApproximateEuclideanDistance(
-                                input_coordinate.lat,
-                                input_coordinate.lon,
-                                m_coordinate_list->at(current_edge.u).lat,
-                                m_coordinate_list->at(current_edge.u).lon);
-                        if (current_minimum_distance < min_dist)
+                        if (source_distances[i] < min_dist)
                         {
                             // found a new minimum
-                            min_dist = current_minimum_distance;
+                            min_dist = source_distances[i];
                             result_coordinate = m_coordinate_list->at(current_edge.u);
                         }
 
-                        current_minimum_distance =
-                            FixedPointCoordinate::ApproximateEuclideanDistance(
-                                input_coordinate.lat,
-                                input_coordinate.lon,
-                                m_coordinate_list->at(current_edge.v).lat,
-                                m_coordinate_list->at(current_edge.v).lon);
-
-                        if (current_minimum_distance < min_dist)
+                        if (target_distances[i] < min_dist)
                         {
                             // found a new minimum
-                            min_dist = current_minimum_distance;
+                            min_dist = target_distances[i];
                             result_coordinate = m_coordinate_list->at(current_edge.v);
                         }
                     }
@@ -655,14 +655,14 @@ class StaticRTree
     IncrementalFindPhantomNodeForCoordinate(const FixedPointCoordinate &input_coordinate,
                                             std::vector<PhantomNode> &result_phantom_node_vector,
                                             const unsigned max_number_of_phantom_nodes,
-                                            const unsigned max_checked_elements = 4*LEAF_NODE_SIZE)
+                                            const unsigned max_checked_elements = 4*LEAF_NODE_SIZE) const
     {
         unsigned inspected_elements = 0;
         unsigned number_of_elements_from_big_cc = 0;
         unsigned number_of_elements_from_tiny_cc = 0;
 
         // initialize queue with root element
-        std::priority_queue<IncrementalQueryCandidate> traversal_queue;
+        auto &traversal_queue = GetTraversalQueue(m_incremental_traversal_queue);
         traversal_queue.emplace(0.f, m_search_tree[0]);
 
         while (!traversal_queue.empty())
@@ -675,37 +675,39 @@ class StaticRTree
                 const TreeNode & current_tree_node = current_query_node.node.template get<TreeNode>();
                 if (current_tree_node.child_is_on_disk)
                 {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(current_tree_node.children[0], current_leaf_node);
+                    const LeafNode &current_leaf_node = GetLeaf(current_tree_node.children[0]);
+                    float perpendicular_distances[LEAF_NODE_SIZE];
+                    osrm::ComputeSegmentDistances(input_coordinate, current_leaf_node.segments,
+                                                  current_leaf_node.object_count,
+                                                  perpendicular_distances);
 
                     // current object represents a block on disk
                     for (const auto i : osrm::irange(0u, current_leaf_node.object_count))
                     {
-                        const auto &current_edge = current_leaf_node.objects[i];
-                        const float current_perpendicular_distance =
-                            FixedPointCoordinate::ComputePerpendicularDistance(
-                                m_coordinate_list->at(current_edge.u),
-                                m_coordinate_list->at(current_edge.v),
-                                input_coordinate);
                         // distance must be non-negative
-                        BOOST_ASSERT(0.f <= current_perpendicular_distance);
+                        BOOST_ASSERT(0.f <= perpendicular_distances[i]);
 
                         // put element in queue
-                        traversal_queue.emplace(current_perpendicular_distance, current_edge);
+                        traversal_queue.emplace(perpendicular_distances[i],
+                                                current_leaf_node.objects[i]);
                     }
                 }
                 else
                 {
+                    osrm::RectangleArrays<BRANCHING_FACTOR> child_rectangles;
+                    GetChildRectangles(current_tree_node, child_rectangles);
+                    float lower_bounds[BRANCHING_FACTOR];
+                    osrm::ComputeRectangleMinDistances(input_coordinate, child_rectangles,
+                                                       current_tree_node.child_count,
+                                                       lower_bounds);
+
                     // for each child mbr get a lower bound and enqueue it
                     for (const auto i : osrm::irange(0u, current_tree_node.child_count))
                     {
                         const int32_t child_id = current_tree_node.children[i];
-                        const TreeNode &child_tree_node = m_search_tree[child_id];
-                        const RectangleT &child_rectangle = child_tree_node.minimum_bounding_rectangle;
-                        const float lower_bound_to_element = child_rectangle.GetMinDist(input_coordinate);
-                        BOOST_ASSERT(0.f <= lower_bound_to_element);
+                        BOOST_ASSERT(0.f <= lower_bounds[i]);
 
-                        traversal_queue.emplace(lower_bound_to_element, child_tree_node);
+                        traversal_queue.emplace(lower_bounds[i], m_search_tree[child_id]);
                     }
                 }
             }
@@ -779,19 +781,62 @@ class StaticRTree
             if ((result_phantom_node_vector.size() >= max_number_of_phantom_nodes && number_of_elements_from_big_cc > 0) ||
                 inspected_elements >= max_checked_elements)
             {
-                traversal_queue = std::priority_queue<IncrementalQueryCandidate>{};
+                traversal_queue.clear();
             }
         }
         // SimpleLogger().Write() << "inspected_elements: " << inspected_elements;
         return !result_phantom_node_vector.empty();
     }
 
+    // Answers a batch of incremental queries. The queries are ordered by the Hilbert values
+    // of their coordinates and every worker answers a contiguous run of that order, so
+    // consecutive queries of a worker descend into mostly the same tree nodes and leaves
+    // while they are still cached. Duplicate coordinates are only looked up once.
+    void IncrementalFindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> &input_coordinates,
+        std::vector<std::vector<PhantomNode>> &result_phantom_node_vectors,
+        const unsigned max_number_of_phantom_nodes) const
+    {
+        const auto number_of_queries = input_coordinates.size();
+        result_phantom_node_vectors.clear();
+        result_phantom_node_vectors.resize(number_of_queries);
+
+        // the Hilbert value is a bijection of the coordinate, equal values are equal queries
+        std::vector<std::pair<uint64_t, uint32_t>> query_order(number_of_queries);
+        HilbertCode get_hilbert_number;
+        for (const auto i : osrm::irange<uint32_t>(0, number_of_queries))
+        {
+            query_order[i] = std::make_pair(get_hilbert_number(input_coordinates[i]), i);
+        }
+        tbb::parallel_sort(query_order.begin(), query_order.end());
+
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_queries, QUERY_BATCH_GRAIN_SIZE),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                for (auto position = range.begin(); position != range.end(); ++position)
+                {
+                    const auto query_id = query_order[position].second;
+                    if (position != range.begin() &&
+                        query_order[position - 1].first == query_order[position].first)
+                    {
+                        result_phantom_node_vectors[query_id] =
+                            result_phantom_node_vectors[query_order[position - 1].second];
+                        continue;
+                    }
+                    IncrementalFindPhantomNodeForCoordinate(input_coordinates[query_id],
+                                                            result_phantom_node_vectors[query_id],
+                                                            max_number_of_phantom_nodes);
+                }
+            });
+    }
+
     // implementation of the Hjaltason/Samet query [3], a BFS traversal of the tree
     bool
     IncrementalFindPhantomNodeForCoordinateWithDistance(const FixedPointCoordinate &input_coordinate,
                                                         std::vector<std::pair<PhantomNode, double>> &result_phantom_node_vector,
                                                         const unsigned number_of_results,
-                                                        const unsigned max_checked_segments = 4*LEAF_NODE_SIZE)
+                                                        const unsigned max_checked_segments = 4*LEAF_NODE_SIZE) const
     {
         std::vector<float> min_found_distances(number_of_results, std::numeric_limits<float>::max());
 
@@ -801,7 +846,7 @@ class StaticRTree
         unsigned inspected_segments = 0;
 
         // initialize queue with root element
-        std::priority_queue<IncrementalQueryCandidate> traversal_queue;
+        auto &traversal_queue = GetTraversalQueue(m_incremental_traversal_queue);
         traversal_queue.emplace(0.f, m_search_tree[0]);
 
         while (!traversal_queue.empty())
@@ -821,35 +866,39 @@ class StaticRTree
                 const TreeNode & current_tree_node = current_query_node.node.template get<TreeNode>();
                 if (current_tree_node.child_is_on_disk)
                 {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(current_tree_node.children[0], current_leaf_node);
+                    const LeafNode &current_leaf_node = GetLeaf(current_tree_node.children[0]);
+                    float perpendicular_distances[LEAF_NODE_SIZE];
+                    osrm::ComputeSegmentDistances(input_coordinate, current_leaf_node.segments,
+                                                  current_leaf_node.object_count,
+                                                  perpendicular_distances);
                     // Add all objects from leaf into queue
                     for (uint32_t i = 0; i < current_leaf_node.object_count; ++i)
                     {
-                        const auto &current_edge = current_leaf_node.objects[i];
-                        const float current_perpendicular_distance =
-                            FixedPointCoordinate::ComputePerpendicularDistance(
-                                m_coordinate_list->at(current_edge.u),
-                                m_coordinate_list->at(current_edge.v),
-                                input_coordinate);
                         // distance must be non-negative
-                        BOOST_ASSERT(0. <= current_perpendicular_distance);
+                        BOOST_ASSERT(0. <= perpendicular_distances[i]);
 
-                        if (current_perpendicular_distance < current_min_dist)
+                        if (perpendicular_distances[i] < current_min_dist)
                         {
-                            traversal_queue.emplace(current_perpendicular_distance, current_edge);
+                            traversal_queue.emplace(perpendicular_distances[i],
+                                                    current_leaf_node.objects[i]);
                         }
                     }
                 }
                 else
                 {
+                    osrm::RectangleArrays<BRANCHING_FACTOR> child_rectangles;
+                    GetChildRectangles(current_tree_node, child_rectangles);
+                    float lower_bounds[BRANCHING_FACTOR];
+                    osrm::ComputeRectangleMinDistances(input_coordinate, child_rectangles,
+                                                       current_tree_node.child_count,
+                                                       lower_bounds);
+
                     // for each child mbr
                     for (uint32_t i = 0; i < current_tree_node.child_count; ++i)
                     {
                         const int32_t child_id = current_tree_node.children[i];
                         const TreeNode &child_tree_node = m_search_tree[child_id];
-                        const RectangleT &child_rectangle = child_tree_node.minimum_bounding_rectangle;
-                        const float lower_bound_to_element = child_rectangle.GetMinDist(input_coordinate);
+                        const float lower_bound_to_element = lower_bounds[i];
 
                         // TODO - enough elements found, i.e. nearest distance > maximum distance?
                         //        ie. some measure of 'confidence of accuracy'
@@ -937,8 +986,7 @@ class StaticRTree
             if (number_of_results == number_of_results_found_in_big_cc || inspected_segments >= max_checked_segments)
             {
                 // SimpleLogger().Write(logDEBUG) << "flushing queue of " << traversal_queue.size() << " elements";
-                // work-around for traversal_queue.clear();
-                traversal_queue = std::priority_queue<IncrementalQueryCandidate>{};
+                traversal_queue.clear();
             }
         }
 
@@ -949,7 +997,7 @@ class StaticRTree
 
     bool FindPhantomNodeForCoordinate(const FixedPointCoordinate &input_coordinate,
                                       PhantomNode &result_phantom_node,
-                                      const unsigned zoom_level)
+                                      const unsigned zoom_level) const
     {
         const bool ignore_tiny_components = (zoom_level <= 14);
         EdgeDataT nearest_edge;
@@ -957,7 +1005,7 @@ class StaticRTree
         float min_dist = std::numeric_limits<float>::max();
         float min_max_dist = std::numeric_limits<float>::max();
 
-        std::priority_queue<QueryCandidate> traversal_queue;
+        auto &traversal_queue = GetTraversalQueue(m_traversal_queue);
         traversal_queue.emplace(0.f, 0);
 
         while (!traversal_queue.empty())
@@ -972,8 +1020,11 @@ class StaticRTree
                 const TreeNode &current_tree_node = m_search_tree[current_query_node.node_id];
                 if (current_tree_node.child_is_on_disk)
                 {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(current_tree_node.children[0], current_leaf_node);
+                    const LeafNode &current_leaf_node = GetLeaf(current_tree_node.children[0]);
+                    float perpendicular_distances[LEAF_NODE_SIZE];
+                    osrm::ComputeSegmentDistances(input_coordinate, current_leaf_node.segments,
+                                                  current_leaf_node.object_count,
+                                                  perpendicular_distances);
                     for (uint32_t i = 0; i < current_leaf_node.object_count; ++i)
                     {
                         const EdgeDataT &current_edge = current_leaf_node.objects[i];
@@ -982,21 +1033,20 @@ class StaticRTree
                             continue;
                         }
 
-                        float current_ratio = 0.;
-                        FixedPointCoordinate nearest;
-                        const float current_perpendicular_distance =
+                        const float current_perpendicular_distance = perpendicular_distances[i];
+                        BOOST_ASSERT(0. <= current_perpendicular_distance);
+
+                        if ((current_perpendicular_distance < min_dist) &&
+                            !osrm::epsilon_compare(current_perpendicular_distance, min_dist))
+                        { // found a new minimum, only its foot point is computed
+                            float current_ratio = 0.;
+                            FixedPointCoordinate nearest;
                             FixedPointCoordinate::ComputePerpendicularDistance(
                                 m_coordinate_list->at(current_edge.u),
                                 m_coordinate_list->at(current_edge.v),
                                 input_coordinate,
                                 nearest,
                                 current_ratio);
-
-                        BOOST_ASSERT(0. <= current_perpendicular_distance);
-
-                        if ((current_perpendicular_distance < min_dist) &&
-                            !osrm::epsilon_compare(current_perpendicular_distance, min_dist))
-                        { // found a new minimum
                             min_dist = current_perpendicular_distance;
                             result_phantom_node = {current_edge.forward_edge_based_node_id,
                                                    current_edge.reverse_edge_based_node_id,
@@ -1084,17 +1134,24 @@ class StaticRTree
                                  const FixedPointCoordinate &input_coordinate,
                                  const float min_dist,
                                  const float min_max_dist,
-                                 QueueT &traversal_queue)
+                                 QueueT &traversal_queue) const
     {
+        osrm::RectangleArrays<BRANCHING_FACTOR> child_rectangles;
+        GetChildRectangles(parent, child_rectangles);
+        float lower_bounds[BRANCHING_FACTOR];
+        float upper_bounds[BRANCHING_FACTOR];
+        osrm::ComputeRectangleMinDistances(input_coordinate, child_rectangles, parent.child_count,
+                                           lower_bounds);
+        osrm::ComputeRectangleMinMaxDistances(input_coordinate, child_rectangles,
+                                              parent.child_count, upper_bounds);
+
         float new_min_max_dist = min_max_dist;
         // traverse children, prune if global mindist is smaller than local one
         for (uint32_t i = 0; i < parent.child_count; ++i)
         {
             const int32_t child_id = parent.children[i];
-            const TreeNode &child_tree_node = m_search_tree[child_id];
-            const RectangleT &child_rectangle = child_tree_node.minimum_bounding_rectangle;
-            const float lower_bound_to_element = child_rectangle.GetMinDist(input_coordinate);
-            const float upper_bound_to_element = child_rectangle.GetMinMaxDist(input_coordinate);
+            const float lower_bound_to_element = lower_bounds[i];
+            const float upper_bound_to_element = upper_bounds[i];
             new_min_max_dist = std::min(new_min_max_dist, upper_bound_to_element);
             if (lower_bound_to_element > new_min_max_dist)
             {
@@ -1109,23 +1166,46 @@ class StaticRTree
         return new_min_max_dist;
     }
 
-    inline void LoadLeafFromDisk(const uint32_t leaf_id, LeafNode &result_node)
+    // copies the bounding rectangles of the children into the layout of the distance kernels
+    inline void GetChildRectangles(const TreeNode &parent,
+                                   osrm::RectangleArrays<BRANCHING_FACTOR> &child_rectangles) const
     {
-        if (!leaves_stream.is_open())
+        for (uint32_t i = 0; i < parent.child_count; ++i)
         {
-            leaves_stream.open(m_leaf_node_filename, std::ios::in | std::ios::binary);
+            const RectangleT &child_rectangle =
+                m_search_tree[parent.children[i]].minimum_bounding_rectangle;
+            child_rectangles.Set(i, child_rectangle.min_lat, child_rectangle.max_lat,
+                                 child_rectangle.min_lon, child_rectangle.max_lon);
         }
-        if (!leaves_stream.good())
+    }
+
+    void MapLeaves(const boost::filesystem::path &leaf_file)
+    {
+        m_leaves_region.open(leaf_file.string());
+        if (m_leaves_region.size() < sizeof(uint64_t))
         {
-            leaves_stream.clear(std::ios::goodbit);
-            SimpleLogger().Write(logDEBUG) << "Resetting stale filestream";
+            throw osrm::exception("mem index file is truncated");
         }
-        const uint64_t seek_pos = sizeof(uint64_t) + leaf_id * sizeof(LeafNode);
-        leaves_stream.seekg(seek_pos);
-        BOOST_ASSERT_MSG(leaves_stream.good(),
-                         "Seeking to position in leaf file failed.");
-        leaves_stream.read((char *)&result_node, sizeof(LeafNode));
-        BOOST_ASSERT_MSG(leaves_stream.good(), "Reading from leaf file failed.");
+        const char *leaf_data = m_leaves_region.data();
+        m_element_count = *reinterpret_cast<const uint64_t *>(leaf_data);
+        const uint64_t number_of_leaves = (m_element_count + LEAF_NODE_SIZE - 1) / LEAF_NODE_SIZE;
+        if (m_leaves_region.size() < sizeof(uint64_t) + number_of_leaves * sizeof(LeafNode))
+        {
+            throw osrm::exception("mem index file is truncated");
+        }
+        m_leaves = reinterpret_cast<const LeafNode *>(leaf_data + sizeof(uint64_t));
+#ifndef _WIN32
+        // Pull the whole file into the page cache in the background, so that the first queries
+        // do not wait for single leaves to be faulted in.
+        posix_madvise(const_cast<char *>(leaf_data), m_leaves_region.size(), POSIX_MADV_WILLNEED);
+#endif
+    }
+
+    inline const LeafNode &GetLeaf(const uint32_t leaf_id) const
+    {
+        BOOST_ASSERT(m_leaves_region.is_open());
+        BOOST_ASSERT(sizeof(uint64_t) + (leaf_id + 1) * sizeof(LeafNode) <= m_leaves_region.size());
+        return m_leaves[leaf_id];
     }
 
     inline bool EdgesAreEquivalent(const FixedPointCoordinate &a,
@@ -1164,6 +1244,42 @@ class StaticRTree
     }
 };
 
+template <class EdgeDataT,
+          class CoordinateListT,
+          bool UseSharedMemory,
+          uint32_t BRANCHING_FACTOR,
+          uint32_t LEAF_NODE_SIZE>
+boost::thread_specific_ptr<typename StaticRTree<EdgeDataT,
+                                                CoordinateListT,
+                                                UseSharedMemory,
+                                                BRANCHING_FACTOR,
+                                                LEAF_NODE_SIZE>::template TraversalQueue<
+    typename StaticRTree<EdgeDataT,
+                         CoordinateListT,
+                         UseSharedMemory,
+                         BRANCHING_FACTOR,
+                         LEAF_NODE_SIZE>::QueryCandidate>>
+    StaticRTree<EdgeDataT, CoordinateListT, UseSharedMemory, BRANCHING_FACTOR, LEAF_NODE_SIZE>::
+        m_traversal_queue;
+
+template <class EdgeDataT,
+          class CoordinateListT,
+          bool UseSharedMemory,
+          uint32_t BRANCHING_FACTOR,
+          uint32_t LEAF_NODE_SIZE>
+boost::thread_specific_ptr<typename StaticRTree<EdgeDataT,
+                                                CoordinateListT,
+                                                UseSharedMemory,
+                                                BRANCHING_FACTOR,
+                                                LEAF_NODE_SIZE>::template TraversalQueue<
+    typename StaticRTree<EdgeDataT,
+                         CoordinateListT,
+                         UseSharedMemory,
+                         BRANCHING_FACTOR,
+                         LEAF_NODE_SIZE>::IncrementalQueryCandidate>>
+    StaticRTree<EdgeDataT, CoordinateListT, UseSharedMemory, BRANCHING_FACTOR, LEAF_NODE_SIZE>::
+        m_incremental_traversal_queue;
+
 //[1] "On Packing R-Trees"; I. Kamel, C. Faloutsos; 1993; DOI: 10.1145/170088.170403
 //[2] "Nearest Neighbor Queries", N. Roussopulos et al; 1995; DOI: 10.1145/223784.223794
 //[3] "Distance Browsing in Spatial Databases"; G. Hjaltason, H. Samet; 1999; ACM Trans. DB Sys
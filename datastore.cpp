@@ -30,7 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "data_structures/query_edge.hpp"
 #include "data_structures/shared_memory_factory.hpp"
 #include "data_structures/shared_memory_vector_wrapper.hpp"
-#include "data_structures/static_graph.hpp"
+#include "data_structures/static_query_graph.hpp"
 #include "data_structures/static_rtree.hpp"
 #include "data_structures/turn_instructions.hpp"
 #include "Server/DataStructures/BaseDataFacade.h"
@@ -41,13 +41,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Util/simple_logger.hpp"
 #include "Util/osrm_exception.hpp"
 #include "Util/FingerPrint.h"
+#include "Util/integer_range.hpp"
 #include "typedefs.h"
 
 #include <osrm/Coordinate.h>
 
 using RTreeLeaf = BaseDataFacade<QueryEdge::EdgeData>::RTreeLeaf;
 using RTreeNode = StaticRTree<RTreeLeaf, ShM<FixedPointCoordinate, true>::vector, true>::TreeNode;
-using QueryGraph = StaticGraph<QueryEdge::EdgeData>;
+using QueryGraph = StaticQueryGraph<true>;
 
 #ifdef __linux__
 #include <sys/mman.h>
@@ -58,8 +59,10 @@ using QueryGraph = StaticGraph<QueryEdge::EdgeData>;
 
 #include <cstdint>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
+#include <vector>
 
 // delete a shared memory region. report warning if it could not be deleted
 void delete_region(const SharedDataType region)
@@ -195,6 +198,9 @@ int main(const int argc, const char *argv[])
         BOOST_ASSERT(server_paths.end() != paths_iterator);
         BOOST_ASSERT(!paths_iterator->second.empty());
         const boost::filesystem::path &geometries_data_path = paths_iterator->second;
+        paths_iterator = server_paths.find("levelorder");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path &level_order_path = paths_iterator->second;
 
         // determine segment to use
         bool segment2_in_use = SharedMemory::RegionExists(LAYOUT_2);
@@ -290,6 +296,8 @@ int main(const int argc, const char *argv[])
         // BOOST_ASSERT_MSG(0 != number_of_graph_edges, "number of graph edges is zero");
         shared_layout_ptr->SetBlockSize<QueryGraph::EdgeArrayEntry>(
             SharedDataLayout::GRAPH_EDGE_LIST, number_of_graph_edges);
+        shared_layout_ptr->SetBlockSize<QueryGraph::EdgeIDArrayEntry>(
+            SharedDataLayout::GRAPH_EDGE_ID_LIST, number_of_graph_edges);
 
         // load rsearch tree size
         boost::filesystem::ifstream tree_node_file(ram_index_path, std::ios::binary);
@@ -324,6 +332,29 @@ int main(const int argc, const char *argv[])
         }
         shared_layout_ptr->SetBlockSize<char>(SharedDataLayout::TIMESTAMP, m_timestamp.length());
 
+        // load level order size, the file is optional and only needed for one-to-all queries
+        boost::filesystem::ifstream level_order_input_stream;
+        unsigned level_order_size = 0;
+        if (!level_order_path.empty() && boost::filesystem::exists(level_order_path))
+        {
+            level_order_input_stream.open(level_order_path, std::ios::binary);
+            level_order_input_stream.read((char *)&level_order_size, sizeof(unsigned));
+            // the node array of the graph has a sentinel element
+            if (level_order_size + 1 != number_of_graph_nodes)
+            {
+                SimpleLogger().Write(logWARNING) << level_order_path
+                                                 << " does not match the graph, ignoring it";
+                level_order_size = 0;
+                level_order_input_stream.close();
+            }
+        }
+        else
+        {
+            SimpleLogger().Write(logWARNING) << "level order file " << level_order_path
+                                             << " not found, one-to-all queries are disabled";
+        }
+        shared_layout_ptr->SetBlockSize<NodeID>(SharedDataLayout::LEVEL_ORDER, level_order_size);
+
         // load coordinate size
         boost::filesystem::ifstream nodes_input_stream(nodes_data_path, std::ios::binary);
         unsigned coordinate_list_size = 0;
@@ -495,6 +526,17 @@ int main(const int argc, const char *argv[])
             shared_memory_ptr, SharedDataLayout::TIMESTAMP);
         std::copy(m_timestamp.c_str(), m_timestamp.c_str() + m_timestamp.length(), timestamp_ptr);
 
+        // store level order
+        NodeID *level_order_ptr = shared_layout_ptr->GetBlockPtr<NodeID, true>(
+            shared_memory_ptr, SharedDataLayout::LEVEL_ORDER);
+        if (shared_layout_ptr->GetBlockSize(SharedDataLayout::LEVEL_ORDER) > 0)
+        {
+            level_order_input_stream.read(
+                (char *)level_order_ptr,
+                shared_layout_ptr->GetBlockSize(SharedDataLayout::LEVEL_ORDER));
+            level_order_input_stream.close();
+        }
+
         // store search tree portion of rtree
         char *rtree_ptr = shared_layout_ptr->GetBlockPtr<char, true>(
             shared_memory_ptr, SharedDataLayout::R_SEARCH_TREE);
@@ -516,15 +558,31 @@ int main(const int argc, const char *argv[])
                 shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_NODE_LIST));
         }
 
-        // load the edges of the search graph
+        // load the edges of the search graph, split into the searched and the id part
         QueryGraph::EdgeArrayEntry *graph_edge_list_ptr =
             shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeArrayEntry, true>(
                 shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_LIST);
-        if (shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST) > 0)
+        QueryGraph::EdgeIDArrayEntry *graph_edge_id_list_ptr =
+            shared_layout_ptr->GetBlockPtr<QueryGraph::EdgeIDArrayEntry, true>(
+                shared_memory_ptr, SharedDataLayout::GRAPH_EDGE_ID_LIST);
         {
-            hsgr_input_stream.read(
-                (char *)graph_edge_list_ptr,
-                shared_layout_ptr->GetBlockSize(SharedDataLayout::GRAPH_EDGE_LIST));
+            std::vector<QueryGraph::InputEdgeArrayEntry> input_edge_buffer(1 << 16);
+            uint64_t edges_read = 0;
+            while (edges_read < number_of_graph_edges)
+            {
+                const uint64_t edges_in_buffer = std::min<uint64_t>(
+                    input_edge_buffer.size(), number_of_graph_edges - edges_read);
+                hsgr_input_stream.read((char *)input_edge_buffer.data(),
+                                       edges_in_buffer * sizeof(QueryGraph::InputEdgeArrayEntry));
+                for (const auto i : osrm::irange<uint64_t>(0, edges_in_buffer))
+                {
+                    graph_edge_list_ptr[edges_read + i] =
+                        QueryGraph::EdgeArrayEntry(input_edge_buffer[i]);
+                    graph_edge_id_list_ptr[edges_read + i] =
+                        QueryGraph::EdgeIDArrayEntry(input_edge_buffer[i]);
+                }
+                edges_read += edges_in_buffer;
+            }
         }
         hsgr_input_stream.close();
 
@@ -55,7 +55,8 @@ struct DescriptorTable : public std::unordered_map<std::string, unsigned>
 
 struct DescriptorConfig
 {
-    DescriptorConfig() : instructions(true), geometry(true), encode_geometry(true), zoom_level(18)
+    DescriptorConfig()
+        : instructions(true), geometry(true), encode_geometry(true), debug(false), zoom_level(18)
     {
     }
 
@@ -63,6 +64,7 @@ struct DescriptorConfig
     DescriptorConfig(const OtherT &other) : instructions(other.print_instructions),
                                             geometry(other.geometry),
                                             encode_geometry(other.compression),
+                                            debug(other.debug),
                                             zoom_level(other.zoom_level)
     {
         BOOST_ASSERT(zoom_level >= 0);
@@ -71,6 +73,7 @@ struct DescriptorConfig
     bool instructions;
     bool geometry;
     bool encode_geometry;
+    bool debug;
     short zoom_level;
 };
 
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../algorithms/object_encoder.hpp"
 #include "../algorithms/route_name_extraction.hpp"
 #include "../data_structures/json_container.hpp"
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/segment_information.hpp"
 #include "../data_structures/turn_instructions.hpp"
 #include "../Util/bearing.hpp"
@@ -40,7 +41,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../Util/json_renderer.hpp"
 #include "../Util/simple_logger.hpp"
 #include "../Util/string_util.hpp"
-#include "../Util/timing_util.hpp"
 
 #include <algorithm>
 
@@ -99,6 +99,7 @@ template <class DataFacadeT> class JSONDescriptor final : public BaseDescriptor<
 
     void Run(const RawRouteData &raw_route, http::Reply &reply) final
     {
+        PhaseTimer description_timer(&QueryStatistics::description_time);
         JSON::Object json_result;
         if (INVALID_EDGE_WEIGHT == raw_route.shortest_path_length)
         {
@@ -293,11 +294,15 @@ template <class DataFacadeT> class JSONDescriptor final : public BaseDescriptor<
         json_hint_object.values["locations"] = json_location_hint_array;
         json_result.values["hint_data"] = json_hint_object;
 
+        description_timer.Stop();
+        if (config.debug)
+        {
+            json_result.values["debug"] = QueryStatistics::ThreadLocal().ToJSON();
+        }
+
         // render the content to the output array
-        TIMER_START(route_render);
+        PhaseTimer render_timer(&QueryStatistics::render_time);
         JSON::render(reply.content, json_result);
-        TIMER_STOP(route_render);
-        SimpleLogger().Write(logDEBUG) << "rendering took: " << TIMER_MSEC(route_render);
     }
 
     // TODO: reorder parameters
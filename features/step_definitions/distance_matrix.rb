@@ -4,16 +4,20 @@ When /^I request a travel time matrix I should get$/ do |table|
   
   raise "*** Top-left cell of matrix table must be empty" unless table.headers[0]==""
   
-  nodes = []
   column_headers = table.headers[1..-1]
   row_headers = table.rows.map { |h| h.first }
-  unless column_headers==row_headers
-    raise "*** Column and row headers must match in matrix table, got #{column_headers.inspect} and #{row_headers.inspect}"
+  # a square table with matching headers is requested with plain locations,
+  # otherwise rows are sent as sources and columns as destinations
+  symmetric = column_headers==row_headers
+  sources = row_headers.map do |node_name|
+    node = find_node_by_name(node_name)
+    raise "*** unknown node '#{node_name}" unless node
+    node
   end
-  column_headers.each do |node_name|
+  destinations = column_headers.map do |node_name|
     node = find_node_by_name(node_name)
     raise "*** unknown node '#{node_name}" unless node
-    nodes << node
+    node
   end
   
   reprocess
@@ -23,7 +27,11 @@ When /^I request a travel time matrix I should get$/ do |table|
     
     # compute matrix
     params = @query_params
-    response = request_table nodes, params
+    if symmetric
+      response = request_table sources, params
+    else
+      response = request_table_with_sources sources, destinations, params
+    end
     if response.body.empty? == false
       json = JSON.parse response.body
       result = json['distance_table']
@@ -34,7 +42,7 @@ When /^I request a travel time matrix I should get$/ do |table|
       
       # fuzzy match
       ok = true
-      0.upto(nodes.size-1) do |i|
+      0.upto(destinations.size-1) do |i|
         if FuzzyMatch.match result[ri][i], row[i+1]
           result[ri][i] = row[i+1]
         elsif row[i+1]=="" and result[ri][i]==no_route
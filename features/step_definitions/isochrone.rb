@@ -0,0 +1,35 @@
+When /^I request travel times from "([^"]*)" I should get$/ do |source_name,table|
+  reprocess
+  actual = []
+  OSRMLoader.load(self,"#{prepared_file}.osrm") do
+    source = find_node_by_name source_name
+    raise "*** unknown source node '#{source_name}" unless source
+
+    targets = table.hashes.map do |row|
+      node = find_node_by_name row['to']
+      raise "*** unknown node '#{row['to']}" unless node
+      node
+    end
+
+    response = request_isochrone [source] + targets, @query_params
+    if response.code == "200" && response.body.empty? == false
+      json = JSON.parse response.body
+      if json['status'] == 0
+        times = json['travel_times']
+      end
+    end
+    times ||= []
+
+    table.hashes.each_with_index do |row,ri|
+      got = {'to' => row['to'], 'time' => times[ri].to_s }
+      if FuzzyMatch.match times[ri], row['time']
+        got['time'] = row['time']
+      else
+        failed = { :attempt => 'isochrone', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -13,6 +13,10 @@ end
 
 def request_path path, waypoints=[], options={}
   locs = waypoints.compact.map { |w| "loc=#{w.lat},#{w.lon}" }
+  request_path_with_locations path, locs, options
+end
+
+def request_path_with_locations path, locs, options={}
   params = (locs + options.to_param).join('&')
   params = nil if params==""
   uri = URI.parse ["#{HOST}/#{path}", params].compact.join('?')
@@ -48,6 +52,18 @@ def request_table waypoints, params={}
   request_path "table", waypoints, defaults.merge(params)
 end
 
+def request_isochrone waypoints, params={}
+  defaults = { 'output' => 'json' }
+  request_path "isochrone", waypoints, defaults.merge(params)
+end
+
+def request_table_with_sources sources, destinations, params={}
+  defaults = { 'output' => 'json' }
+  locs = sources.compact.map { |w| "src=#{w.lat},#{w.lon}" } +
+         destinations.compact.map { |w| "dst=#{w.lat},#{w.lon}" }
+  request_path_with_locations "table", locs, defaults.merge(params)
+end
+
 def got_route? response
   if response.code == "200" && !response.body.empty?
     json = JSON.parse response.body
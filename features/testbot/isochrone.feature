@@ -0,0 +1,37 @@
+@isochrone @testbot
+Feature: One-to-all travel times
+# note that results are travel time, specified in 1/10th of seconds
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Testbot - Travel times along a single way
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request travel times from "a" I should get
+            | to | time |
+            | b  | 100  |
+            | c  | 200  |
+            | d  | 300  |
+
+    Scenario: Testbot - Travel times with oneways
+        Given the node map
+            | x | a | b | y |
+            |   | d | e |   |
+
+        And the ways
+            | nodes | oneway |
+            | abeda | yes    |
+            | xa    |        |
+            | by    |        |
+
+        When I request travel times from "y" I should get
+            | to | time |
+            | x  | 500  |
+            | d  | 300  |
+            | e  | 200  |
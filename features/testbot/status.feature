@@ -50,6 +50,8 @@ Feature: Status messages
             | viaroute?loc=1,1&loc=1.01,1 | 0      | Found route between points                 |
             | nonsense                    | 400    | Bad Request                                |
             | nonsense?loc=1,1&loc=1.01,1 | 400    | Bad Request                                |
+            | viaroute?src=1,1&dst=1.01,1 | 400    | Bad Request                                |
+            | viaroute?loc=1,1&dst=1.01,1 | 400    | Bad Request                                |
             |                             | 400    | Query string malformed close to position 0 |
             | /                           | 400    | Query string malformed close to position 0 |
             | ?                           | 400    | Query string malformed close to position 0 |
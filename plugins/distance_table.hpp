@@ -33,12 +33,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../algorithms/object_encoder.hpp"
 #include "../data_structures/json_container.hpp"
 #include "../data_structures/query_edge.hpp"
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/search_engine.hpp"
 #include "../descriptors/descriptor_base.hpp"
 #include "../Util/json_renderer.hpp"
 #include "../Util/make_unique.hpp"
 #include "../Util/string_util.hpp"
-#include "../Util/timing_util.hpp"
 
 #include <cstdlib>
 
@@ -54,15 +54,18 @@ template <class DataFacadeT> class DistanceTablePlugin final : public BasePlugin
     std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
 
   public:
-    explicit DistanceTablePlugin(DataFacadeT *facade) : descriptor_string("table"), facade(facade)
+    DistanceTablePlugin(DataFacadeT *facade, ShortcutCache *shortcut_cache)
+        : descriptor_string("table"), facade(facade)
     {
-        search_engine_ptr = osrm::make_unique<SearchEngine<DataFacadeT>>(facade);
+        search_engine_ptr = osrm::make_unique<SearchEngine<DataFacadeT>>(facade, *shortcut_cache);
     }
 
     virtual ~DistanceTablePlugin() {}
 
     const std::string GetDescriptor() const final { return descriptor_string; }
 
+    bool SupportsSourcesAndDestinations() const final { return true; }
+
     void HandleRequest(const RouteParameters &route_parameters, http::Reply &reply) final
     {
         if (!check_all_coordinates(route_parameters.coordinates))
@@ -72,10 +75,18 @@ template <class DataFacadeT> class DistanceTablePlugin final : public BasePlugin
         }
 
         const bool checksum_OK = (route_parameters.check_sum == facade->GetCheckSum());
-        unsigned max_locations =
-            std::min(100u, static_cast<unsigned>(route_parameters.coordinates.size()));
-        PhantomNodeArray phantom_node_vector(max_locations);
-        for (const auto i : osrm::irange(0u, max_locations))
+        const auto number_of_coordinates = route_parameters.coordinates.size();
+        BOOST_ASSERT(route_parameters.is_source.size() == number_of_coordinates);
+        BOOST_ASSERT(route_parameters.is_destination.size() == number_of_coordinates);
+
+        PhantomNodeArray phantom_sources_array;
+        PhantomNodeArray phantom_targets_array;
+        PhaseTimer phantom_lookup_timer(&QueryStatistics::phantom_lookup_time);
+        // coordinates without a valid hint are snapped together in one batch
+        std::vector<std::vector<PhantomNode>> phantom_node_vectors(number_of_coordinates);
+        std::vector<FixedPointCoordinate> unhinted_coordinates;
+        std::vector<std::size_t> unhinted_indices;
+        for (const auto i : osrm::irange<std::size_t>(0, number_of_coordinates))
         {
             if (checksum_OK && i < route_parameters.hints.size() &&
                 !route_parameters.hints[i].empty())
@@ -84,44 +95,112 @@ template <class DataFacadeT> class DistanceTablePlugin final : public BasePlugin
                 ObjectEncoder::DecodeFromBase64(route_parameters.hints[i], current_phantom_node);
                 if (current_phantom_node.is_valid(facade->GetNumberOfNodes()))
                 {
-                    phantom_node_vector[i].emplace_back(std::move(current_phantom_node));
+                    phantom_node_vectors[i].emplace_back(std::move(current_phantom_node));
                     continue;
                 }
             }
-            facade->IncrementalFindPhantomNodeForCoordinate(route_parameters.coordinates[i],
-                                                            phantom_node_vector[i],
-                                                            1);
-
-            BOOST_ASSERT(phantom_node_vector[i].front().is_valid(facade->GetNumberOfNodes()));
+            unhinted_coordinates.push_back(route_parameters.coordinates[i]);
+            unhinted_indices.push_back(i);
+        }
+        std::vector<std::vector<PhantomNode>> snapped_phantom_node_vectors;
+        facade->IncrementalFindPhantomNodesForCoordinates(unhinted_coordinates,
+                                                          snapped_phantom_node_vectors, 1);
+        for (const auto j : osrm::irange<std::size_t>(0, unhinted_indices.size()))
+        {
+            phantom_node_vectors[unhinted_indices[j]] = std::move(snapped_phantom_node_vectors[j]);
         }
 
-        // TIMER_START(distance_table);
-        std::shared_ptr<std::vector<EdgeWeight>> result_table =
-            search_engine_ptr->distance_table(phantom_node_vector);
-        // TIMER_STOP(distance_table);
+        for (const auto i : osrm::irange<std::size_t>(0, number_of_coordinates))
+        {
+            std::vector<PhantomNode> &phantom_nodes = phantom_node_vectors[i];
+            BOOST_ASSERT(phantom_nodes.front().is_valid(facade->GetNumberOfNodes()));
+
+            if (route_parameters.is_source[i])
+            {
+                phantom_sources_array.push_back(phantom_nodes);
+            }
+            if (route_parameters.is_destination[i])
+            {
+                phantom_targets_array.emplace_back(std::move(phantom_nodes));
+            }
+        }
+        phantom_lookup_timer.Stop();
 
-        if (!result_table)
+        if (phantom_sources_array.empty() || phantom_targets_array.empty())
         {
             reply = http::Reply::StockReply(http::Reply::badRequest);
             return;
         }
 
-        JSON::Object json_object;
-        JSON::Array json_array;
-        const auto number_of_locations = phantom_node_vector.size();
-        for (const auto row : osrm::irange<std::size_t>(0, number_of_locations))
+        // The table is computed and rendered in tiles of whole rows, so that neither the full
+        // table nor a JSON tree of it have to be kept in memory for large requests.
+        const auto number_of_targets = phantom_targets_array.size();
+        const std::size_t rows_per_tile = std::max<std::size_t>(1, MAX_TILE_SIZE / number_of_targets);
+
+        const std::string table_prefix("{\"distance_table\":[");
+        reply.content.insert(reply.content.end(), table_prefix.begin(), table_prefix.end());
+        const auto render_tile = [&reply, number_of_targets](const std::size_t first_row,
+                                                             const std::vector<EdgeWeight> &tile)
+            {
+                PhaseTimer render_timer(&QueryStatistics::render_time);
+                const auto number_of_rows = tile.size() / number_of_targets;
+                for (const auto row : osrm::irange<std::size_t>(0, number_of_rows))
+                {
+                    if (first_row + row > 0)
+                    {
+                        reply.content.push_back(',');
+                    }
+                    JSON::Array json_row;
+                    auto row_begin_iterator = tile.begin() + (row * number_of_targets);
+                    auto row_end_iterator = tile.begin() + ((row + 1) * number_of_targets);
+                    json_row.values.insert(json_row.values.end(), row_begin_iterator,
+                                           row_end_iterator);
+                    JSON::render(reply.content, json_row);
+                }
+            };
+        // the tiles are rendered as they are computed, the search time includes their rendering
+        PhaseTimer search_timer(&QueryStatistics::search_time);
+        if (UseRestrictedSweeps(phantom_sources_array.size(), number_of_targets))
+        {
+            search_engine_ptr->distance_table_sweep(phantom_sources_array, phantom_targets_array,
+                                                    rows_per_tile, render_tile,
+                                                    route_parameters.deadline);
+        }
+        else
         {
-            JSON::Array json_row;
-            auto row_begin_iterator = result_table->begin() + (row * number_of_locations);
-            auto row_end_iterator = result_table->begin() + ((row + 1) * number_of_locations);
-            json_row.values.insert(json_row.values.end(), row_begin_iterator, row_end_iterator);
-            json_array.values.push_back(json_row);
+            search_engine_ptr->distance_table(phantom_sources_array, phantom_targets_array,
+                                              rows_per_tile, render_tile,
+                                              route_parameters.deadline);
         }
-        json_object.values["distance_table"] = json_array;
-        JSON::render(reply.content, json_object);
+        search_timer.Stop();
+        reply.content.push_back(']');
+        if (route_parameters.debug)
+        {
+            const std::string debug_prefix(",\"debug\":");
+            reply.content.insert(reply.content.end(), debug_prefix.begin(), debug_prefix.end());
+            JSON::render(reply.content, QueryStatistics::ThreadLocal().ToJSON());
+        }
+        reply.content.push_back('}');
     }
 
   private:
+    // upper bound on the number of table entries that are held in memory at once
+    static constexpr std::size_t MAX_TILE_SIZE = 1 << 20;
+    // Restricted sweeps pay for touching the whole search space of the larger side once, but
+    // then only run one search per table row (or column) of the smaller side. Buckets win for
+    // tables that are small or roughly square.
+    static constexpr std::size_t MIN_SWEEP_SIDE_RATIO = 16;
+    static constexpr std::size_t MIN_SWEEP_SIDE_SIZE = 256;
+
+    static bool UseRestrictedSweeps(const std::size_t number_of_sources,
+                                    const std::size_t number_of_targets)
+    {
+        const auto smaller_side = std::min(number_of_sources, number_of_targets);
+        const auto larger_side = std::max(number_of_sources, number_of_targets);
+        return larger_side >= MIN_SWEEP_SIDE_SIZE &&
+               larger_side >= MIN_SWEEP_SIDE_RATIO * smaller_side;
+    }
+
     std::string descriptor_string;
     DataFacadeT *facade;
 };
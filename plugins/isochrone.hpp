@@ -0,0 +1,210 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ISOCHRONE_PLUGIN_HPP
+#define ISOCHRONE_PLUGIN_HPP
+
+#include "plugin_base.hpp"
+
+#include "../algorithms/convex_hull.hpp"
+#include "../algorithms/object_encoder.hpp"
+#include "../data_structures/json_container.hpp"
+#include "../data_structures/query_statistics.hpp"
+#include "../data_structures/search_engine.hpp"
+#include "../Util/integer_range.hpp"
+#include "../Util/json_renderer.hpp"
+#include "../Util/make_unique.hpp"
+#include "../Util/simple_logger.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * This plugin computes travel times from one location to the whole road network in a single
+ * sweep. The first location is the source, travel times to all further locations are returned
+ * in 1/10th of seconds like in the distance table. If max_time (in seconds) is given, the
+ * convex hull of all road segments that are reachable within that time is returned as well.
+ */
+
+template <class DataFacadeT> class IsochronePlugin final : public BasePlugin
+{
+  private:
+    std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
+
+  public:
+    IsochronePlugin(DataFacadeT *facade, ShortcutCache *shortcut_cache)
+        : descriptor_string("isochrone"), facade(facade)
+    {
+        search_engine_ptr = osrm::make_unique<SearchEngine<DataFacadeT>>(facade, *shortcut_cache);
+    }
+
+    virtual ~IsochronePlugin() {}
+
+    const std::string GetDescriptor() const final { return descriptor_string; }
+
+    void HandleRequest(const RouteParameters &route_parameters, http::Reply &reply) final
+    {
+        const auto &coordinates = route_parameters.coordinates;
+        if (coordinates.empty() || (1 == coordinates.size() && 0 == route_parameters.max_time) ||
+            std::any_of(std::begin(coordinates), std::end(coordinates),
+                        [](const FixedPointCoordinate &coordinate)
+                        {
+                return !coordinate.is_valid();
+            }))
+        {
+            reply = http::Reply::StockReply(http::Reply::badRequest);
+            return;
+        }
+
+        const bool checksum_OK = (route_parameters.check_sum == facade->GetCheckSum());
+        std::vector<PhantomNode> phantom_node_vector(coordinates.size());
+        PhaseTimer phantom_lookup_timer(&QueryStatistics::phantom_lookup_time);
+        for (const auto i : osrm::irange<std::size_t>(0, coordinates.size()))
+        {
+            if (checksum_OK && i < route_parameters.hints.size() &&
+                !route_parameters.hints[i].empty())
+            {
+                ObjectEncoder::DecodeFromBase64(route_parameters.hints[i], phantom_node_vector[i]);
+                if (phantom_node_vector[i].is_valid(facade->GetNumberOfNodes()))
+                {
+                    continue;
+                }
+            }
+            facade->IncrementalFindPhantomNodeForCoordinate(coordinates[i], phantom_node_vector[i]);
+        }
+        phantom_lookup_timer.Stop();
+
+        JSON::Object json_result;
+        std::vector<EdgeWeight> distances;
+        const PhantomNode &phantom_source = phantom_node_vector.front();
+        if (!phantom_source.is_valid(facade->GetNumberOfNodes()))
+        {
+            json_result.values["status"] = 207;
+            json_result.values["status_message"] = "Cannot find source location";
+            JSON::render(reply.content, json_result);
+            return;
+        }
+        PhaseTimer search_timer(&QueryStatistics::search_time);
+        if (!search_engine_ptr->one_to_all(phantom_source, distances, route_parameters.deadline))
+        {
+            SimpleLogger().Write(logWARNING) << "no level order loaded, rerun osrm-prepare";
+            reply = http::Reply::StockReply(http::Reply::internalServerError);
+            return;
+        }
+        search_timer.Stop();
+        PhaseTimer description_timer(&QueryStatistics::description_time);
+        reply.status = http::Reply::ok;
+        json_result.values["status"] = 0;
+
+        JSON::Array json_travel_times;
+        for (const auto i : osrm::irange<std::size_t>(1, phantom_node_vector.size()))
+        {
+            json_travel_times.values.push_back(
+                phantom_node_vector[i].is_valid(facade->GetNumberOfNodes())
+                    ? search_engine_ptr->one_to_all.GetDistanceToTarget(distances,
+                                                                        phantom_node_vector[i])
+                    : INVALID_EDGE_WEIGHT);
+        }
+        json_result.values["travel_times"] = json_travel_times;
+
+        if (0 < route_parameters.max_time)
+        {
+            JSON::Array json_isochrone;
+            for (const FixedPointCoordinate &coordinate :
+                 ConvexHull::Of(GetReachableCoordinates(
+                     phantom_source, distances, 10 * static_cast<EdgeWeight>(route_parameters.max_time))))
+            {
+                JSON::Array json_coordinate;
+                json_coordinate.values.push_back(coordinate.lat / COORDINATE_PRECISION);
+                json_coordinate.values.push_back(coordinate.lon / COORDINATE_PRECISION);
+                json_isochrone.values.push_back(json_coordinate);
+            }
+            json_result.values["isochrone"] = json_isochrone;
+        }
+        description_timer.Stop();
+        if (route_parameters.debug)
+        {
+            json_result.values["debug"] = QueryStatistics::ThreadLocal().ToJSON();
+        }
+        PhaseTimer render_timer(&QueryStatistics::render_time);
+        JSON::render(reply.content, json_result);
+    }
+
+  private:
+    // Start coordinates of all road segments that are reached within max_distance. Every
+    // original edge (a, b) of the search graph has the intersection between segment a and b as
+    // its via node, i.e. the start of segment b.
+    std::vector<FixedPointCoordinate> GetReachableCoordinates(const PhantomNode &phantom_source,
+                                                              const std::vector<EdgeWeight> &distances,
+                                                              const EdgeWeight max_distance) const
+    {
+        std::vector<FixedPointCoordinate> reachable_coordinates;
+        reachable_coordinates.push_back(phantom_source.location);
+
+        const auto is_reachable = [&distances, max_distance](const NodeID node)
+        {
+            return INVALID_EDGE_WEIGHT != distances[node] && distances[node] <= max_distance;
+        };
+        std::vector<unsigned> geometry;
+        for (const auto node : osrm::irange(0u, facade->GetNumberOfNodes()))
+        {
+            for (const auto edge : facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = facade->GetEdgeData(edge);
+                if (data.shortcut)
+                {
+                    continue;
+                }
+                // a forward edge enters the segment of its target, a backward edge that of node
+                if (!(data.forward && is_reachable(facade->GetTarget(edge))) &&
+                    !(data.backward && is_reachable(node)))
+                {
+                    continue;
+                }
+                NodeID via_node = facade->GetGeometryIndexForEdgeID(data.id);
+                if (facade->EdgeIsCompressed(data.id))
+                {
+                    facade->GetUncompressedGeometry(via_node, geometry);
+                    if (geometry.empty())
+                    {
+                        continue;
+                    }
+                    via_node = geometry.back();
+                }
+                reachable_coordinates.push_back(facade->GetCoordinateOfNode(via_node));
+            }
+        }
+        return reachable_coordinates;
+    }
+
+    std::string descriptor_string;
+    DataFacadeT *facade;
+};
+
+#endif // ISOCHRONE_PLUGIN_HPP
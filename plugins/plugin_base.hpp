@@ -43,6 +43,8 @@ class BasePlugin
     virtual ~BasePlugin() {}
     virtual const std::string GetDescriptor() const = 0;
     virtual void HandleRequest(const RouteParameters &routeParameters, http::Reply &reply) = 0;
+    // whether the plugin tells src= sources and dst= destinations apart from loc= locations
+    virtual bool SupportsSourcesAndDestinations() const { return false; }
     virtual bool check_all_coordinates(const std::vector<FixedPointCoordinate> coordinates) const final
     {
         if (2 > coordinates.size() ||
@@ -0,0 +1,72 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STATISTICS_PLUGIN_HPP
+#define STATISTICS_PLUGIN_HPP
+
+#include "plugin_base.hpp"
+
+#include "../data_structures/json_container.hpp"
+#include "../data_structures/query_histograms.hpp"
+#include "../data_structures/shortcut_cache.hpp"
+#include "../Util/json_renderer.hpp"
+
+#include <string>
+
+// Reports the histograms of the query statistics of all services and the hits and misses of the
+// shortcut cache since the server started.
+class StatisticsPlugin final : public BasePlugin
+{
+  public:
+    StatisticsPlugin(const QueryHistograms *query_histograms, const ShortcutCache *shortcut_cache)
+        : query_histograms(query_histograms), shortcut_cache(shortcut_cache),
+          descriptor_string("statistics")
+    {
+    }
+    const std::string GetDescriptor() const final { return descriptor_string; }
+    void HandleRequest(const RouteParameters &route_parameters, http::Reply &reply) final
+    {
+        reply.status = http::Reply::ok;
+        JSON::Object json_result;
+        json_result.values["status"] = 0;
+        json_result.values["histograms"] = query_histograms->ToJSON();
+        JSON::Object json_shortcut_cache;
+        json_shortcut_cache.values["hits"] =
+            JSON::Number(static_cast<double>(shortcut_cache->GetNumberOfHits()));
+        json_shortcut_cache.values["misses"] =
+            JSON::Number(static_cast<double>(shortcut_cache->GetNumberOfMisses()));
+        json_result.values["shortcut_cache"] = json_shortcut_cache;
+        JSON::render(reply.content, json_result);
+    }
+
+  private:
+    const QueryHistograms *query_histograms;
+    const ShortcutCache *shortcut_cache;
+    std::string descriptor_string;
+};
+
+#endif // STATISTICS_PLUGIN_HPP
@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "plugin_base.hpp"
 
 #include "../algorithms/object_encoder.hpp"
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/search_engine.hpp"
 #include "../descriptors/descriptor_base.hpp"
 #include "../descriptors/gpx_descriptor.hpp"
@@ -43,6 +44,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstdlib>
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,15 +52,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
 {
   private:
+    // Searching every leg on its own costs up to twice the searches of carrying distances
+    // from leg to leg, which only pays off once there are enough legs to keep the cores busy.
+    static constexpr std::size_t MIN_PARALLEL_LEGS = 4;
+
     DescriptorTable descriptor_table;
     std::string descriptor_string;
     std::unique_ptr<SearchEngine<DataFacadeT>> search_engine_ptr;
     DataFacadeT *facade;
 
   public:
-    explicit ViaRoutePlugin(DataFacadeT *facade) : descriptor_string("viaroute"), facade(facade)
+    ViaRoutePlugin(DataFacadeT *facade, ShortcutCache *shortcut_cache)
+        : descriptor_string("viaroute"), facade(facade)
     {
-        search_engine_ptr = osrm::make_unique<SearchEngine<DataFacadeT>>(facade);
+        search_engine_ptr = osrm::make_unique<SearchEngine<DataFacadeT>>(facade, *shortcut_cache);
 
         descriptor_table.emplace("json", 0);
         descriptor_table.emplace("gpx", 1);
@@ -81,6 +88,10 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
         std::vector<phantom_node_pair> phantom_node_pair_list(route_parameters.coordinates.size());
         const bool checksum_OK = (route_parameters.check_sum == facade->GetCheckSum());
 
+        PhaseTimer phantom_lookup_timer(&QueryStatistics::phantom_lookup_time);
+        // coordinates without a valid hint are snapped together in one batch
+        std::vector<FixedPointCoordinate> unhinted_coordinates;
+        std::vector<std::size_t> unhinted_indices;
         for (const auto i : osrm::irange<std::size_t>(0, route_parameters.coordinates.size()))
         {
             if (checksum_OK && i < route_parameters.hints.size() &&
@@ -93,11 +104,18 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
                     continue;
                 }
             }
-            std::vector<PhantomNode> phantom_node_vector;
-            if (facade->IncrementalFindPhantomNodeForCoordinate(route_parameters.coordinates[i],
-                                                                phantom_node_vector, 1))
+            unhinted_coordinates.push_back(route_parameters.coordinates[i]);
+            unhinted_indices.push_back(i);
+        }
+        std::vector<std::vector<PhantomNode>> phantom_node_vectors;
+        facade->IncrementalFindPhantomNodesForCoordinates(unhinted_coordinates,
+                                                          phantom_node_vectors, 1);
+        for (const auto j : osrm::irange<std::size_t>(0, unhinted_indices.size()))
+        {
+            const std::vector<PhantomNode> &phantom_node_vector = phantom_node_vectors[j];
+            if (!phantom_node_vector.empty())
             {
-                BOOST_ASSERT(!phantom_node_vector.empty());
+                const auto i = unhinted_indices[j];
                 phantom_node_pair_list[i].first = phantom_node_vector.front();
                 if (phantom_node_vector.size() > 1)
                 {
@@ -105,6 +123,7 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
                 }
             }
         }
+        phantom_lookup_timer.Stop();
 
         auto check_component_id_is_tiny = [](const phantom_node_pair &phantom_pair)
         {
@@ -152,16 +171,27 @@ template <class DataFacadeT> class ViaRoutePlugin final : public BasePlugin
         };
         osrm::for_each_pair(phantom_node_pair_list, build_phantom_pairs);
 
+        PhaseTimer search_timer(&QueryStatistics::search_time);
         if (route_parameters.alternate_route && 1 == raw_route.segment_end_coordinates.size())
         {
-            search_engine_ptr->alternative_path(raw_route.segment_end_coordinates.front(),
-                                                raw_route);
+            search_engine_ptr->alternative_path(
+                raw_route.segment_end_coordinates.front(), raw_route,
+                std::chrono::milliseconds(route_parameters.alternate_route_budget),
+                route_parameters.deadline);
+        }
+        else if (raw_route.segment_end_coordinates.size() >= MIN_PARALLEL_LEGS)
+        {
+            search_engine_ptr->shortest_path_parallel(raw_route.segment_end_coordinates,
+                                                      route_parameters.uturns, raw_route,
+                                                      route_parameters.deadline);
         }
         else
         {
             search_engine_ptr->shortest_path(raw_route.segment_end_coordinates,
-                                             route_parameters.uturns, raw_route);
+                                             route_parameters.uturns, raw_route,
+                                             route_parameters.deadline);
         }
+        search_timer.Stop();
 
         if (INVALID_EDGE_WEIGHT == raw_route.shortest_path_length)
         {
@@ -69,18 +69,25 @@ int main(int argc, const char *argv[])
     {
         LogPolicy::GetInstance().Unmute();
 
-        bool use_shared_memory = false, trial_run = false;
+        bool use_shared_memory = false, trial_run = false, use_io_sharding = false;
         std::string ip_address;
         int ip_port, requested_thread_num;
+        unsigned keep_alive_timeout, max_keep_alive_requests, access_log_sampling_interval;
 
         ServerPaths server_paths;
+        QueryBudgets query_budgets;
 
         const unsigned init_result = GenerateServerProgramOptions(argc,
                                                                   argv,
                                                                   server_paths,
+                                                                  query_budgets,
                                                                   ip_address,
                                                                   ip_port,
                                                                   requested_thread_num,
+                                                                  keep_alive_timeout,
+                                                                  max_keep_alive_requests,
+                                                                  use_io_sharding,
+                                                                  access_log_sampling_interval,
                                                                   use_shared_memory,
                                                                   trial_run);
         if (init_result == INIT_OK_DO_NOT_START_ENGINE)
@@ -117,9 +124,11 @@ int main(int argc, const char *argv[])
         pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-        OSRM osrm_lib(server_paths, use_shared_memory);
+        OSRM osrm_lib(server_paths, use_shared_memory, query_budgets);
         auto routing_server =
-            Server::CreateServer(ip_address, ip_port, requested_thread_num);
+            Server::CreateServer(ip_address, ip_port, requested_thread_num, keep_alive_timeout,
+                                 max_keep_alive_requests, use_io_sharding,
+                                 access_log_sampling_interval);
 
         routing_server->GetRequestHandlerPtr().RegisterRoutingMachine(&osrm_lib);
 
@@ -29,20 +29,28 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define ALTERNATIVE_PATH_ROUTING_HPP
 
 #include "routing_base.hpp"
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/search_engine_data.hpp"
 #include "../Util/integer_range.hpp"
 #include "../Util/container.hpp"
 
 #include <boost/assert.hpp>
 
-#include <unordered_map>
-#include <unordered_set>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 const double VIAPATH_ALPHA = 0.10;
 const double VIAPATH_EPSILON = 0.15; // alternative at most 15% longer
 const double VIAPATH_GAMMA = 0.75;   // alternative shares at most 75% with the shortest.
+// number of best ranked via node candidates that are T-tested at the same time
+const std::size_t VIAPATH_T_TEST_BATCH_SIZE = 8;
 
 template <class DataFacadeT> class AlternativeRouting final : private BasicRoutingInterface<DataFacadeT>
 {
@@ -50,6 +58,11 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
     using EdgeData = typename DataFacadeT::EdgeData;
     using QueryHeap = SearchEngineData::QueryHeap;
     using SearchSpaceEdge = std::pair<NodeID, NodeID>;
+    using SharingStorage = SearchEngineData::SharingStorage;
+    using Clock = std::chrono::steady_clock;
+
+    // value of the sharing storage for nodes that have no sharing with the shortest path
+    static constexpr int UNKNOWN_SHARING = std::numeric_limits<int>::max();
 
     struct RankedCandidateNode
     {
@@ -67,19 +80,42 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             return (2 * length + sharing) < (2 * other.length + other.sharing);
         }
     };
+
+    struct TTestResult
+    {
+        TTestResult() : passed(false), length_of_via_path(INVALID_EDGE_WEIGHT) {}
+
+        bool passed;
+        int length_of_via_path;
+        std::vector<NodeID> packed_via_path;
+    };
     DataFacadeT *facade;
     SearchEngineData &engine_working_data;
 
   public:
-    AlternativeRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
-        : super(facade), facade(facade), engine_working_data(engine_working_data)
+    AlternativeRouting(DataFacadeT *facade,
+                       SearchEngineData &engine_working_data,
+                       ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), facade(facade), engine_working_data(engine_working_data)
     {
     }
 
     virtual ~AlternativeRouting() {}
 
-    void operator()(const PhantomNodes &phantom_node_pair, RawRouteData &raw_route_data)
+    // A latency budget other than zero limits the time spent on the alternative. Once it is
+    // used up, the remaining candidates are dropped and only the shortest path is returned.
+    void operator()(const PhantomNodes &phantom_node_pair,
+                    RawRouteData &raw_route_data,
+                    const std::chrono::milliseconds latency_budget = std::chrono::milliseconds::zero(),
+                    const QueryDeadline &deadline = QueryDeadline())
     {
+        const Clock::time_point start_time = Clock::now();
+        const auto is_over_budget = [start_time, latency_budget]()
+        {
+            return latency_budget != std::chrono::milliseconds::zero() &&
+                   Clock::now() - start_time > latency_budget;
+        };
+
         std::vector<NodeID> alternative_path;
         std::vector<NodeID> via_node_candidate_list;
         std::vector<SearchSpaceEdge> forward_search_space;
@@ -90,13 +126,11 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             super::facade->GetNumberOfNodes());
         engine_working_data.InitializeOrClearSecondThreadLocalStorage(
             super::facade->GetNumberOfNodes());
-        engine_working_data.InitializeOrClearThirdThreadLocalStorage(
+        engine_working_data.InitializeOrClearSharingThreadLocalStorage(
             super::facade->GetNumberOfNodes());
 
         QueryHeap &forward_heap1 = *(engine_working_data.forwardHeap);
         QueryHeap &reverse_heap1 = *(engine_working_data.backwardHeap);
-        QueryHeap &forward_heap2 = *(engine_working_data.forwardHeap2);
-        QueryHeap &reverse_heap2 = *(engine_working_data.backwardHeap2);
 
         int upper_bound_to_shortest_path_distance = INVALID_EDGE_WEIGHT;
         NodeID middle_node = SPECIAL_NODEID;
@@ -144,8 +178,10 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         }
 
         // search from s and t till new_min/(1+epsilon) > length_of_shortest_path
+        unsigned settled_nodes = 0;
         while (0 < (forward_heap1.Size() + reverse_heap1.Size()))
         {
+            super::PollDeadline(deadline, settled_nodes);
             if (0 < forward_heap1.Size())
             {
                 AlternativeRoutingStep<true>(forward_heap1,
@@ -174,6 +210,11 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         }
 
         osrm::sort_unique_resize(via_node_candidate_list);
+        // the shortest path is returned in any case, alternatives only while there is time left
+        if (is_over_budget())
+        {
+            via_node_candidate_list.clear();
+        }
 
         std::vector<NodeID> packed_forward_path;
         std::vector<NodeID> packed_reverse_path;
@@ -188,8 +229,8 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         nodes_in_path.insert(middle_node);
         nodes_in_path.insert(packed_reverse_path.begin(), packed_reverse_path.end());
 
-        std::unordered_map<NodeID, int> approximated_forward_sharing;
-        std::unordered_map<NodeID, int> approximated_reverse_sharing;
+        SharingStorage &approximated_forward_sharing = *(engine_working_data.forwardSharing);
+        SharingStorage &approximated_reverse_sharing = *(engine_working_data.backwardSharing);
 
         // sweep over search space, compute forward sharing for each current edge (u,v)
         for (const SearchSpaceEdge &current_edge : forward_search_space)
@@ -200,17 +241,14 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             if (nodes_in_path.find(v) != nodes_in_path.end())
             {
                 // current_edge is on shortest path => sharing(v):=queue.GetKey(v);
-                approximated_forward_sharing.emplace(v, forward_heap1.GetKey(v));
+                SetSharingOnce(approximated_forward_sharing, v, forward_heap1.GetKey(v));
             }
             else
             {
                 // current edge is not on shortest path. Check if we know a value for the other
                 // endpoint
-                const auto sharing_of_u_iterator = approximated_forward_sharing.find(u);
-                if (sharing_of_u_iterator != approximated_forward_sharing.end())
-                {
-                    approximated_forward_sharing.emplace(v, sharing_of_u_iterator->second);
-                }
+                SetSharingOnce(approximated_forward_sharing, v,
+                               GetSharing(approximated_forward_sharing, u));
             }
         }
 
@@ -222,17 +260,14 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             if (nodes_in_path.find(v) != nodes_in_path.end())
             {
                 // current_edge is on shortest path => sharing(u):=queue.GetKey(u);
-                approximated_reverse_sharing.emplace(v, reverse_heap1.GetKey(v));
+                SetSharingOnce(approximated_reverse_sharing, v, reverse_heap1.GetKey(v));
             }
             else
             {
                 // current edge is not on shortest path. Check if we know a value for the other
                 // endpoint
-                const auto sharing_of_u_iterator = approximated_reverse_sharing.find(u);
-                if (sharing_of_u_iterator != approximated_reverse_sharing.end())
-                {
-                    approximated_reverse_sharing.emplace(v, sharing_of_u_iterator->second);
-                }
+                SetSharingOnce(approximated_reverse_sharing, v,
+                               GetSharing(approximated_reverse_sharing, u));
             }
         }
 
@@ -246,12 +281,8 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         std::vector<NodeID> preselected_node_list;
         for (const NodeID node : via_node_candidate_list)
         {
-            const auto fwd_iterator = approximated_forward_sharing.find(node);
-            const int fwd_sharing =
-                (fwd_iterator != approximated_forward_sharing.end()) ? fwd_iterator->second : 0;
-            const auto rev_iterator = approximated_reverse_sharing.find(node);
-            const int rev_sharing =
-                (rev_iterator != approximated_reverse_sharing.end()) ? rev_iterator->second : 0;
+            const int fwd_sharing = GetSharingOrZero(approximated_forward_sharing, node);
+            const int rev_sharing = GetSharingOrZero(approximated_reverse_sharing, node);
 
             const int approximated_sharing = fwd_sharing + rev_sharing;
             const int approximated_length = forward_heap1.GetKey(node) + reverse_heap1.GetKey(node);
@@ -281,12 +312,17 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         // prioritizing via nodes for deep inspection
         for (const NodeID node : preselected_node_list)
         {
+            if (is_over_budget())
+            {
+                break;
+            }
             int length_of_via_path = 0, sharing_of_via_path = 0;
             ComputeLengthAndSharingOfViaPath(node,
                                              &length_of_via_path,
                                              &sharing_of_via_path,
                                              packed_shortest_path,
-                                             min_edge_offset);
+                                             min_edge_offset,
+                                             deadline);
             const int maximum_allowed_sharing =
                 static_cast<int>(upper_bound_to_shortest_path_distance * VIAPATH_GAMMA);
             if (sharing_of_via_path <= maximum_allowed_sharing &&
@@ -297,25 +333,52 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         }
         std::sort(ranked_candidates_list.begin(), ranked_candidates_list.end());
 
-        NodeID selected_via_node = SPECIAL_NODEID;
-        int length_of_via_path = INVALID_EDGE_WEIGHT;
-        NodeID s_v_middle = SPECIAL_NODEID, v_t_middle = SPECIAL_NODEID;
-        for (const RankedCandidateNode &candidate : ranked_candidates_list)
-        {
-            if (ViaNodeCandidatePassesTTest(forward_heap1,
-                                            reverse_heap1,
-                                            forward_heap2,
-                                            reverse_heap2,
-                                            candidate,
-                                            upper_bound_to_shortest_path_distance,
-                                            &length_of_via_path,
-                                            &s_v_middle,
-                                            &v_t_middle,
-                                            min_edge_offset))
+        // T-test the candidates in batches of the best ranked ones. Every test only reads the
+        // heaps of the first search, so the tests of a batch run in parallel, each on the
+        // thread-local heaps of the thread that runs it. The first admissible one is selected,
+        // just as if the candidates were tested one after another.
+        TTestResult selected_via_path;
+        for (std::size_t batch_begin = 0;
+             batch_begin < ranked_candidates_list.size() && !selected_via_path.passed &&
+                 !is_over_budget();
+             batch_begin += VIAPATH_T_TEST_BATCH_SIZE)
+        {
+            const std::size_t batch_end = std::min(batch_begin + VIAPATH_T_TEST_BATCH_SIZE,
+                                                   ranked_candidates_list.size());
+            std::vector<TTestResult> batch_results(batch_end - batch_begin);
+            const QueryHeap &existing_forward_heap = forward_heap1;
+            const QueryHeap &existing_reverse_heap = reverse_heap1;
+            ParallelQueryStatistics parallel_statistics;
+            tbb::parallel_for(
+                tbb::blocked_range<std::size_t>(batch_begin, batch_end, 1),
+                [&](const tbb::blocked_range<std::size_t> &range)
+                {
+                    const ParallelQueryStatistics::Task task(parallel_statistics);
+                    for (const auto index : osrm::irange(range.begin(), range.end()))
+                    {
+                        TTestResult &result = batch_results[index - batch_begin];
+                        result.passed =
+                            ViaNodeCandidatePassesTTest(existing_forward_heap,
+                                                        existing_reverse_heap,
+                                                        ranked_candidates_list[index],
+                                                        upper_bound_to_shortest_path_distance,
+                                                        &result.length_of_via_path,
+                                                        result.packed_via_path,
+                                                        min_edge_offset,
+                                                        deadline);
+                    }
+                });
+            parallel_statistics.Merge();
+
+            const auto first_admissible =
+                std::find_if(batch_results.begin(), batch_results.end(),
+                             [](const TTestResult &result)
+                             {
+                                 return result.passed;
+                             });
+            if (batch_results.end() != first_admissible)
             {
-                // select first admissable
-                selected_via_node = candidate.node;
-                break;
+                selected_via_path = std::move(*first_admissible);
             }
         }
 
@@ -339,17 +402,9 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             raw_route_data.shortest_path_length = upper_bound_to_shortest_path_distance;
         }
 
-        if (SPECIAL_NODEID != selected_via_node)
+        if (selected_via_path.passed)
         {
-            std::vector<NodeID> packed_alternate_path;
-            // retrieve alternate path
-            RetrievePackedAlternatePath(forward_heap1,
-                                        reverse_heap1,
-                                        forward_heap2,
-                                        reverse_heap2,
-                                        s_v_middle,
-                                        v_t_middle,
-                                        packed_alternate_path);
+            const std::vector<NodeID> &packed_alternate_path = selected_via_path.packed_via_path;
 
             raw_route_data.alt_source_traversed_in_reverse.push_back((
                 packed_alternate_path.front() != phantom_node_pair.source_phantom.forward_node_id));
@@ -360,7 +415,7 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
             super::UnpackPath(
                 packed_alternate_path, phantom_node_pair, raw_route_data.unpacked_alternative);
 
-            raw_route_data.alternative_path_length = length_of_via_path;
+            raw_route_data.alternative_path_length = selected_via_path.length_of_via_path;
         }
         else
         {
@@ -369,25 +424,24 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
     }
 
   private:
-    // unpack alternate <s,..,v,..,t> by exploring search spaces from v
-    inline void RetrievePackedAlternatePath(const QueryHeap &forward_heap1,
-                                            const QueryHeap &reverse_heap1,
-                                            const QueryHeap &forward_heap2,
-                                            const QueryHeap &reverse_heap2,
-                                            const NodeID s_v_middle,
-                                            const NodeID v_t_middle,
-                                            std::vector<NodeID> &packed_path) const
+    // keeps the first value a node gets, like emplace into a map did
+    static inline void SetSharingOnce(SharingStorage &sharing, const NodeID node, const int value)
     {
-        // fetch packed path [s,v)
-        std::vector<NodeID> packed_v_t_path;
-        super::RetrievePackedPathFromHeap(forward_heap1, reverse_heap2, s_v_middle, packed_path);
-        packed_path.pop_back(); // remove middle node. It's in both half-paths
+        if (UNKNOWN_SHARING != value && UNKNOWN_SHARING == GetSharing(sharing, node))
+        {
+            sharing[node] = value;
+        }
+    }
 
-        // fetch patched path [v,t]
-        super::RetrievePackedPathFromHeap(
-            forward_heap2, reverse_heap1, v_t_middle, packed_v_t_path);
+    static inline int GetSharing(const SharingStorage &sharing, const NodeID node)
+    {
+        return sharing[node];
+    }
 
-        packed_path.insert(packed_path.end(), packed_v_t_path.begin(), packed_v_t_path.end());
+    static inline int GetSharingOrZero(const SharingStorage &sharing, const NodeID node)
+    {
+        const int value = GetSharing(sharing, node);
+        return UNKNOWN_SHARING == value ? 0 : value;
     }
 
     // TODO: reorder parameters
@@ -398,7 +452,8 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
                                                  int *real_length_of_via_path,
                                                  int *sharing_of_via_path,
                                                  const std::vector<NodeID> &packed_shortest_path,
-                                                 const EdgeWeight min_edge_offset)
+                                                 const EdgeWeight min_edge_offset,
+                                                 const QueryDeadline &deadline)
     {
         engine_working_data.InitializeOrClearSecondThreadLocalStorage(
             super::facade->GetNumberOfNodes());
@@ -418,8 +473,10 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         int upper_bound_s_v_path_length = INVALID_EDGE_WEIGHT;
         new_reverse_heap.Insert(via_node, 0, via_node);
         // compute path <s,..,v> by reusing forward search from s
+        unsigned settled_nodes = 0;
         while (!new_reverse_heap.Empty())
         {
+            super::PollDeadline(deadline, settled_nodes);
             super::RoutingStep(new_reverse_heap,
                                existing_forward_heap,
                                &s_v_middle,
@@ -433,6 +490,7 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         new_forward_heap.Insert(via_node, 0, via_node);
         while (!new_forward_heap.Empty())
         {
+            super::PollDeadline(deadline, settled_nodes);
             super::RoutingStep(new_forward_heap,
                                existing_reverse_heap,
                                &v_t_middle,
@@ -606,8 +664,11 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
                                        std::vector<SearchSpaceEdge> &search_space,
                                        const EdgeWeight min_edge_offset) const
     {
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
         const NodeID node = forward_heap.DeleteMin();
         const int distance = forward_heap.GetKey(node);
+        ++statistics.settled_nodes;
+        ++statistics.heap_operations;
         // const NodeID parentnode = forward_heap.GetData(node).parent;
         // SimpleLogger().Write() << (is_forward_directed ? "[fwd] " : "[rev] ") << "settled edge ("
         // << parentnode << "," << node << "), dist: " << distance;
@@ -655,11 +716,13 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
 
                 BOOST_ASSERT(edge_weight > 0);
                 const int to_distance = distance + edge_weight;
+                ++statistics.relaxed_edges;
 
                 // New Node discovered -> Add to Heap + Node Info Storage
                 if (!forward_heap.WasInserted(to))
                 {
                     forward_heap.Insert(to, to_distance, node);
+                    ++statistics.heap_operations;
                 }
                 // Found a shorter Path -> Update distance
                 else if (to_distance < forward_heap.GetKey(to))
@@ -668,37 +731,42 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
                     forward_heap.GetData(to).parent = node;
                     // decreased distance
                     forward_heap.DecreaseKey(to, to_distance);
+                    ++statistics.heap_operations;
                 }
             }
         }
     }
 
-    // conduct T-Test
-    inline bool ViaNodeCandidatePassesTTest(QueryHeap &existing_forward_heap,
-                                            QueryHeap &existing_reverse_heap,
-                                            QueryHeap &new_forward_heap,
-                                            QueryHeap &new_reverse_heap,
+    // conduct T-Test, the packed via path <s,..,v,..,t> is returned if the candidate passes.
+    // Only reads the existing heaps and searches on the thread-local second and third heaps.
+    inline bool ViaNodeCandidatePassesTTest(const QueryHeap &existing_forward_heap,
+                                            const QueryHeap &existing_reverse_heap,
                                             const RankedCandidateNode &candidate,
                                             const int length_of_shortest_path,
                                             int *length_of_via_path,
-                                            NodeID *s_v_middle,
-                                            NodeID *v_t_middle,
-                                            const EdgeWeight min_edge_offset) const
+                                            std::vector<NodeID> &packed_via_path,
+                                            const EdgeWeight min_edge_offset,
+                                            const QueryDeadline &deadline) const
     {
-        new_forward_heap.Clear();
-        new_reverse_heap.Clear();
+        engine_working_data.InitializeOrClearSecondThreadLocalStorage(
+            super::facade->GetNumberOfNodes());
+        QueryHeap &new_forward_heap = *engine_working_data.forwardHeap2;
+        QueryHeap &new_reverse_heap = *engine_working_data.backwardHeap2;
+
         std::vector<NodeID> packed_s_v_path;
         std::vector<NodeID> packed_v_t_path;
 
-        *s_v_middle = SPECIAL_NODEID;
+        NodeID s_v_middle = SPECIAL_NODEID;
         int upper_bound_s_v_path_length = INVALID_EDGE_WEIGHT;
         // compute path <s,..,v> by reusing forward search from s
         new_reverse_heap.Insert(candidate.node, 0, candidate.node);
+        unsigned settled_nodes = 0;
         while (new_reverse_heap.Size() > 0)
         {
+            super::PollDeadline(deadline, settled_nodes);
             super::RoutingStep(new_reverse_heap,
                                existing_forward_heap,
-                               s_v_middle,
+                               &s_v_middle,
                                &upper_bound_s_v_path_length,
                                min_edge_offset,
                                false);
@@ -710,14 +778,15 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         }
 
         // compute path <v,..,t> by reusing backward search from t
-        *v_t_middle = SPECIAL_NODEID;
+        NodeID v_t_middle = SPECIAL_NODEID;
         int upper_bound_of_v_t_path_length = INVALID_EDGE_WEIGHT;
         new_forward_heap.Insert(candidate.node, 0, candidate.node);
         while (new_forward_heap.Size() > 0)
         {
+            super::PollDeadline(deadline, settled_nodes);
             super::RoutingStep(new_forward_heap,
                                existing_reverse_heap,
-                               v_t_middle,
+                               &v_t_middle,
                                &upper_bound_of_v_t_path_length,
                                min_edge_offset,
                                true);
@@ -732,12 +801,12 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
 
         // retrieve packed paths
         super::RetrievePackedPathFromHeap(
-            existing_forward_heap, new_reverse_heap, *s_v_middle, packed_s_v_path);
+            existing_forward_heap, new_reverse_heap, s_v_middle, packed_s_v_path);
 
         super::RetrievePackedPathFromHeap(
-            new_forward_heap, existing_reverse_heap, *v_t_middle, packed_v_t_path);
+            new_forward_heap, existing_reverse_heap, v_t_middle, packed_v_t_path);
 
-        NodeID s_P = *s_v_middle, t_P = *v_t_middle;
+        NodeID s_P = s_v_middle, t_P = v_t_middle;
         if (SPECIAL_NODEID == s_P)
         {
             return false;
@@ -886,6 +955,7 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
         // exploration from s and t until deletemin/(1+epsilon) > _lengt_oO_sShortest_path
         while ((forward_heap3.Size() + reverse_heap3.Size()) > 0)
         {
+            super::PollDeadline(deadline, settled_nodes);
             if (!forward_heap3.Empty())
             {
                 super::RoutingStep(
@@ -897,7 +967,16 @@ template <class DataFacadeT> class AlternativeRouting final : private BasicRouti
                     reverse_heap3, forward_heap3, &middle, &upper_bound, min_edge_offset, false);
             }
         }
-        return (upper_bound <= t_test_path_length);
+        if (upper_bound > t_test_path_length)
+        {
+            return false;
+        }
+
+        // <s,..,v> and <v,..,t> both contain v
+        packed_via_path = std::move(packed_s_v_path);
+        packed_via_path.pop_back();
+        packed_via_path.insert(packed_via_path.end(), packed_v_t_path.begin(), packed_v_t_path.end());
+        return true;
     }
 };
 
@@ -29,14 +29,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MANY_TO_MANY_ROUTING_HPP
 
 #include "routing_base.hpp"
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/search_engine_data.hpp"
 #include "../typedefs.h"
+#include "../Util/iterator_range.hpp"
 
 #include <boost/assert.hpp>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 template <class DataFacadeT> class ManyToManyRouting final : public BasicRoutingInterface<DataFacadeT>
@@ -47,165 +54,292 @@ template <class DataFacadeT> class ManyToManyRouting final : public BasicRouting
 
     struct NodeBucket
     {
+        NodeID middle_node;
         unsigned target_id; // essentially a row in the distance matrix
         EdgeWeight distance;
-        NodeBucket(const unsigned target_id, const EdgeWeight distance)
-            : target_id(target_id), distance(distance)
+        NodeBucket(const NodeID middle_node, const unsigned target_id, const EdgeWeight distance)
+            : middle_node(middle_node), target_id(target_id), distance(distance)
+        {
+        }
+
+        bool operator<(const NodeBucket &other) const { return middle_node < other.middle_node; }
+
+        // needed for std::equal_range on a node id
+        friend bool operator<(const NodeBucket &bucket, const NodeID node)
+        {
+            return bucket.middle_node < node;
+        }
+        friend bool operator<(const NodeID node, const NodeBucket &bucket)
         {
+            return node < bucket.middle_node;
         }
     };
-    using SearchSpaceWithBuckets = std::unordered_map<NodeID, std::vector<NodeBucket>>;
+    // filled by the backward searches and then sorted by node, so that each forward search
+    // finds all buckets of a settled node in one contiguous range.
+    using SearchSpaceWithBuckets = std::vector<NodeBucket>;
 
   public:
-    ManyToManyRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
-        : super(facade), engine_working_data(engine_working_data)
+    ManyToManyRouting(DataFacadeT *facade,
+                      SearchEngineData &engine_working_data,
+                      ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), engine_working_data(engine_working_data)
     {
     }
 
     ~ManyToManyRouting() {}
 
-    std::shared_ptr<std::vector<EdgeWeight>> operator()(const PhantomNodeArray &phantom_nodes_array)
-        const
+    // Computes the full |sources| x |targets| table in row-major order.
+    std::shared_ptr<std::vector<EdgeWeight>>
+    operator()(const PhantomNodeArray &phantom_sources_array,
+               const PhantomNodeArray &phantom_targets_array,
+               const QueryDeadline &deadline = QueryDeadline()) const
     {
-        const auto number_of_locations = phantom_nodes_array.size();
+        const std::size_t number_of_sources = phantom_sources_array.size();
+        const std::size_t number_of_targets = phantom_targets_array.size();
         std::shared_ptr<std::vector<EdgeWeight>> result_table =
-            std::make_shared<std::vector<EdgeWeight>>(number_of_locations * number_of_locations,
-                                                      std::numeric_limits<EdgeWeight>::max());
+            std::make_shared<std::vector<EdgeWeight>>();
+        result_table->reserve(number_of_sources * number_of_targets);
 
-        engine_working_data.InitializeOrClearFirstThreadLocalStorage(
-            super::facade->GetNumberOfNodes());
+        (*this)(phantom_sources_array,
+                phantom_targets_array,
+                std::max<std::size_t>(1, number_of_sources),
+                [&result_table](const std::size_t, const std::vector<EdgeWeight> &tile)
+                {
+                    result_table->insert(result_table->end(), tile.begin(), tile.end());
+                },
+                deadline);
+        return result_table;
+    }
 
-        QueryHeap &query_heap = *(engine_working_data.forwardHeap);
+    // Computes the table in tiles of at most rows_per_tile source rows, so that memory stays
+    // bounded for large tables. The callback is called once per tile, in order, with the index
+    // of the first row and the row-major tile. The tile buffer is reused for the next tile.
+    template <class TileCallback>
+    void operator()(const PhantomNodeArray &phantom_sources_array,
+                    const PhantomNodeArray &phantom_targets_array,
+                    const std::size_t rows_per_tile,
+                    TileCallback &&tile_callback,
+                    const QueryDeadline &deadline = QueryDeadline()) const
+    {
+        BOOST_ASSERT(rows_per_tile > 0);
+        const std::size_t number_of_sources = phantom_sources_array.size();
+        const std::size_t number_of_targets = phantom_targets_array.size();
 
         SearchSpaceWithBuckets search_space_with_buckets;
+        FillBuckets(phantom_targets_array, search_space_with_buckets, deadline);
 
-        unsigned target_id = 0;
-        for (const std::vector<PhantomNode> &phantom_node_vector : phantom_nodes_array)
+        std::vector<EdgeWeight> tile;
+        for (std::size_t first_row = 0; first_row < number_of_sources; first_row += rows_per_tile)
         {
-            query_heap.Clear();
-            // insert target(s) at distance 0
+            const std::size_t last_row = std::min(first_row + rows_per_tile, number_of_sources);
+            tile.assign((last_row - first_row) * number_of_targets,
+                        std::numeric_limits<EdgeWeight>::max());
+            ComputeRows(phantom_sources_array,
+                        first_row,
+                        last_row,
+                        number_of_targets,
+                        search_space_with_buckets,
+                        tile,
+                        deadline);
+            tile_callback(first_row, tile);
+        }
+    }
 
-            for (const PhantomNode &phantom_node : phantom_node_vector)
+    // Runs the backward searches from all targets and stores their search spaces in buckets
+    // that are sorted by node.
+    void FillBuckets(const PhantomNodeArray &phantom_targets_array,
+                     SearchSpaceWithBuckets &search_space_with_buckets,
+                     const QueryDeadline &deadline) const
+    {
+        // every single search is expensive enough to be scheduled on its own
+        constexpr unsigned BackwardGrainSize = 1;
+
+        // Each search runs on the thread local heap of the thread that executes it and every
+        // thread collects the buckets of its backward searches separately.
+        tbb::enumerable_thread_specific<SearchSpaceWithBuckets> thread_local_buckets;
+
+        ParallelQueryStatistics parallel_statistics;
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(
+                0, static_cast<unsigned>(phantom_targets_array.size()), BackwardGrainSize),
+            [this, &phantom_targets_array, &thread_local_buckets, &deadline, &parallel_statistics](
+                const tbb::blocked_range<unsigned> &range)
             {
-                if (SPECIAL_NODEID != phantom_node.forward_node_id)
-                {
-                    query_heap.Insert(phantom_node.forward_node_id,
-                                      phantom_node.GetForwardWeightPlusOffset(),
-                                      phantom_node.forward_node_id);
-                }
-                if (SPECIAL_NODEID != phantom_node.reverse_node_id)
+                const ParallelQueryStatistics::Task task(parallel_statistics);
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                QueryHeap &query_heap = *(engine_working_data.forwardHeap);
+                SearchSpaceWithBuckets &local_buckets = thread_local_buckets.local();
+
+                for (unsigned target_id = range.begin(); target_id != range.end(); ++target_id)
                 {
-                    query_heap.Insert(phantom_node.reverse_node_id,
-                                      phantom_node.GetReverseWeightPlusOffset(),
-                                      phantom_node.reverse_node_id);
+                    query_heap.Clear();
+                    // insert target(s) at distance 0
+                    for (const PhantomNode &phantom_node : phantom_targets_array[target_id])
+                    {
+                        if (SPECIAL_NODEID != phantom_node.forward_node_id)
+                        {
+                            query_heap.Insert(phantom_node.forward_node_id,
+                                              phantom_node.GetForwardWeightPlusOffset(),
+                                              phantom_node.forward_node_id);
+                        }
+                        if (SPECIAL_NODEID != phantom_node.reverse_node_id)
+                        {
+                            query_heap.Insert(phantom_node.reverse_node_id,
+                                              phantom_node.GetReverseWeightPlusOffset(),
+                                              phantom_node.reverse_node_id);
+                        }
+                    }
+
+                    // explore search space
+                    unsigned settled_nodes = 0;
+                    while (!query_heap.Empty())
+                    {
+                        super::PollDeadline(deadline, settled_nodes);
+                        BackwardRoutingStep(target_id, query_heap, local_buckets);
+                    }
                 }
-            }
+            });
+        parallel_statistics.Merge();
 
-            // explore search space
-            while (!query_heap.Empty())
-            {
-                BackwardRoutingStep(target_id, query_heap, search_space_with_buckets);
-            }
-            ++target_id;
+        // merge the bucket lists of all threads
+        std::size_t number_of_buckets = 0;
+        for (const SearchSpaceWithBuckets &buckets : thread_local_buckets)
+        {
+            number_of_buckets += buckets.size();
         }
-
-        // for each source do forward search
-        unsigned source_id = 0;
-        for (const std::vector<PhantomNode> &phantom_node_vector : phantom_nodes_array)
+        search_space_with_buckets.clear();
+        search_space_with_buckets.reserve(number_of_buckets);
+        for (const SearchSpaceWithBuckets &buckets : thread_local_buckets)
         {
-            query_heap.Clear();
-            for (const PhantomNode &phantom_node : phantom_node_vector)
-            {
-                // insert sources at distance 0
-                if (SPECIAL_NODEID != phantom_node.forward_node_id)
-                {
-                    query_heap.Insert(phantom_node.forward_node_id,
-                                      -phantom_node.GetForwardWeightPlusOffset(),
-                                      phantom_node.forward_node_id);
-                }
-                if (SPECIAL_NODEID != phantom_node.reverse_node_id)
-                {
-                    query_heap.Insert(phantom_node.reverse_node_id,
-                                      -phantom_node.GetReverseWeightPlusOffset(),
-                                      phantom_node.reverse_node_id);
-                }
-            }
+            search_space_with_buckets.insert(
+                search_space_with_buckets.end(), buckets.begin(), buckets.end());
+        }
+        thread_local_buckets.clear();
+        tbb::parallel_sort(search_space_with_buckets.begin(), search_space_with_buckets.end());
+    }
 
-            // explore search space
-            while (!query_heap.Empty())
+    // Runs the forward searches of the sources [first_row, last_row) against the buckets.
+    // Each of them writes only its own row of the row-major table.
+    void ComputeRows(const PhantomNodeArray &phantom_sources_array,
+                     const std::size_t first_row,
+                     const std::size_t last_row,
+                     const std::size_t number_of_targets,
+                     const SearchSpaceWithBuckets &search_space_with_buckets,
+                     std::vector<EdgeWeight> &table,
+                     const QueryDeadline &deadline) const
+    {
+        BOOST_ASSERT(table.size() == (last_row - first_row) * number_of_targets);
+        constexpr std::size_t ForwardGrainSize = 1;
+
+        ParallelQueryStatistics parallel_statistics;
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(first_row, last_row, ForwardGrainSize),
+            [this, &phantom_sources_array, &search_space_with_buckets, &table, &deadline,
+             &parallel_statistics, first_row, number_of_targets](
+                const tbb::blocked_range<std::size_t> &range)
             {
-                ForwardRoutingStep(source_id,
-                                   number_of_locations,
-                                   query_heap,
-                                   search_space_with_buckets,
-                                   result_table);
-            }
+                const ParallelQueryStatistics::Task task(parallel_statistics);
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                QueryHeap &query_heap = *(engine_working_data.forwardHeap);
 
-            ++source_id;
-        }
-        BOOST_ASSERT(source_id == target_id);
-        return result_table;
+                for (std::size_t source_id = range.begin(); source_id != range.end(); ++source_id)
+                {
+                    query_heap.Clear();
+                    for (const PhantomNode &phantom_node : phantom_sources_array[source_id])
+                    {
+                        // insert sources at distance 0
+                        if (SPECIAL_NODEID != phantom_node.forward_node_id)
+                        {
+                            query_heap.Insert(phantom_node.forward_node_id,
+                                              -phantom_node.GetForwardWeightPlusOffset(),
+                                              phantom_node.forward_node_id);
+                        }
+                        if (SPECIAL_NODEID != phantom_node.reverse_node_id)
+                        {
+                            query_heap.Insert(phantom_node.reverse_node_id,
+                                              -phantom_node.GetReverseWeightPlusOffset(),
+                                              phantom_node.reverse_node_id);
+                        }
+                    }
+
+                    // explore search space
+                    const std::size_t row_offset = (source_id - first_row) * number_of_targets;
+                    unsigned settled_nodes = 0;
+                    while (!query_heap.Empty())
+                    {
+                        super::PollDeadline(deadline, settled_nodes);
+                        ForwardRoutingStep(row_offset, query_heap, search_space_with_buckets, table);
+                    }
+                }
+            });
+        parallel_statistics.Merge();
     }
 
-    void ForwardRoutingStep(const unsigned source_id,
-                            const unsigned number_of_locations,
+    void ForwardRoutingStep(const std::size_t row_offset,
                             QueryHeap &query_heap,
                             const SearchSpaceWithBuckets &search_space_with_buckets,
-                            std::shared_ptr<std::vector<EdgeWeight>> result_table) const
+                            std::vector<EdgeWeight> &result_table) const
     {
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
         const NodeID node = query_heap.DeleteMin();
         const int source_distance = query_heap.GetKey(node);
-
-        // check if each encountered node has an entry
-        const auto bucket_iterator = search_space_with_buckets.find(node);
-        // iterate bucket if there exists one
-        if (bucket_iterator != search_space_with_buckets.end())
+        ++statistics.settled_nodes;
+        ++statistics.heap_operations;
+
+        // iterate the buckets of the encountered node, if there are any
+        const auto bucket_range = std::equal_range(
+            search_space_with_buckets.begin(), search_space_with_buckets.end(), node);
+        for (const NodeBucket &current_bucket :
+             osrm::util::range(bucket_range.first, bucket_range.second))
         {
-            const std::vector<NodeBucket> &bucket_list = bucket_iterator->second;
-            for (const NodeBucket &current_bucket : bucket_list)
+            // get target id from bucket entry
+            const unsigned target_id = current_bucket.target_id;
+            const int target_distance = current_bucket.distance;
+            const EdgeWeight current_distance = result_table[row_offset + target_id];
+            // check if new distance is better
+            const EdgeWeight new_distance = source_distance + target_distance;
+            if (new_distance >= 0 && new_distance < current_distance)
             {
-                // get target id from bucket entry
-                const unsigned target_id = current_bucket.target_id;
-                const int target_distance = current_bucket.distance;
-                const EdgeWeight current_distance =
-                    (*result_table)[source_id * number_of_locations + target_id];
-                // check if new distance is better
-                const EdgeWeight new_distance = source_distance + target_distance;
-                if (new_distance >= 0 && new_distance < current_distance)
-                {
-                    (*result_table)[source_id * number_of_locations + target_id] =
-                        (source_distance + target_distance);
-                }
+                result_table[row_offset + target_id] = (source_distance + target_distance);
             }
         }
         if (StallAtNode<true>(node, source_distance, query_heap))
         {
+            ++statistics.stalled_nodes;
             return;
         }
-        RelaxOutgoingEdges<true>(node, source_distance, query_heap);
+        RelaxOutgoingEdges<true>(node, source_distance, query_heap, statistics);
     }
 
     void BackwardRoutingStep(const unsigned target_id,
                              QueryHeap &query_heap,
                              SearchSpaceWithBuckets &search_space_with_buckets) const
     {
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
         const NodeID node = query_heap.DeleteMin();
         const int target_distance = query_heap.GetKey(node);
+        ++statistics.settled_nodes;
+        ++statistics.heap_operations;
 
         // store settled nodes in search space bucket
-        search_space_with_buckets[node].emplace_back(target_id, target_distance);
+        search_space_with_buckets.emplace_back(node, target_id, target_distance);
 
         if (StallAtNode<false>(node, target_distance, query_heap))
         {
+            ++statistics.stalled_nodes;
             return;
         }
 
-        RelaxOutgoingEdges<false>(node, target_distance, query_heap);
+        RelaxOutgoingEdges<false>(node, target_distance, query_heap, statistics);
     }
 
     template <bool forward_direction>
-    inline void
-    RelaxOutgoingEdges(const NodeID node, const EdgeWeight distance, QueryHeap &query_heap) const
+    inline void RelaxOutgoingEdges(const NodeID node,
+                                   const EdgeWeight distance,
+                                   QueryHeap &query_heap,
+                                   QueryStatistics &statistics) const
     {
         for (auto edge : super::facade->GetAdjacentEdgeRange(node))
         {
@@ -218,11 +352,13 @@ template <class DataFacadeT> class ManyToManyRouting final : public BasicRouting
 
                 BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
                 const int to_distance = distance + edge_weight;
+                ++statistics.relaxed_edges;
 
                 // New Node discovered -> Add to Heap + Node Info Storage
                 if (!query_heap.WasInserted(to))
                 {
                     query_heap.Insert(to, to_distance, node);
+                    ++statistics.heap_operations;
                 }
                 // Found a shorter Path -> Update distance
                 else if (to_distance < query_heap.GetKey(to))
@@ -230,6 +366,7 @@ template <class DataFacadeT> class ManyToManyRouting final : public BasicRouting
                     // new parent
                     query_heap.GetData(to).parent = node;
                     query_heap.DecreaseKey(to, to_distance);
+                    ++statistics.heap_operations;
                 }
             }
         }
@@ -0,0 +1,445 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MANY_TO_MANY_SWEEP_ROUTING_HPP
+#define MANY_TO_MANY_SWEEP_ROUTING_HPP
+
+#include "routing_base.hpp"
+#include "../data_structures/query_statistics.hpp"
+#include "../data_structures/search_engine_data.hpp"
+#include "../Util/integer_range.hpp"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Distance tables with restricted sweeps (RPHAST). The part of the search graph that reaches
+// the larger side of the table upwards is selected once. Then every search from the smaller
+// side is an upward search followed by a linear sweep over that restricted graph only.
+// BatchSize searches share one sweep, their distances of a node are stored next to each other
+// so that the inner loop over them can be vectorized.
+template <class DataFacadeT>
+class ManyToManySweepRouting final : public BasicRoutingInterface<DataFacadeT>
+{
+    using super = BasicRoutingInterface<DataFacadeT>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+    static constexpr unsigned BatchSize = 8;
+    // survives adding an edge weight without overflowing, everything above is unreachable
+    static constexpr EdgeWeight INVALID_SWEEP_WEIGHT = std::numeric_limits<EdgeWeight>::max() / 2;
+
+    struct RestrictedEdge
+    {
+        unsigned parent;
+        EdgeWeight weight;
+    };
+
+    // Nodes are numbered in sweep order, i.e. every node comes after all nodes it has an edge
+    // from. The edges of node i are [first_edge[i], first_edge[i+1]).
+    struct RestrictedGraph
+    {
+        std::unordered_map<NodeID, unsigned> local_ids;
+        std::vector<unsigned> first_edge;
+        std::vector<RestrictedEdge> edges;
+
+        unsigned GetNumberOfNodes() const { return static_cast<unsigned>(first_edge.size() - 1); }
+
+        unsigned GetLocalID(const NodeID node) const
+        {
+            const auto iter = local_ids.find(node);
+            return local_ids.end() == iter ? SPECIAL_NODEID : iter->second;
+        }
+    };
+
+  public:
+    ManyToManySweepRouting(DataFacadeT *facade,
+                           SearchEngineData &engine_working_data,
+                           ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~ManyToManySweepRouting() {}
+
+    // Computes the full |sources| x |targets| table in row-major order.
+    std::shared_ptr<std::vector<EdgeWeight>>
+    operator()(const PhantomNodeArray &phantom_sources_array,
+               const PhantomNodeArray &phantom_targets_array,
+               const QueryDeadline &deadline = QueryDeadline()) const
+    {
+        const std::size_t number_of_sources = phantom_sources_array.size();
+        const std::size_t number_of_targets = phantom_targets_array.size();
+        std::shared_ptr<std::vector<EdgeWeight>> result_table =
+            std::make_shared<std::vector<EdgeWeight>>();
+        result_table->reserve(number_of_sources * number_of_targets);
+
+        (*this)(phantom_sources_array,
+                phantom_targets_array,
+                std::max<std::size_t>(1, number_of_sources),
+                [&result_table](const std::size_t, const std::vector<EdgeWeight> &tile)
+                {
+                    result_table->insert(result_table->end(), tile.begin(), tile.end());
+                },
+                deadline);
+        return result_table;
+    }
+
+    // Same interface as ManyToManyRouting: the callback gets the index of the first row and
+    // the row-major tile of at most rows_per_tile rows.
+    template <class TileCallback>
+    void operator()(const PhantomNodeArray &phantom_sources_array,
+                    const PhantomNodeArray &phantom_targets_array,
+                    const std::size_t rows_per_tile,
+                    TileCallback &&tile_callback,
+                    const QueryDeadline &deadline = QueryDeadline()) const
+    {
+        BOOST_ASSERT(rows_per_tile > 0);
+        const std::size_t number_of_sources = phantom_sources_array.size();
+        const std::size_t number_of_targets = phantom_targets_array.size();
+
+        RestrictedGraph restricted_graph;
+        std::vector<EdgeWeight> tile;
+        if (number_of_sources <= number_of_targets)
+        {
+            // select the targets once, then sweep for batches of sources
+            SelectRestrictedGraph<true>(phantom_targets_array, 0, number_of_targets,
+                                        restricted_graph, deadline);
+            for (std::size_t first_row = 0; first_row < number_of_sources;
+                 first_row += rows_per_tile)
+            {
+                const std::size_t last_row =
+                    std::min(first_row + rows_per_tile, number_of_sources);
+                tile.resize((last_row - first_row) * number_of_targets);
+                SweepBatches<true>(restricted_graph, phantom_sources_array, first_row, last_row,
+                                   phantom_targets_array, 0, number_of_targets, deadline,
+                                   [&tile, first_row, number_of_targets](
+                                       const std::size_t row, const std::size_t column,
+                                       const EdgeWeight distance)
+                                   {
+                                       tile[(row - first_row) * number_of_targets + column] =
+                                           distance;
+                                   });
+                tile_callback(first_row, tile);
+            }
+        }
+        else
+        {
+            // select the sources of each tile, then sweep backwards for batches of targets
+            for (std::size_t first_row = 0; first_row < number_of_sources;
+                 first_row += rows_per_tile)
+            {
+                const std::size_t last_row =
+                    std::min(first_row + rows_per_tile, number_of_sources);
+                SelectRestrictedGraph<false>(phantom_sources_array, first_row, last_row,
+                                             restricted_graph, deadline);
+                tile.resize((last_row - first_row) * number_of_targets);
+                SweepBatches<false>(restricted_graph, phantom_targets_array, 0, number_of_targets,
+                                    phantom_sources_array, first_row, last_row, deadline,
+                                    [&tile, first_row, number_of_targets](
+                                        const std::size_t column, const std::size_t row,
+                                        const EdgeWeight distance)
+                                    {
+                                        tile[(row - first_row) * number_of_targets + column] =
+                                            distance;
+                                    });
+                tile_callback(first_row, tile);
+            }
+        }
+    }
+
+  private:
+    // Collects all nodes that the selected phantom nodes reach by upward searches in the
+    // opposite of forward_direction and numbers them in DFS post-order. A node is finished only
+    // after all nodes above it, which makes the post-order a valid sweep order.
+    template <bool forward_direction>
+    void SelectRestrictedGraph(const PhantomNodeArray &phantom_nodes_array,
+                               const std::size_t first,
+                               const std::size_t last,
+                               RestrictedGraph &restricted_graph,
+                               const QueryDeadline &deadline) const
+    {
+        restricted_graph.local_ids.clear();
+        restricted_graph.first_edge.assign(1, 0);
+        restricted_graph.edges.clear();
+
+        std::vector<std::pair<NodeID, EdgeID>> dfs_stack;
+        unsigned settled_nodes = 0;
+        const auto visit = [this, &restricted_graph, &dfs_stack](const NodeID node)
+        {
+            if (SPECIAL_NODEID == node || restricted_graph.local_ids.count(node) > 0)
+            {
+                return;
+            }
+            // inserted as unfinished
+            restricted_graph.local_ids.emplace(node, SPECIAL_NODEID);
+            dfs_stack.emplace_back(node, super::facade->BeginEdges(node));
+        };
+
+        for (const auto index : osrm::irange(first, last))
+        {
+            for (const PhantomNode &phantom_node : phantom_nodes_array[index])
+            {
+                visit(phantom_node.forward_node_id);
+                visit(phantom_node.reverse_node_id);
+
+                while (!dfs_stack.empty())
+                {
+                    const NodeID node = dfs_stack.back().first;
+                    const EdgeID edge = dfs_stack.back().second;
+                    if (edge != super::facade->EndEdges(node))
+                    {
+                        ++dfs_stack.back().second;
+                        const auto &data = super::facade->GetEdgeData(edge);
+                        if (forward_direction ? data.backward : data.forward)
+                        {
+                            visit(super::facade->GetTarget(edge));
+                        }
+                        continue;
+                    }
+
+                    // all nodes above are finished
+                    super::PollDeadline(deadline, settled_nodes);
+                    dfs_stack.pop_back();
+                    restricted_graph.local_ids[node] = restricted_graph.GetNumberOfNodes();
+                    for (const auto adjacent_edge : super::facade->GetAdjacentEdgeRange(node))
+                    {
+                        const auto &data = super::facade->GetEdgeData(adjacent_edge);
+                        if (forward_direction ? data.backward : data.forward)
+                        {
+                            const unsigned parent = restricted_graph.GetLocalID(
+                                super::facade->GetTarget(adjacent_edge));
+                            // the upward graph is acyclic, all parents are finished
+                            BOOST_ASSERT(SPECIAL_NODEID != parent);
+                            restricted_graph.edges.push_back({parent, data.distance});
+                        }
+                    }
+                    restricted_graph.first_edge.push_back(
+                        static_cast<unsigned>(restricted_graph.edges.size()));
+                }
+            }
+        }
+    }
+
+    // Runs the searches from phantom_nodes_array[first, last) in batches over the restricted
+    // graph of the selected phantom nodes and reports (search, selected, distance) triples.
+    template <bool forward_direction, class ResultCallback>
+    void SweepBatches(const RestrictedGraph &restricted_graph,
+                      const PhantomNodeArray &phantom_nodes_array,
+                      const std::size_t first,
+                      const std::size_t last,
+                      const PhantomNodeArray &selected_phantom_nodes_array,
+                      const std::size_t first_selected,
+                      const std::size_t last_selected,
+                      const QueryDeadline &deadline,
+                      ResultCallback &&result_callback) const
+    {
+        constexpr std::size_t BatchGrainSize = 1;
+        const std::size_t number_of_batches = (last - first + BatchSize - 1) / BatchSize;
+
+        tbb::enumerable_thread_specific<std::vector<EdgeWeight>> thread_local_distances;
+        ParallelQueryStatistics parallel_statistics;
+        tbb::parallel_for(
+            tbb::blocked_range<std::size_t>(0, number_of_batches, BatchGrainSize),
+            [&](const tbb::blocked_range<std::size_t> &range)
+            {
+                const ParallelQueryStatistics::Task task(parallel_statistics);
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                QueryHeap &query_heap = *(engine_working_data.forwardHeap);
+                std::vector<EdgeWeight> &distances = thread_local_distances.local();
+
+                for (const auto batch : osrm::irange(range.begin(), range.end()))
+                {
+                    // a batch is short enough to poll the deadline only once per batch
+                    if (deadline.IsExpired())
+                    {
+                        throw osrm::query_timeout();
+                    }
+                    const std::size_t batch_begin = first + batch * BatchSize;
+                    const std::size_t batch_end = std::min(batch_begin + BatchSize, last);
+
+                    distances.assign(restricted_graph.GetNumberOfNodes() * BatchSize,
+                                     static_cast<EdgeWeight>(INVALID_SWEEP_WEIGHT));
+                    for (const auto index : osrm::irange(batch_begin, batch_end))
+                    {
+                        UpwardSearch<forward_direction>(restricted_graph,
+                                                        phantom_nodes_array[index],
+                                                        static_cast<unsigned>(index - batch_begin),
+                                                        query_heap,
+                                                        distances);
+                    }
+                    Sweep(restricted_graph, distances);
+
+                    for (const auto selected : osrm::irange(first_selected, last_selected))
+                    {
+                        for (const auto index : osrm::irange(batch_begin, batch_end))
+                        {
+                            result_callback(index, selected,
+                                            GetDistance<forward_direction>(
+                                                restricted_graph,
+                                                distances,
+                                                static_cast<unsigned>(index - batch_begin),
+                                                selected_phantom_nodes_array[selected]));
+                        }
+                    }
+                }
+            });
+        parallel_statistics.Merge();
+    }
+
+    template <bool forward_direction>
+    void UpwardSearch(const RestrictedGraph &restricted_graph,
+                      const std::vector<PhantomNode> &phantom_nodes,
+                      const unsigned lane,
+                      QueryHeap &query_heap,
+                      std::vector<EdgeWeight> &distances) const
+    {
+        query_heap.Clear();
+        // sources start at minus their offset, targets at plus their offset
+        for (const PhantomNode &phantom_node : phantom_nodes)
+        {
+            if (SPECIAL_NODEID != phantom_node.forward_node_id)
+            {
+                const EdgeWeight weight = phantom_node.GetForwardWeightPlusOffset();
+                query_heap.Insert(phantom_node.forward_node_id,
+                                  forward_direction ? -weight : weight,
+                                  phantom_node.forward_node_id);
+            }
+            if (SPECIAL_NODEID != phantom_node.reverse_node_id)
+            {
+                const EdgeWeight weight = phantom_node.GetReverseWeightPlusOffset();
+                query_heap.Insert(phantom_node.reverse_node_id,
+                                  forward_direction ? -weight : weight,
+                                  phantom_node.reverse_node_id);
+            }
+        }
+
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
+        while (!query_heap.Empty())
+        {
+            const NodeID node = query_heap.DeleteMin();
+            const EdgeWeight distance = query_heap.GetKey(node);
+            ++statistics.settled_nodes;
+            ++statistics.heap_operations;
+
+            const unsigned local_id = restricted_graph.GetLocalID(node);
+            if (SPECIAL_NODEID != local_id)
+            {
+                distances[local_id * BatchSize + lane] = distance;
+            }
+
+            for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = super::facade->GetEdgeData(edge);
+                if (!(forward_direction ? data.forward : data.backward))
+                {
+                    continue;
+                }
+                const NodeID to = super::facade->GetTarget(edge);
+                const EdgeWeight to_distance = distance + data.distance;
+                ++statistics.relaxed_edges;
+                if (!query_heap.WasInserted(to))
+                {
+                    query_heap.Insert(to, to_distance, node);
+                    ++statistics.heap_operations;
+                }
+                else if (to_distance < query_heap.GetKey(to))
+                {
+                    query_heap.GetData(to).parent = node;
+                    query_heap.DecreaseKey(to, to_distance);
+                    ++statistics.heap_operations;
+                }
+            }
+        }
+    }
+
+    static void Sweep(const RestrictedGraph &restricted_graph, std::vector<EdgeWeight> &distances)
+    {
+        for (const auto node : osrm::irange(0u, restricted_graph.GetNumberOfNodes()))
+        {
+            EdgeWeight *node_distances = &distances[node * BatchSize];
+            for (const auto edge : osrm::irange(restricted_graph.first_edge[node],
+                                                restricted_graph.first_edge[node + 1]))
+            {
+                const RestrictedEdge &restricted_edge = restricted_graph.edges[edge];
+                const EdgeWeight *parent_distances = &distances[restricted_edge.parent * BatchSize];
+                for (unsigned lane = 0; lane < BatchSize; ++lane)
+                {
+                    node_distances[lane] = std::min(node_distances[lane],
+                                                    parent_distances[lane] + restricted_edge.weight);
+                }
+            }
+        }
+    }
+
+    template <bool forward_direction>
+    EdgeWeight GetDistance(const RestrictedGraph &restricted_graph,
+                           const std::vector<EdgeWeight> &distances,
+                           const unsigned lane,
+                           const std::vector<PhantomNode> &phantom_nodes) const
+    {
+        EdgeWeight result = INVALID_EDGE_WEIGHT;
+        const auto relax = [&](const NodeID node, const EdgeWeight weight)
+        {
+            if (SPECIAL_NODEID == node)
+            {
+                return;
+            }
+            const unsigned local_id = restricted_graph.GetLocalID(node);
+            BOOST_ASSERT(SPECIAL_NODEID != local_id);
+            const EdgeWeight distance = distances[local_id * BatchSize + lane];
+            if (distance >= INVALID_SWEEP_WEIGHT)
+            {
+                return;
+            }
+            const EdgeWeight new_distance = forward_direction ? distance + weight : distance - weight;
+            if (new_distance >= 0 && new_distance < result)
+            {
+                result = new_distance;
+            }
+        };
+        for (const PhantomNode &phantom_node : phantom_nodes)
+        {
+            relax(phantom_node.forward_node_id, phantom_node.GetForwardWeightPlusOffset());
+            relax(phantom_node.reverse_node_id, phantom_node.GetReverseWeightPlusOffset());
+        }
+        return result;
+    }
+};
+
+#endif // MANY_TO_MANY_SWEEP_ROUTING_HPP
@@ -0,0 +1,190 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ONE_TO_ALL_ROUTING_HPP
+#define ONE_TO_ALL_ROUTING_HPP
+
+#include "routing_base.hpp"
+#include "../data_structures/query_statistics.hpp"
+#include "../data_structures/search_engine_data.hpp"
+#include "../Util/integer_range.hpp"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+
+#include <vector>
+
+// One-to-all travel times on the contracted graph (PHAST). An upward search from the source is
+// followed by one linear sweep over all nodes by descending contraction level that relaxes the
+// downward edges of each node. Needs the level order written by osrm-prepare.
+template <class DataFacadeT> class OneToAllRouting final : public BasicRoutingInterface<DataFacadeT>
+{
+    using super = BasicRoutingInterface<DataFacadeT>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+  public:
+    OneToAllRouting(DataFacadeT *facade,
+                    SearchEngineData &engine_working_data,
+                    ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~OneToAllRouting() {}
+
+    // Returns false if no level order is loaded. Otherwise distances holds the travel time from
+    // the source to every node of the search graph, or INVALID_EDGE_WEIGHT if it is unreachable.
+    bool operator()(const PhantomNode &phantom_source,
+                    std::vector<EdgeWeight> &distances,
+                    const QueryDeadline &deadline = QueryDeadline()) const
+    {
+        const unsigned number_of_nodes = super::facade->GetNumberOfNodes();
+        if (super::facade->GetNumberOfLevelOrderedNodes() != number_of_nodes)
+        {
+            return false;
+        }
+        distances.assign(number_of_nodes, INVALID_EDGE_WEIGHT);
+
+        engine_working_data.InitializeOrClearFirstThreadLocalStorage(number_of_nodes);
+        QueryHeap &query_heap = *(engine_working_data.forwardHeap);
+
+        // insert source at distance 0
+        if (SPECIAL_NODEID != phantom_source.forward_node_id)
+        {
+            query_heap.Insert(phantom_source.forward_node_id,
+                              -phantom_source.GetForwardWeightPlusOffset(),
+                              phantom_source.forward_node_id);
+        }
+        if (SPECIAL_NODEID != phantom_source.reverse_node_id)
+        {
+            query_heap.Insert(phantom_source.reverse_node_id,
+                              -phantom_source.GetReverseWeightPlusOffset(),
+                              phantom_source.reverse_node_id);
+        }
+
+        // upward search, without stalling so that all settled distances are exact upper bounds
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
+        unsigned settled_nodes = 0;
+        while (!query_heap.Empty())
+        {
+            super::PollDeadline(deadline, settled_nodes);
+            const NodeID node = query_heap.DeleteMin();
+            const EdgeWeight distance = query_heap.GetKey(node);
+            ++statistics.settled_nodes;
+            ++statistics.heap_operations;
+            distances[node] = distance;
+            RelaxUpwardEdges(node, distance, query_heap, statistics);
+        }
+
+        // downward sweep, every node is visited after all nodes it has a downward edge from
+        for (const auto position : osrm::irange(0u, number_of_nodes))
+        {
+            super::PollDeadline(deadline, settled_nodes);
+            const NodeID node = super::facade->GetLevelOrderedNode(position);
+            EdgeWeight distance = distances[node];
+            for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+            {
+                const auto &data = super::facade->GetEdgeData(edge);
+                if (!data.backward)
+                {
+                    continue;
+                }
+                const EdgeWeight upper_distance = distances[super::facade->GetTarget(edge)];
+                if (INVALID_EDGE_WEIGHT != upper_distance &&
+                    upper_distance + data.distance < distance)
+                {
+                    distance = upper_distance + data.distance;
+                }
+            }
+            distances[node] = distance;
+        }
+        return true;
+    }
+
+    // Travel time to a phantom node taken from the result of a sweep.
+    EdgeWeight GetDistanceToTarget(const std::vector<EdgeWeight> &distances,
+                                   const PhantomNode &phantom_target) const
+    {
+        EdgeWeight result = INVALID_EDGE_WEIGHT;
+        if (SPECIAL_NODEID != phantom_target.forward_node_id &&
+            INVALID_EDGE_WEIGHT != distances[phantom_target.forward_node_id])
+        {
+            const EdgeWeight new_distance = distances[phantom_target.forward_node_id] +
+                                            phantom_target.GetForwardWeightPlusOffset();
+            if (new_distance >= 0 && new_distance < result)
+            {
+                result = new_distance;
+            }
+        }
+        if (SPECIAL_NODEID != phantom_target.reverse_node_id &&
+            INVALID_EDGE_WEIGHT != distances[phantom_target.reverse_node_id])
+        {
+            const EdgeWeight new_distance = distances[phantom_target.reverse_node_id] +
+                                            phantom_target.GetReverseWeightPlusOffset();
+            if (new_distance >= 0 && new_distance < result)
+            {
+                result = new_distance;
+            }
+        }
+        return result;
+    }
+
+  private:
+    inline void RelaxUpwardEdges(const NodeID node,
+                                 const EdgeWeight distance,
+                                 QueryHeap &query_heap,
+                                 QueryStatistics &statistics) const
+    {
+        for (const auto edge : super::facade->GetAdjacentEdgeRange(node))
+        {
+            const auto &data = super::facade->GetEdgeData(edge);
+            if (!data.forward)
+            {
+                continue;
+            }
+            const NodeID to = super::facade->GetTarget(edge);
+            BOOST_ASSERT_MSG(data.distance > 0, "edge_weight invalid");
+            const EdgeWeight to_distance = distance + data.distance;
+            ++statistics.relaxed_edges;
+
+            if (!query_heap.WasInserted(to))
+            {
+                query_heap.Insert(to, to_distance, node);
+                ++statistics.heap_operations;
+            }
+            else if (to_distance < query_heap.GetKey(to))
+            {
+                query_heap.GetData(to).parent = node;
+                query_heap.DecreaseKey(to, to_distance);
+                ++statistics.heap_operations;
+            }
+        }
+    }
+};
+
+#endif // ONE_TO_ALL_ROUTING_HPP
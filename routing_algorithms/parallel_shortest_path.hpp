@@ -0,0 +1,285 @@
+/*
+
+Copyright (c) 2015, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PARALLEL_SHORTEST_PATH_HPP
+#define PARALLEL_SHORTEST_PATH_HPP
+
+#include "routing_base.hpp"
+#include "../data_structures/query_statistics.hpp"
+#include "../data_structures/search_engine_data.hpp"
+#include "../Util/integer_range.hpp"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+// Via routes with many legs. Instead of carrying the distances of the previous leg into the
+// heaps of the next one, every leg is searched independently for each pair of source and
+// target direction, all of them in parallel. Which direction every waypoint is passed in is
+// decided afterwards by a dynamic program over the legs.
+template <class DataFacadeT>
+class ParallelShortestPathRouting final : public BasicRoutingInterface<DataFacadeT>
+{
+    using super = BasicRoutingInterface<DataFacadeT>;
+    using QueryHeap = SearchEngineData::QueryHeap;
+    SearchEngineData &engine_working_data;
+
+    // a phantom node is entered or left through its forward or its reverse node
+    enum Direction : unsigned
+    {
+        FORWARD = 0,
+        REVERSE = 1,
+        NUMBER_OF_DIRECTIONS = 2
+    };
+    static constexpr unsigned CANDIDATES_PER_LEG = NUMBER_OF_DIRECTIONS * NUMBER_OF_DIRECTIONS;
+
+    struct LegCandidate
+    {
+        LegCandidate() : distance(INVALID_EDGE_WEIGHT) {}
+        EdgeWeight distance;
+        std::vector<NodeID> packed_path;
+    };
+
+  public:
+    ParallelShortestPathRouting(DataFacadeT *facade,
+                                SearchEngineData &engine_working_data,
+                                ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), engine_working_data(engine_working_data)
+    {
+    }
+
+    ~ParallelShortestPathRouting() {}
+
+    void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
+                    const std::vector<bool> &uturn_indicators,
+                    RawRouteData &raw_route_data,
+                    const QueryDeadline &deadline = QueryDeadline()) const
+    {
+        const unsigned number_of_legs = static_cast<unsigned>(phantom_nodes_vector.size());
+        std::vector<LegCandidate> candidates(number_of_legs * CANDIDATES_PER_LEG);
+
+        // every search is expensive enough to be scheduled on its own
+        constexpr unsigned GrainSize = 1;
+        ParallelQueryStatistics search_statistics;
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(0, static_cast<unsigned>(candidates.size()), GrainSize),
+            [this, &phantom_nodes_vector, &candidates, &deadline, &search_statistics](
+                const tbb::blocked_range<unsigned> &range)
+            {
+                const ParallelQueryStatistics::Task task(search_statistics);
+                engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                    super::facade->GetNumberOfNodes());
+                QueryHeap &forward_heap = *(engine_working_data.forwardHeap);
+                QueryHeap &reverse_heap = *(engine_working_data.backwardHeap);
+
+                for (const auto index : osrm::irange(range.begin(), range.end()))
+                {
+                    const unsigned leg = index / CANDIDATES_PER_LEG;
+                    const auto source_direction =
+                        static_cast<Direction>((index / NUMBER_OF_DIRECTIONS) % NUMBER_OF_DIRECTIONS);
+                    const auto target_direction =
+                        static_cast<Direction>(index % NUMBER_OF_DIRECTIONS);
+                    SearchLeg(phantom_nodes_vector[leg],
+                              source_direction,
+                              target_direction,
+                              forward_heap,
+                              reverse_heap,
+                              deadline,
+                              candidates[index]);
+                }
+            });
+        search_statistics.Merge();
+
+        // arrival_distance[d] is the length of the shortest route to the current waypoint that
+        // reaches it in direction d. source_direction[leg][t] is the direction that leg was
+        // started in on that route when it arrives in direction t.
+        std::array<EdgeWeight, NUMBER_OF_DIRECTIONS> arrival_distance = {{0, 0}};
+        std::vector<std::array<Direction, NUMBER_OF_DIRECTIONS>> source_direction(number_of_legs);
+        // direction of the best arrival at the start of a leg that allows a u-turn
+        std::vector<Direction> uturn_direction(number_of_legs, FORWARD);
+
+        for (const auto leg : osrm::irange(0u, number_of_legs))
+        {
+            std::array<EdgeWeight, NUMBER_OF_DIRECTIONS> departure_distance = arrival_distance;
+            if (0 == leg || AllowsUTurn(leg, uturn_indicators))
+            {
+                uturn_direction[leg] =
+                    (arrival_distance[REVERSE] < arrival_distance[FORWARD]) ? REVERSE : FORWARD;
+                departure_distance.fill(arrival_distance[uturn_direction[leg]]);
+            }
+
+            arrival_distance.fill(INVALID_EDGE_WEIGHT);
+            for (const auto target : {FORWARD, REVERSE})
+            {
+                source_direction[leg][target] = FORWARD;
+                for (const auto source : {FORWARD, REVERSE})
+                {
+                    const EdgeWeight leg_distance =
+                        candidates[leg * CANDIDATES_PER_LEG + source * NUMBER_OF_DIRECTIONS + target]
+                            .distance;
+                    if (INVALID_EDGE_WEIGHT == departure_distance[source] ||
+                        INVALID_EDGE_WEIGHT == leg_distance)
+                    {
+                        continue;
+                    }
+                    const EdgeWeight distance = departure_distance[source] + leg_distance;
+                    if (distance < arrival_distance[target])
+                    {
+                        arrival_distance[target] = distance;
+                        source_direction[leg][target] = source;
+                    }
+                }
+            }
+        }
+
+        Direction direction =
+            (arrival_distance[REVERSE] < arrival_distance[FORWARD]) ? REVERSE : FORWARD;
+        if (INVALID_EDGE_WEIGHT == arrival_distance[direction])
+        {
+            raw_route_data.shortest_path_length = INVALID_EDGE_WEIGHT;
+            raw_route_data.alternative_path_length = INVALID_EDGE_WEIGHT;
+            return;
+        }
+        raw_route_data.shortest_path_length = arrival_distance[direction];
+
+        // walk back through the legs to find the candidate each of them uses
+        std::vector<const LegCandidate *> packed_legs(number_of_legs);
+        for (unsigned leg = number_of_legs; leg > 0; --leg)
+        {
+            const Direction source = source_direction[leg - 1][direction];
+            packed_legs[leg - 1] =
+                &candidates[(leg - 1) * CANDIDATES_PER_LEG + source * NUMBER_OF_DIRECTIONS + direction];
+            BOOST_ASSERT(!packed_legs[leg - 1]->packed_path.empty());
+            direction = AllowsUTurn(leg - 1, uturn_indicators) ? uturn_direction[leg - 1] : source;
+        }
+
+        // the legs are unpacked independently as well
+        raw_route_data.unpacked_path_segments.resize(number_of_legs);
+        ParallelQueryStatistics unpack_statistics;
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned>(0, number_of_legs, GrainSize),
+            [this, &phantom_nodes_vector, &packed_legs, &raw_route_data, &unpack_statistics](
+                const tbb::blocked_range<unsigned> &range)
+            {
+                const ParallelQueryStatistics::Task task(unpack_statistics);
+                for (const auto leg : osrm::irange(range.begin(), range.end()))
+                {
+                    super::UnpackPath(packed_legs[leg]->packed_path,
+                                      phantom_nodes_vector[leg],
+                                      raw_route_data.unpacked_path_segments[leg]);
+                }
+            });
+        unpack_statistics.Merge();
+
+        for (const auto leg : osrm::irange(0u, number_of_legs))
+        {
+            const std::vector<NodeID> &packed_path = packed_legs[leg]->packed_path;
+            raw_route_data.source_traversed_in_reverse.push_back(
+                (packed_path.front() != phantom_nodes_vector[leg].source_phantom.forward_node_id));
+            raw_route_data.target_traversed_in_reverse.push_back(
+                (packed_path.back() != phantom_nodes_vector[leg].target_phantom.forward_node_id));
+        }
+    }
+
+  private:
+    // same interpretation of the u-turn flags as in ShortestPathRouting
+    static bool AllowsUTurn(const unsigned leg, const std::vector<bool> &uturn_indicators)
+    {
+        return leg > 0 && uturn_indicators.size() > leg && uturn_indicators[leg - 1];
+    }
+
+    // Bidirectional search from one direction of the source to one direction of the target.
+    // The distance includes the offsets of both phantom nodes, so that the offsets of a
+    // waypoint cancel out when the distances of consecutive legs are added.
+    void SearchLeg(const PhantomNodes &phantom_node_pair,
+                   const Direction source_direction,
+                   const Direction target_direction,
+                   QueryHeap &forward_heap,
+                   QueryHeap &reverse_heap,
+                   const QueryDeadline &deadline,
+                   LegCandidate &candidate) const
+    {
+        const PhantomNode &source_phantom = phantom_node_pair.source_phantom;
+        const PhantomNode &target_phantom = phantom_node_pair.target_phantom;
+        const NodeID source_node =
+            (FORWARD == source_direction) ? source_phantom.forward_node_id
+                                          : source_phantom.reverse_node_id;
+        const NodeID target_node =
+            (FORWARD == target_direction) ? target_phantom.forward_node_id
+                                          : target_phantom.reverse_node_id;
+        if (SPECIAL_NODEID == source_node || SPECIAL_NODEID == target_node)
+        {
+            return;
+        }
+
+        const int source_weight = (FORWARD == source_direction)
+                                      ? -source_phantom.GetForwardWeightPlusOffset()
+                                      : -source_phantom.GetReverseWeightPlusOffset();
+        const int target_weight = (FORWARD == target_direction)
+                                      ? target_phantom.GetForwardWeightPlusOffset()
+                                      : target_phantom.GetReverseWeightPlusOffset();
+
+        forward_heap.Clear();
+        reverse_heap.Clear();
+        forward_heap.Insert(source_node, source_weight, source_node);
+        reverse_heap.Insert(target_node, target_weight, target_node);
+
+        const int min_edge_offset = std::min(0, source_weight);
+        NodeID middle = SPECIAL_NODEID;
+        int upper_bound = INVALID_EDGE_WEIGHT;
+        unsigned settled_nodes = 0;
+        while (0 < (forward_heap.Size() + reverse_heap.Size()))
+        {
+            super::PollDeadline(deadline, settled_nodes);
+            if (!forward_heap.Empty())
+            {
+                super::RoutingStep(
+                    forward_heap, reverse_heap, &middle, &upper_bound, min_edge_offset, true);
+            }
+            if (!reverse_heap.Empty())
+            {
+                super::RoutingStep(
+                    reverse_heap, forward_heap, &middle, &upper_bound, min_edge_offset, false);
+            }
+        }
+
+        if (INVALID_EDGE_WEIGHT == upper_bound || SPECIAL_NODEID == middle)
+        {
+            return;
+        }
+        candidate.distance = upper_bound;
+        super::RetrievePackedPathFromHeap(forward_heap, reverse_heap, middle, candidate.packed_path);
+    }
+};
+
+#endif // PARALLEL_SHORTEST_PATH_HPP
@@ -28,13 +28,20 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ROUTING_BASE_HPP
 #define ROUTING_BASE_HPP
 
+#include "../data_structures/query_statistics.hpp"
 #include "../data_structures/raw_route_data.hpp"
 #include "../data_structures/search_engine_data.hpp"
+#include "../data_structures/shortcut_cache.hpp"
 #include "../data_structures/turn_instructions.hpp"
+#include "../Util/integer_range.hpp"
+#include "../Util/osrm_exception.hpp"
 // #include "../Util/simple_logger.hpp.h"
 
+#include <osrm/QueryDeadline.h>
+
 #include <boost/assert.hpp>
 
+#include <memory>
 #include <stack>
 
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forwardHeap;
@@ -43,30 +50,199 @@ SearchEngineData::SearchEngineHeapPtr SearchEngineData::forwardHeap2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::backwardHeap2;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forwardHeap3;
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::backwardHeap3;
+SearchEngineData::SharingStoragePtr SearchEngineData::forwardSharing;
+SearchEngineData::SharingStoragePtr SearchEngineData::backwardSharing;
 
 template <class DataFacadeT> class BasicRoutingInterface
 {
   private:
     typedef typename DataFacadeT::EdgeData EdgeData;
 
+    /*
+        Finds the cheapest edge that leads from 'from' to 'to', either stored at 'from' and
+        traversable forward or stored at 'to' and traversable backward:
+
+        from                 to
+          *------------------>*
+                 edge_id
+
+        facade->FindEdge does not suffice here since it ignores the direction flags.
+    */
+    inline EdgeID FindSmallestEdge(const NodeID from, const NodeID to) const
+    {
+        EdgeID smaller_edge_id = SPECIAL_EDGEID;
+        int edge_weight = std::numeric_limits<EdgeWeight>::max();
+        for (const auto edge_id : facade->GetAdjacentEdgeRange(from))
+        {
+            const EdgeData &data = facade->GetEdgeData(edge_id);
+            if ((facade->GetTarget(edge_id) == to) && (data.distance < edge_weight) &&
+                data.forward)
+            {
+                smaller_edge_id = edge_id;
+                edge_weight = data.distance;
+            }
+        }
+
+        if (SPECIAL_EDGEID == smaller_edge_id)
+        {
+            for (const auto edge_id : facade->GetAdjacentEdgeRange(to))
+            {
+                const EdgeData &data = facade->GetEdgeData(edge_id);
+                if ((facade->GetTarget(edge_id) == from) && (data.distance < edge_weight) &&
+                    data.backward)
+                {
+                    smaller_edge_id = edge_id;
+                    edge_weight = data.distance;
+                }
+            }
+        }
+        return smaller_edge_id;
+    }
+
+    /*
+        Pushes the two halves of a shortcut from 'from' to 'to' onto the stack, first half on
+        top. The middle node was contracted before both end points, so both halves are stored
+        at the middle node and a single scan of its (usually short) adjacency resolves them:
+
+        from      middle      to
+          *<--------*-------->*
+           backward   forward
+
+        Halves that are not found there are looked up with FindSmallestEdge when popped.
+    */
+    inline void PushShortcutHalves(const PackedEdge &shortcut,
+                                   const NodeID middle_node_id,
+                                   std::stack<PackedEdge> &recursion_stack) const
+    {
+        EdgeID first_half = SPECIAL_EDGEID;
+        EdgeID second_half = SPECIAL_EDGEID;
+        int first_weight = std::numeric_limits<EdgeWeight>::max();
+        int second_weight = std::numeric_limits<EdgeWeight>::max();
+        for (const auto edge_id : facade->GetAdjacentEdgeRange(middle_node_id))
+        {
+            const NodeID target = facade->GetTarget(edge_id);
+            const EdgeData &data = facade->GetEdgeData(edge_id);
+            if (target == shortcut.from && data.backward && data.distance < first_weight)
+            {
+                first_half = edge_id;
+                first_weight = data.distance;
+            }
+            if (target == shortcut.to && data.forward && data.distance < second_weight)
+            {
+                second_half = edge_id;
+                second_weight = data.distance;
+            }
+        }
+
+        // again, we need to this in reversed order
+        recursion_stack.push({middle_node_id, shortcut.to, second_half});
+        recursion_stack.push({shortcut.from, middle_node_id, first_half});
+    }
+
+    // shortcuts with fewer original edges are cheaper to unpack than to look up
+    static constexpr unsigned MIN_CACHED_SHORTCUT_LENGTH = 8;
+
+    /*
+        Appends the original edges of a packed edge to 'original_edges' in driving order.
+        Shortcuts are taken from the cache if possible, long ones are cached after unpacking.
+        Only the packed edge itself is looked up: the shortcuts it contains would cost a lock
+        each, and the long shortcuts close to the top of a path are the ones that recur.
+    */
+    inline void UnpackToOriginalEdges(PackedEdge edge, std::vector<PackedEdge> &original_edges) const
+    {
+        if (SPECIAL_EDGEID == edge.edge_id)
+        {
+            edge.edge_id = FindSmallestEdge(edge.from, edge.to);
+        }
+        BOOST_ASSERT_MSG(SPECIAL_EDGEID != edge.edge_id, "edge id invalid");
+
+        if (!facade->GetEdgeData(edge.edge_id).shortcut)
+        {
+            original_edges.emplace_back(edge);
+            return;
+        }
+
+        const bool reversed = (facade->GetTarget(edge.edge_id) != edge.to);
+        ShortcutCache::UnpackedShortcutPtr cached_edges;
+        if (shortcut_cache.Fetch(edge.edge_id, reversed, cached_edges) &&
+            cached_edges->front().from == edge.from && cached_edges->back().to == edge.to)
+        {
+            original_edges.insert(original_edges.end(), cached_edges->begin(), cached_edges->end());
+            return;
+        }
+
+        const std::size_t first_original_edge = original_edges.size();
+        std::stack<PackedEdge> recursion_stack;
+        recursion_stack.push(edge);
+        while (!recursion_stack.empty())
+        {
+            PackedEdge current = recursion_stack.top();
+            recursion_stack.pop();
+
+            if (SPECIAL_EDGEID == current.edge_id)
+            {
+                current.edge_id = FindSmallestEdge(current.from, current.to);
+            }
+            BOOST_ASSERT_MSG(SPECIAL_EDGEID != current.edge_id, "edge id invalid");
+
+            const EdgeData &ed = facade->GetEdgeData(current.edge_id);
+            if (ed.shortcut)
+            { // unpack
+                PushShortcutHalves(current, ed.id, recursion_stack);
+            }
+            else
+            {
+                original_edges.emplace_back(current);
+            }
+        }
+
+        if (original_edges.size() - first_original_edge >= MIN_CACHED_SHORTCUT_LENGTH)
+        {
+            shortcut_cache.Insert(
+                edge.edge_id, reversed, std::make_shared<const std::vector<PackedEdge>>(
+                         original_edges.begin() + first_original_edge, original_edges.end()));
+        }
+    }
+
+    ShortcutCache &shortcut_cache;
+
   protected:
     DataFacadeT *facade;
 
   public:
     BasicRoutingInterface() = delete;
     BasicRoutingInterface(const BasicRoutingInterface &) = delete;
-    explicit BasicRoutingInterface(DataFacadeT *facade) : facade(facade) {}
+    BasicRoutingInterface(DataFacadeT *facade, ShortcutCache &shortcut_cache)
+        : shortcut_cache(shortcut_cache), facade(facade)
+    {
+    }
     virtual ~BasicRoutingInterface() {};
 
+    // Reading the clock for every settled node would be too expensive, searches poll the
+    // deadline of their query once every DEADLINE_POLL_INTERVAL settled nodes.
+    static constexpr unsigned DEADLINE_POLL_INTERVAL = 1024;
+
+    // throws osrm::query_timeout once the query ran out of time or was cancelled
+    static inline void PollDeadline(const QueryDeadline &deadline, unsigned &settled_nodes)
+    {
+        if (0 == (++settled_nodes % DEADLINE_POLL_INTERVAL) && deadline.IsExpired())
+        {
+            throw osrm::query_timeout();
+        }
+    }
+
     inline void RoutingStep(SearchEngineData::QueryHeap &forward_heap,
-                            SearchEngineData::QueryHeap &reverse_heap,
+                            const SearchEngineData::QueryHeap &reverse_heap,
                             NodeID *middle_node_id,
                             int *upper_bound,
                             const int min_edge_offset,
                             const bool forward_direction) const
     {
+        QueryStatistics &statistics = QueryStatistics::ThreadLocal();
         const NodeID node = forward_heap.DeleteMin();
         const int distance = forward_heap.GetKey(node);
+        ++statistics.settled_nodes;
+        ++statistics.heap_operations;
 
         // const NodeID parentnode = forward_heap.GetData(node).parent;
         // SimpleLogger().Write() << (forward_direction ? "[fwd] " : "[rev] ") << "settled edge (" << parentnode << "," << node << "), dist: " << distance;
@@ -110,6 +286,7 @@ template <class DataFacadeT> class BasicRoutingInterface
                 {
                     if (forward_heap.GetKey(to) + edge_weight < distance)
                     {
+                        ++statistics.stalled_nodes;
                         return;
                     }
                 }
@@ -128,11 +305,13 @@ template <class DataFacadeT> class BasicRoutingInterface
 
                 BOOST_ASSERT_MSG(edge_weight > 0, "edge_weight invalid");
                 const int to_distance = distance + edge_weight;
+                ++statistics.relaxed_edges;
 
                 // New Node discovered -> Add to Heap + Node Info Storage
                 if (!forward_heap.WasInserted(to))
                 {
                     forward_heap.Insert(to, to_distance, node);
+                    ++statistics.heap_operations;
                 }
                 // Found a shorter Path -> Update distance
                 else if (to_distance < forward_heap.GetKey(to))
@@ -140,6 +319,7 @@ template <class DataFacadeT> class BasicRoutingInterface
                     // new parent
                     forward_heap.GetData(to).parent = node;
                     forward_heap.DecreaseKey(to, to_distance);
+                    ++statistics.heap_operations;
                 }
             }
         }
@@ -154,114 +334,57 @@ template <class DataFacadeT> class BasicRoutingInterface
         const bool target_traversed_in_reverse =
             (packed_path.back() != phantom_node_pair.target_phantom.forward_node_id);
 
-        const unsigned packed_path_size = static_cast<unsigned>(packed_path.size());
-        std::stack<std::pair<NodeID, NodeID>> recursion_stack;
-
-        // We have to push the path in reverse order onto the stack because it's LIFO.
-        for (unsigned i = packed_path_size - 1; i > 0; --i)
+        PhaseTimer unpack_timer(&QueryStatistics::unpack_time);
+        shortcut_cache.Validate(facade->GetCheckSum());
+        std::vector<PackedEdge> original_edges;
+        for (const auto i : osrm::irange<std::size_t>(1, packed_path.size()))
         {
-            recursion_stack.emplace(packed_path[i - 1], packed_path[i]);
+            UnpackToOriginalEdges({packed_path[i - 1], packed_path[i], SPECIAL_EDGEID},
+                                  original_edges);
         }
+        QueryStatistics::ThreadLocal().unpacked_edges += original_edges.size();
 
-        std::pair<NodeID, NodeID> edge;
-        while (!recursion_stack.empty())
+        for (const PackedEdge &original_edge : original_edges)
         {
-            /*
-            Graphical representation of variables:
-
-            edge.first         edge.second
-                *------------------>*
-                       edge_id
-            */
-            edge = recursion_stack.top();
-            recursion_stack.pop();
-
-            // facade->FindEdge does not suffice here in case of shortcuts.
-            // The above explanation unclear? Think!
-            EdgeID smaller_edge_id = SPECIAL_EDGEID;
-            int edge_weight = std::numeric_limits<EdgeWeight>::max();
-            for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.first))
-            {
-                const int weight = facade->GetEdgeData(edge_id).distance;
-                if ((facade->GetTarget(edge_id) == edge.second) && (weight < edge_weight) &&
-                    facade->GetEdgeData(edge_id).forward)
-                {
-                    smaller_edge_id = edge_id;
-                    edge_weight = weight;
-                }
-            }
+            const EdgeData &ed = facade->GetEdgeData(original_edge.edge_id);
+            BOOST_ASSERT_MSG(!ed.shortcut, "original edge flagged as shortcut");
+            unsigned name_index = facade->GetNameIndexFromEdgeID(ed.id);
+            const TurnInstruction turn_instruction = facade->GetTurnInstructionForEdgeID(ed.id);
+            const TravelMode travel_mode = facade->GetTravelModeForEdgeID(ed.id);
 
-            /*
-                Graphical representation of variables:
 
-                edge.first         edge.second
-                    *<------------------*
-                           edge_id
-            */
-            if (SPECIAL_EDGEID == smaller_edge_id)
+            if (!facade->EdgeIsCompressed(ed.id))
             {
-                for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.second))
-                {
-                    const int weight = facade->GetEdgeData(edge_id).distance;
-                    if ((facade->GetTarget(edge_id) == edge.first) && (weight < edge_weight) &&
-                        facade->GetEdgeData(edge_id).backward)
-                    {
-                        smaller_edge_id = edge_id;
-                        edge_weight = weight;
-                    }
-                }
-            }
-            BOOST_ASSERT_MSG(edge_weight != INVALID_EDGE_WEIGHT, "edge id invalid");
-
-            const EdgeData &ed = facade->GetEdgeData(smaller_edge_id);
-            if (ed.shortcut)
-            { // unpack
-                const NodeID middle_node_id = ed.id;
-                // again, we need to this in reversed order
-                recursion_stack.emplace(middle_node_id, edge.second);
-                recursion_stack.emplace(edge.first, middle_node_id);
+                BOOST_ASSERT(!facade->EdgeIsCompressed(ed.id));
+                unpacked_path.emplace_back(facade->GetGeometryIndexForEdgeID(ed.id),
+                                           name_index,
+                                           turn_instruction,
+                                           ed.distance,
+                                           travel_mode);
             }
             else
             {
-                BOOST_ASSERT_MSG(!ed.shortcut, "original edge flagged as shortcut");
-                unsigned name_index = facade->GetNameIndexFromEdgeID(ed.id);
-                const TurnInstruction turn_instruction = facade->GetTurnInstructionForEdgeID(ed.id);
-                const TravelMode travel_mode = facade->GetTravelModeForEdgeID(ed.id);
-
-
-                if (!facade->EdgeIsCompressed(ed.id))
-                {
-                    BOOST_ASSERT(!facade->EdgeIsCompressed(ed.id));
-                    unpacked_path.emplace_back(facade->GetGeometryIndexForEdgeID(ed.id),
-                                               name_index,
-                                               turn_instruction,
-                                               ed.distance,
-                                               travel_mode);
-                }
-                else
+                std::vector<unsigned> id_vector;
+                facade->GetUncompressedGeometry(facade->GetGeometryIndexForEdgeID(ed.id),
+                                                id_vector);
+
+                const std::size_t start_index =
+                    (unpacked_path.empty()
+                         ? ((start_traversed_in_reverse)
+                                ? id_vector.size() -
+                                      phantom_node_pair.source_phantom.fwd_segment_position - 1
+                                : phantom_node_pair.source_phantom.fwd_segment_position)
+                         : 0);
+                const std::size_t end_index = id_vector.size();
+
+                BOOST_ASSERT(start_index >= 0);
+                BOOST_ASSERT(start_index <= end_index);
+                for (std::size_t i = start_index; i < end_index; ++i)
                 {
-                    std::vector<unsigned> id_vector;
-                    facade->GetUncompressedGeometry(facade->GetGeometryIndexForEdgeID(ed.id),
-                                                    id_vector);
-
-                    const std::size_t start_index =
-                        (unpacked_path.empty()
-                             ? ((start_traversed_in_reverse)
-                                    ? id_vector.size() -
-                                          phantom_node_pair.source_phantom.fwd_segment_position - 1
-                                    : phantom_node_pair.source_phantom.fwd_segment_position)
-                             : 0);
-                    const std::size_t end_index = id_vector.size();
-
-                    BOOST_ASSERT(start_index >= 0);
-                    BOOST_ASSERT(start_index <= end_index);
-                    for (std::size_t i = start_index; i < end_index; ++i)
-                    {
-                        unpacked_path.emplace_back(id_vector[i], name_index, TurnInstruction::NoTurn, 0, travel_mode);
-                    }
-                    unpacked_path.back().turn_instruction = turn_instruction;
-                    unpacked_path.back().segment_duration = ed.distance;
+                    unpacked_path.emplace_back(id_vector[i], name_index, TurnInstruction::NoTurn, 0, travel_mode);
                 }
+                unpacked_path.back().turn_instruction = turn_instruction;
+                unpacked_path.back().segment_duration = ed.distance;
             }
         }
         if (SPECIAL_EDGEID != phantom_node_pair.target_phantom.packed_geometry_id)
@@ -332,56 +455,14 @@ template <class DataFacadeT> class BasicRoutingInterface
 
     inline void UnpackEdge(const NodeID s, const NodeID t, std::vector<NodeID> &unpacked_path) const
     {
-        std::stack<std::pair<NodeID, NodeID>> recursion_stack;
-        recursion_stack.emplace(s, t);
+        shortcut_cache.Validate(facade->GetCheckSum());
+        std::vector<PackedEdge> original_edges;
+        UnpackToOriginalEdges({s, t, SPECIAL_EDGEID}, original_edges);
+        QueryStatistics::ThreadLocal().unpacked_edges += original_edges.size();
 
-        std::pair<NodeID, NodeID> edge;
-        while (!recursion_stack.empty())
+        for (const PackedEdge &original_edge : original_edges)
         {
-            edge = recursion_stack.top();
-            recursion_stack.pop();
-
-            EdgeID smaller_edge_id = SPECIAL_EDGEID;
-            int edge_weight = std::numeric_limits<EdgeWeight>::max();
-            for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.first))
-            {
-                const int weight = facade->GetEdgeData(edge_id).distance;
-                if ((facade->GetTarget(edge_id) == edge.second) && (weight < edge_weight) &&
-                    facade->GetEdgeData(edge_id).forward)
-                {
-                    smaller_edge_id = edge_id;
-                    edge_weight = weight;
-                }
-            }
-
-            if (SPECIAL_EDGEID == smaller_edge_id)
-            {
-                for (const auto edge_id : facade->GetAdjacentEdgeRange(edge.second))
-                {
-                    const int weight = facade->GetEdgeData(edge_id).distance;
-                    if ((facade->GetTarget(edge_id) == edge.first) && (weight < edge_weight) &&
-                        facade->GetEdgeData(edge_id).backward)
-                    {
-                        smaller_edge_id = edge_id;
-                        edge_weight = weight;
-                    }
-                }
-            }
-            BOOST_ASSERT_MSG(edge_weight != std::numeric_limits<EdgeWeight>::max(), "edge weight invalid");
-
-            const EdgeData &ed = facade->GetEdgeData(smaller_edge_id);
-            if (ed.shortcut)
-            { // unpack
-                const NodeID middle_node_id = ed.id;
-                // again, we need to this in reversed order
-                recursion_stack.emplace(middle_node_id, edge.second);
-                recursion_stack.emplace(edge.first, middle_node_id);
-            }
-            else
-            {
-                BOOST_ASSERT_MSG(!ed.shortcut, "edge must be shortcut");
-                unpacked_path.emplace_back(edge.first);
-            }
+            unpacked_path.emplace_back(original_edge.from);
         }
         unpacked_path.emplace_back(t);
     }
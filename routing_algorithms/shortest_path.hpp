@@ -42,8 +42,10 @@ template <class DataFacadeT> class ShortestPathRouting final : public BasicRouti
     SearchEngineData &engine_working_data;
 
   public:
-    ShortestPathRouting(DataFacadeT *facade, SearchEngineData &engine_working_data)
-        : super(facade), engine_working_data(engine_working_data)
+    ShortestPathRouting(DataFacadeT *facade,
+                        SearchEngineData &engine_working_data,
+                        ShortcutCache &shortcut_cache)
+        : super(facade, shortcut_cache), engine_working_data(engine_working_data)
     {
     }
 
@@ -51,7 +53,8 @@ template <class DataFacadeT> class ShortestPathRouting final : public BasicRouti
 
     void operator()(const std::vector<PhantomNodes> &phantom_nodes_vector,
                     const std::vector<bool> &uturn_indicators,
-                    RawRouteData &raw_route_data) const
+                    RawRouteData &raw_route_data,
+                    const QueryDeadline &deadline = QueryDeadline()) const
     {
         int distance1 = 0;
         int distance2 = 0;
@@ -75,6 +78,7 @@ template <class DataFacadeT> class ShortestPathRouting final : public BasicRouti
         QueryHeap &reverse_heap2 = *(engine_working_data.backwardHeap2);
 
         std::size_t current_leg = 0;
+        unsigned settled_nodes = 0;
         // Get distance to next pair of target nodes.
         for (const PhantomNodes &phantom_node_pair : phantom_nodes_vector)
         {
@@ -150,6 +154,7 @@ template <class DataFacadeT> class ShortestPathRouting final : public BasicRouti
             // run two-Target Dijkstra routing step.
             while (0 < (forward_heap1.Size() + reverse_heap1.Size()))
             {
+                super::PollDeadline(deadline, settled_nodes);
                 if (!forward_heap1.Empty())
                 {
                     super::RoutingStep(
@@ -166,6 +171,7 @@ template <class DataFacadeT> class ShortestPathRouting final : public BasicRouti
             {
                 while (0 < (forward_heap2.Size() + reverse_heap2.Size()))
                 {
+                    super::PollDeadline(deadline, settled_nodes);
                     if (!forward_heap2.Empty())
                     {
                         super::RoutingStep(
@@ -66,15 +66,22 @@ int main(int argc, const char *argv[])
     {
         std::string ip_address;
         int ip_port, requested_thread_num;
-        bool use_shared_memory = false, trial_run = false;
+        unsigned keep_alive_timeout, max_keep_alive_requests, access_log_sampling_interval;
+        bool use_shared_memory = false, trial_run = false, use_io_sharding = false;
         ServerPaths server_paths;
+        QueryBudgets query_budgets;
 
         const unsigned init_result = GenerateServerProgramOptions(argc,
                                                                   argv,
                                                                   server_paths,
+                                                                  query_budgets,
                                                                   ip_address,
                                                                   ip_port,
                                                                   requested_thread_num,
+                                                                  keep_alive_timeout,
+                                                                  max_keep_alive_requests,
+                                                                  use_io_sharding,
+                                                                  access_log_sampling_interval,
                                                                   use_shared_memory,
                                                                   trial_run);
 
@@ -85,7 +92,7 @@ int main(int argc, const char *argv[])
 
         SimpleLogger().Write() << "starting up engines, " << g_GIT_DESCRIPTION;
 
-        OSRM routing_machine(server_paths, use_shared_memory);
+        OSRM routing_machine(server_paths, use_shared_memory, query_budgets);
 
         RouteParameters route_parameters;
         route_parameters.zoom_level = 18;           // no generalization